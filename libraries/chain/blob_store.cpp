@@ -0,0 +1,234 @@
+#include <freezone/chain/blob_store.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#define BLOB_STORE_MAGIC            0x424f4c42534d4446ull /* "FDMSBLOB" */
+#define BLOB_STORE_INITIAL_SIZE     (16 * 1024 * 1024)
+
+namespace freezone { namespace chain {
+
+   namespace bip = boost::interprocess;
+
+   namespace detail {
+
+      struct blob_store_header
+      {
+         uint64_t magic;
+         uint64_t end;
+      };
+
+      class blob_store_impl
+      {
+         public:
+            fc::path                   file;
+            bip::file_mapping          mapping;
+            bip::mapped_region         region;
+
+            /// Held exclusively while the file is grown and remapped
+            mutable boost::shared_mutex remap_mutex;
+
+            uint64_t                   cache_capacity = 0;
+            mutable uint64_t           cache_used = 0;
+            typedef std::list< std::pair< uint64_t, std::string > > lru_list;
+            mutable lru_list           lru;
+            mutable std::unordered_map< uint64_t, lru_list::iterator > cache;
+            mutable std::mutex         cache_mutex;
+
+            bool is_open()const { return region.get_address() != nullptr; }
+
+            blob_store_header& header()const
+            {
+               return *reinterpret_cast< blob_store_header* >( region.get_address() );
+            }
+
+            char* data()const
+            {
+               return reinterpret_cast< char* >( region.get_address() );
+            }
+
+            void map()
+            {
+               mapping = bip::file_mapping( file.generic_string().c_str(), bip::read_write );
+               region = bip::mapped_region( mapping, bip::read_write );
+            }
+
+            void unmap()
+            {
+               region = bip::mapped_region();
+               mapping = bip::file_mapping();
+            }
+
+            void grow( uint64_t required )
+            {
+               uint64_t new_size = region.get_size();
+               while( new_size < required )
+                  new_size *= 2;
+
+               boost::unique_lock< boost::shared_mutex > guard( remap_mutex );
+               region.flush();
+               unmap();
+               fc::resize_file( file, new_size );
+               map();
+            }
+
+            void cache_insert( uint64_t offset, const std::string& value )const
+            {
+               if( value.size() > cache_capacity )
+                  return;
+
+               std::lock_guard< std::mutex > guard( cache_mutex );
+               if( cache.find( offset ) != cache.end() )
+                  return;
+
+               lru.emplace_front( offset, value );
+               cache[ offset ] = lru.begin();
+               cache_used += value.size();
+
+               while( cache_used > cache_capacity )
+               {
+                  cache_used -= lru.back().second.size();
+                  cache.erase( lru.back().first );
+                  lru.pop_back();
+               }
+            }
+
+            bool cache_find( uint64_t offset, std::string& value )const
+            {
+               std::lock_guard< std::mutex > guard( cache_mutex );
+               auto itr = cache.find( offset );
+               if( itr == cache.end() )
+                  return false;
+
+               lru.splice( lru.begin(), lru, itr->second );
+               value = itr->second->second;
+               return true;
+            }
+
+            void cache_clear()
+            {
+               std::lock_guard< std::mutex > guard( cache_mutex );
+               lru.clear();
+               cache.clear();
+               cache_used = 0;
+            }
+      };
+
+   }
+
+   blob_store::blob_store() : my( new detail::blob_store_impl() ) {}
+
+   blob_store::~blob_store()
+   {
+      close();
+   }
+
+   void blob_store::open( const fc::path& file )
+   {
+      if( my->is_open() )
+         close();
+
+      my->file = file;
+
+      if( !fc::exists( file ) || fc::file_size( file ) == 0 )
+      {
+         std::ofstream( file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+         fc::resize_file( file, BLOB_STORE_INITIAL_SIZE );
+         my->map();
+         my->header().magic = BLOB_STORE_MAGIC;
+         my->header().end = sizeof( detail::blob_store_header );
+         my->region.flush();
+      }
+      else
+      {
+         FC_ASSERT( fc::file_size( file ) >= sizeof( detail::blob_store_header ), "Blob store ${f} is truncated", ("f", file) );
+         my->map();
+      }
+
+      FC_ASSERT( my->header().magic == BLOB_STORE_MAGIC, "${f} is not a blob store", ("f", file) );
+      FC_ASSERT( my->header().end <= my->region.get_size(), "Blob store ${f} is corrupt", ("f", file) );
+   }
+
+   void blob_store::close()
+   {
+      if( !my->is_open() )
+         return;
+
+      my->region.flush();
+      my->unmap();
+      my->cache_clear();
+   }
+
+   bool blob_store::is_open()const
+   {
+      return my->is_open();
+   }
+
+   void blob_store::flush()
+   {
+      if( my->is_open() )
+         my->region.flush();
+   }
+
+   void blob_store::set_cache_size( uint64_t bytes )
+   {
+      my->cache_clear();
+      my->cache_capacity = bytes;
+   }
+
+   uint64_t blob_store::append( const std::string& data )
+   {
+      FC_ASSERT( my->is_open(), "Blob store is not open" );
+
+      uint64_t offset = my->header().end;
+      if( offset + data.size() > my->region.get_size() )
+         my->grow( offset + data.size() );
+
+      std::memcpy( my->data() + offset, data.data(), data.size() );
+      my->header().end = offset + data.size();
+
+      return offset;
+   }
+
+   std::string blob_store::read( uint64_t offset, uint32_t size )const
+   {
+      std::string result;
+      if( my->cache_capacity && my->cache_find( offset, result ) )
+         return result;
+
+      {
+         boost::shared_lock< boost::shared_mutex > guard( my->remap_mutex );
+         FC_ASSERT( my->is_open(), "Blob store is not open" );
+         FC_ASSERT( offset >= sizeof( detail::blob_store_header ) && offset + size <= my->header().end,
+            "Blob is outside of the store", ("offset", offset)("size", size)("end", my->header().end) );
+
+         result.assign( my->data() + offset, size );
+      }
+
+      if( my->cache_capacity )
+         my->cache_insert( offset, result );
+
+      return result;
+   }
+
+   uint64_t blob_store::size()const
+   {
+      return my->is_open() ? my->header().end : 0;
+   }
+
+   bool blob_store::empty()const
+   {
+      return !my->is_open() || my->header().end == sizeof( detail::blob_store_header );
+   }
+
+} } // freezone::chain
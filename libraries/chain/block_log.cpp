@@ -195,6 +195,11 @@ namespace freezone { namespace chain {
    }
 
    uint64_t block_log::append( const signed_block& b )
+   {
+      return append( b, fc::raw::pack_to_vector( b ) );
+   }
+
+   uint64_t block_log::append( const signed_block& b, const std::vector< char >& data )
    {
       try
       {
@@ -212,7 +217,6 @@ namespace freezone { namespace chain {
          FC_ASSERT( static_cast<uint64_t>(my->index_stream.tellp()) == sizeof( uint64_t ) * ( b.block_num() - 1 ),
             "Append to index file occuring at wrong position.",
             ( "position", (uint64_t) my->index_stream.tellp() )( "expected",( b.block_num() - 1 ) * sizeof( uint64_t ) ) );
-         auto data = fc::raw::pack_to_vector( b );
          my->block_stream.write( data.data(), data.size() );
          my->block_stream.write( (char*)&pos, sizeof( pos ) );
          my->index_stream.write( (char*)&pos, sizeof( pos ) );
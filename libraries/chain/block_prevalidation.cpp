@@ -0,0 +1,116 @@
+#include <freezone/chain/block_prevalidation.hpp>
+
+#include <fc/io/raw.hpp>
+
+namespace freezone { namespace chain {
+
+prevalidated_block prevalidate_block( const signed_block& block, const chain_id_type& chain_id, bool recover_transaction_signatures,
+   const fc::ecc::public_key::task_poster& post, uint32_t signature_helpers )
+{
+   prevalidated_block result;
+   result.block_id = block.id();
+
+   // Pack the block exactly as fc::raw::pack would, noting where each transaction and its signatures begin
+   auto packed = std::make_shared< std::vector< char > >( fc::raw::pack_size( block ) );
+   vector< uint32_t > unsigned_sizes;
+   unsigned_sizes.reserve( block.transactions.size() );
+   result.packed_transactions.reserve( block.transactions.size() );
+
+   fc::datastream< char* > ds( packed->data(), packed->size() );
+   fc::raw::pack( ds, static_cast< const freezone::protocol::signed_block_header& >( block ) );
+   fc::raw::pack( ds, fc::unsigned_int( block.transactions.size() ) );
+
+   for( const auto& trx : block.transactions )
+   {
+      uint32_t begin = ds.tellp();
+      fc::raw::pack( ds, static_cast< const freezone::protocol::transaction& >( trx ) );
+      unsigned_sizes.push_back( ds.tellp() - begin );
+      fc::raw::pack( ds, trx.signatures );
+      result.packed_transactions.emplace_back( begin, ds.tellp() - begin );
+   }
+
+   result.block_size = packed->size();
+
+   // The merkle digests of the signed transactions and the digests of the unsigned ones are all hashed together
+   size_t trx_count = block.transactions.size();
+   vector< const char* > digest_data( 2 * trx_count );
+   vector< uint32_t > digest_sizes( 2 * trx_count );
+   for( size_t i = 0; i < trx_count; ++i )
+   {
+      const char* trx_data = packed->data() + result.packed_transactions[i].first;
+      digest_data[i] = trx_data;
+      digest_sizes[i] = result.packed_transactions[i].second;
+      digest_data[ trx_count + i ] = trx_data;
+      digest_sizes[ trx_count + i ] = unsigned_sizes[i];
+   }
+
+   vector< digest_type > digests( 2 * trx_count );
+   digest_type::hash_many( digest_data.data(), digest_sizes.data(), digests.size(), digests.data() );
+
+   result.transaction_ids.reserve( trx_count );
+   for( size_t i = 0; i < trx_count; ++i )
+   {
+      const auto& trx_digest = digests[ trx_count + i ];
+      transaction_id_type trx_id;
+      memcpy( trx_id._hash, trx_digest._hash, std::min( sizeof( trx_id ), sizeof( trx_digest ) ) );
+      result.transaction_ids.push_back( trx_id );
+   }
+
+   digests.resize( trx_count );
+
+   result.merkle_root = signed_block::calculate_merkle_root( std::move( digests ) );
+
+   try
+   {
+      result.signee = block.signee( fc::ecc::non_canonical );
+   }
+   catch( const fc::exception& ) {}
+
+   if( recover_transaction_signatures )
+   {
+      // Signature digests are hashed from the serialized transactions, then all signatures are recovered together
+      vector< fc::ecc::compact_signature > signatures;
+      vector< digest_type > sig_digests;
+      for( size_t i = 0; i < trx_count; ++i )
+      {
+         digest_type::encoder enc;
+         fc::raw::pack( enc, chain_id );
+         enc.write( packed->data() + result.packed_transactions[i].first, unsigned_sizes[i] );
+         auto sig_digest = enc.result();
+
+         for( const auto& sig : block.transactions[i].signatures )
+         {
+            signatures.push_back( sig );
+            sig_digests.push_back( sig_digest );
+         }
+      }
+
+      vector< fc::ecc::public_key_data > keys( signatures.size() );
+      fc::ecc::public_key::recover_many( signatures.data(), sig_digests.data(), signatures.size(), keys.data(),
+         fc::ecc::non_canonical, post, signature_helpers );
+
+      const fc::ecc::public_key_data empty_key;
+      result.signature_keys.resize( trx_count );
+      size_t k = 0;
+      for( size_t i = 0; i < trx_count; ++i )
+      {
+         flat_set< public_key_type > trx_keys;
+         bool recovered = true;
+         for( size_t j = 0; j < block.transactions[i].signatures.size(); ++j, ++k )
+         {
+            // Duplicate signatures are rejected when the database recovers the keys itself
+            if( keys[k] == empty_key || !trx_keys.insert( public_key_type( keys[k] ) ).second )
+               recovered = false;
+         }
+
+         if( recovered )
+            result.signature_keys[i] = std::move( trx_keys );
+      }
+   }
+
+   result.packed_block = std::move( packed );
+
+   return result;
+}
+
+} } // freezone::chain
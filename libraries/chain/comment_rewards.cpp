@@ -65,9 +65,12 @@ void process_comment_rewards( database& db )
    auto current = cidx.begin();
 
    fc::time_point_sec now = db.head_block_time();
+   util::block_vector< const comment_object* > due_comments( db.get_block_arena() );
 
    while( current != cidx.end() && current->cashout_time <= now )
    {
+      due_comments.push_back( &( *current ) );
+
       if( current->net_rshares > 0 )
       {
          new_claims[ freezone_SYMBOL ] += util::evaluate_reward_curve( current->net_rshares.value, freezone_rf.author_reward_curve, freezone_rf.content_constant );
@@ -113,20 +116,24 @@ void process_comment_rewards( database& db )
    }
 
    const auto current_freezone_price = db.get_feed_history().current_median_history;
-   current = cidx.begin();
    util::comment_reward_context ctx;
+   ctx.total_claims = reward_funds[ freezone_SYMBOL ].recent_claims;
+   ctx.reward_fund = reward_funds[ freezone_SYMBOL ].reward_balance.amount;
 
-   while( current != cidx.end() && current->cashout_time <= now )
+   // Paying a comment does not change the payout of any other comment, see comment_payout
+   auto payouts = db.compute_comment_payouts( due_comments,
+      util::block_vector< util::comment_reward_context >( due_comments.size(), ctx, db.get_block_arena() ), current_freezone_price );
+
+   for( size_t i = 0; i < due_comments.size(); ++i )
    {
-      ctx.total_claims = reward_funds[ freezone_SYMBOL ].recent_claims;
-      ctx.reward_fund = reward_funds[ freezone_SYMBOL ].reward_balance.amount;
-      reward_funds[ freezone_SYMBOL ].tokens_awarded += db.cashout_comment_helper( ctx, *current, current_freezone_price, false );
+      const auto& comment = *due_comments[ i ];
+      reward_funds[ freezone_SYMBOL ].tokens_awarded += db.cashout_comment_helper( comment, payouts[ i ], false );
 
-      for( auto SST_rshare : current->SST_rshares )
+      for( auto SST_rshare : comment.SST_rshares )
       {
-         auto beneficiaries = db.find< comment_SST_beneficiaries_object, by_comment_symbol >( boost::make_tuple( current->id, SST_rshare.first ) );
-         auto va_opts = current->allowed_vote_assets.find( SST_rshare.first );
-         comment_context c_ctx( *current, SST_rshare.second, va_opts->second, beneficiaries != nullptr ? &(beneficiaries->beneficiaries) : nullptr );
+         auto beneficiaries = db.find< comment_SST_beneficiaries_object, by_comment_symbol >( boost::make_tuple( comment.id, SST_rshare.first ) );
+         auto va_opts = comment.allowed_vote_assets.find( SST_rshare.first );
+         comment_context c_ctx( comment, SST_rshare.second, va_opts->second, beneficiaries != nullptr ? &(beneficiaries->beneficiaries) : nullptr );
 
          // The find here is safe because the comment has rshares for that symbol already, which requires the vote assets to exits
          reward_funds[ SST_rshare.first ].tokens_awarded += reward_comment(
@@ -137,7 +144,7 @@ void process_comment_rewards( database& db )
             db
          );
 
-         db.modify( *current, [&]( comment_object& c )
+         db.modify( comment, [&]( comment_object& c )
          {
             c.net_rshares = c_ctx.net_rshares;
             c.abs_rshares = c_ctx.abs_rshares;
@@ -149,8 +156,6 @@ void process_comment_rewards( database& db )
 #endif
          });
       }
-
-      current = cidx.begin();
    }
 
    for( auto& rf_ctx : reward_funds )
@@ -1,6 +1,7 @@
 #include <freezone/chain/freezone_fwd.hpp>
 
 #include <freezone/protocol/freezone_operations.hpp>
+#include <freezone/protocol/transaction_util.hpp>
 
 #include <freezone/chain/block_summary_object.hpp>
 #include <freezone/chain/compound.hpp>
@@ -21,6 +22,7 @@
 #include <freezone/chain/freezone_objects.hpp>
 #include <freezone/chain/transaction_object.hpp>
 #include <freezone/chain/shared_db_merkle.hpp>
+#include <freezone/chain/shared_sign_state.hpp>
 #include <freezone/chain/vesting.hpp>
 #include <freezone/chain/witness_schedule.hpp>
 
@@ -37,6 +39,8 @@
 #include <fc/smart_ref_impl.hpp>
 #include <fc/uint128.hpp>
 
+#include <fc/crypto/city.hpp>
+
 #include <fc/container/deque.hpp>
 
 #include <fc/io/fstream.hpp>
@@ -48,9 +52,11 @@
 #include <iostream>
 
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <functional>
+#include <thread>
 
 namespace freezone { namespace chain {
 
@@ -142,6 +148,16 @@ void database::open( const open_args& args )
       init_schema();
       chainbase::database::open( args.shared_mem_dir, args.chainbase_flags, args.shared_file_size, args.database_cfg );
 
+      // Bodies stored while the option was enabled remain referenced after it is disabled, so an existing
+      // store is always opened. A new one is only created when the option is enabled.
+      fc::path comment_body_file = args.shared_mem_dir / "comment_body.blob";
+      if( args.comment_body_store || fc::exists( comment_body_file ) )
+         _comment_body_store.open( comment_body_file );
+      _comment_body_store.set_cache_size( args.comment_body_cache_size );
+      _comment_body_store_enabled = args.comment_body_store;
+      _comment_payout_threads = args.comment_payout_threads;
+      _signature_recovery_threads = args.signature_recovery_threads;
+
       initialize_indexes();
       initialize_evaluators();
 
@@ -183,6 +199,9 @@ void database::open( const open_args& args )
             if (args.do_validate_invariants)
                validate_invariants();
          }
+
+         if( args.compact_comment_body_store )
+            compact_comment_body_store( comment_body_file );
       });
 
       if( head_block_num() )
@@ -366,6 +385,7 @@ void database::wipe( const fc::path& data_dir, const fc::path& shared_mem_dir, b
 {
    close();
    chainbase::database::wipe( shared_mem_dir );
+   fc::remove_all( shared_mem_dir / "comment_body.blob" );
    if( include_blocks )
    {
       fc::remove_all( data_dir / "block_log" );
@@ -389,6 +409,10 @@ void database::close(bool rewind)
       chainbase::database::flush();
       chainbase::database::close();
 
+      _comment_body_store.close();
+      _recent_comment_bodies.clear();
+      _signature_recovery_pool.reset();
+
       _block_log.close();
 
       _fork_db.reset();
@@ -603,26 +627,158 @@ const account_object* database::find_account( const account_name_type& name )con
 
 const comment_object& database::get_comment( const account_name_type& author, const shared_string& permlink )const
 { try {
-   return get< comment_object, by_permlink >( boost::make_tuple( author, permlink ) );
+   const auto* comment = find_comment( author, permlink.c_str(), permlink.size() );
+   FC_ASSERT( comment != nullptr, "Comment ${a}/${p} does not exist", ("a", author)("p", permlink) );
+   return *comment;
 } FC_CAPTURE_AND_RETHROW( (author)(permlink) ) }
 
 const comment_object* database::find_comment( const account_name_type& author, const shared_string& permlink )const
 {
-   return find< comment_object, by_permlink >( boost::make_tuple( author, permlink ) );
+   return find_comment( author, permlink.c_str(), permlink.size() );
+}
+
+const comment_object* database::find_comment( const account_name_type& author, const char* permlink, size_t size )const
+{
+   const auto& idx = get_index< comment_index, by_permlink_hash >();
+   uint64_t hash = hash_permlink( permlink, size );
+
+   for( auto itr = idx.lower_bound( boost::make_tuple( author, hash ) );
+        itr != idx.end() && itr->author == author && itr->permlink_hash == hash;
+        ++itr )
+   {
+      if( itr->permlink.size() == size && std::memcmp( itr->permlink.c_str(), permlink, size ) == 0 )
+         return &(*itr);
+   }
+
+   return nullptr;
 }
 
 #ifndef ENABLE_MIRA
 const comment_object& database::get_comment( const account_name_type& author, const string& permlink )const
 { try {
-   return get< comment_object, by_permlink >( boost::make_tuple( author, permlink) );
+   const auto* comment = find_comment( author, permlink.c_str(), permlink.size() );
+   FC_ASSERT( comment != nullptr, "Comment ${a}/${p} does not exist", ("a", author)("p", permlink) );
+   return *comment;
 } FC_CAPTURE_AND_RETHROW( (author)(permlink) ) }
 
 const comment_object* database::find_comment( const account_name_type& author, const string& permlink )const
 {
-   return find< comment_object, by_permlink >( boost::make_tuple( author, permlink ) );
+   return find_comment( author, permlink.c_str(), permlink.size() );
 }
 #endif
 
+std::string database::get_comment_body( const comment_content_object& content )const
+{
+   if( content.body_blob_size )
+      return _comment_body_store.read( content.body_blob_offset, content.body_blob_size );
+
+   return to_string( content.body );
+}
+
+void database::set_comment_body( comment_content_object& content, const std::string& body )
+{
+   if( _comment_body_store_enabled && body.size() )
+   {
+      // An edit leaving the body unchanged keeps referencing the blob already written
+      if( content.body_blob_size == body.size() && _comment_body_store.read( content.body_blob_offset, content.body_blob_size ) == body )
+         return;
+
+      // The same body is set again whenever its transaction is reapplied, e.g. when pending transactions
+      // are undone around each block or on a fork switch
+      uint64_t hash = fc::city_hash64( body.data(), body.size() );
+      auto range = _recent_comment_bodies.equal_range( hash );
+      auto itr = std::find_if( range.first, range.second, [&]( const std::pair< const uint64_t, recent_comment_body >& recent )
+      {
+         return recent.second.size == body.size() && _comment_body_store.read( recent.second.offset, recent.second.size ) == body;
+      });
+
+      if( itr != range.second )
+      {
+         content.body_blob_offset = itr->second.offset;
+      }
+      else
+      {
+         recent_comment_body recent;
+         recent.offset = _comment_body_store.append( body );
+         recent.size = body.size();
+         recent.head_block_num = head_block_num();
+         _recent_comment_bodies.emplace( hash, recent );
+         content.body_blob_offset = recent.offset;
+      }
+
+      content.body_blob_size = body.size();
+      content.body.clear();
+   }
+   else
+   {
+      from_string( content.body, body );
+      content.body_blob_offset = 0;
+      content.body_blob_size = 0;
+   }
+}
+
+void database::prune_recent_comment_bodies( uint32_t last_irreversible_block_num )
+{
+   for( auto itr = _recent_comment_bodies.begin(); itr != _recent_comment_bodies.end(); )
+   {
+      if( itr->second.head_block_num <= last_irreversible_block_num )
+         itr = _recent_comment_bodies.erase( itr );
+      else
+         ++itr;
+   }
+}
+
+bool database::has_comment_body_store_bodies()const
+{
+   return !_comment_body_store.empty();
+}
+
+/**
+ * Edited and deleted comments leave their previous bodies behind in the store. This copies the bodies still
+ * referenced to a new store and repoints their content objects. It runs on open, once undo state has been
+ * discarded, so no undo session can restore an offset into the previous store. Interrupting it requires a replay.
+ */
+void database::compact_comment_body_store( const fc::path& file )
+{ try {
+   if( !_comment_body_store.is_open() )
+      return;
+
+   fc::path compacted_file = file.parent_path() / ( file.filename().generic_string() + ".compact" );
+   fc::remove_all( compacted_file );
+
+   std::vector< std::pair< comment_content_id_type, uint64_t > > offsets;
+   {
+      blob_store compacted;
+      compacted.open( compacted_file );
+
+      const auto& content_idx = get_index< comment_content_index, by_id >();
+      for( const auto& content : content_idx )
+      {
+         if( content.body_blob_size )
+            offsets.emplace_back( content.id, compacted.append( _comment_body_store.read( content.body_blob_offset, content.body_blob_size ) ) );
+      }
+
+      compacted.close();
+   }
+
+   uint64_t previous_size = _comment_body_store.size();
+
+   for( const auto& offset : offsets )
+   {
+      modify( get< comment_content_object >( offset.first ), [&]( comment_content_object& c )
+      {
+         c.body_blob_offset = offset.second;
+      });
+   }
+
+   _recent_comment_bodies.clear();
+   _comment_body_store.close();
+   fc::rename( compacted_file, file );
+   _comment_body_store.open( file );
+
+   ilog( "Compacted comment body store from ${p} to ${n} bytes, ${c} bodies", ("p", previous_size)("n", _comment_body_store.size())("c", offsets.size()) );
+} FC_CAPTURE_AND_RETHROW( (file) ) }
+
 const escrow_object& database::get_escrow( const account_name_type& name, uint32_t escrow_id )const
 { try {
    return get< escrow_object, by_from_id >( boost::make_tuple( name, escrow_id ) );
@@ -684,6 +840,11 @@ const hardfork_property_object& database::get_hardfork_property_object()const
    return get< hardfork_property_object >();
 } FC_CAPTURE_AND_RETHROW() }
 
+const expiration_agenda_object& database::get_expiration_agenda()const
+{ try {
+   return get< expiration_agenda_object >();
+} FC_CAPTURE_AND_RETHROW() }
+
 const time_point_sec database::calculate_discussion_payout_time( const comment_object& comment )const
 {
    if( has_hardfork( freezone_HARDFORK_0_17__769 ) || comment.parent_author == freezone_ROOT_POST_PARENT )
@@ -737,8 +898,13 @@ bool database::before_last_checkpoint()const
  *
  * @return true if we switched forks as a result of this push.
  */
-bool database::push_block(const signed_block& new_block, uint32_t skip)
+bool database::push_block(const signed_block& new_block, uint32_t skip, const prevalidated_block* prevalidated)
 {
+   _prevalidated_block = prevalidated;
+   BOOST_SCOPE_EXIT(this_) {
+      this_->_prevalidated_block = nullptr;
+   } BOOST_SCOPE_EXIT_END
+
    //fc::time_point begin_time = fc::time_point::now();
 
    auto block_num = new_block.block_num();
@@ -813,7 +979,11 @@ bool database::_push_block(const signed_block& new_block)
 
    if( !(skip&skip_fork_db) )
    {
-      shared_ptr<fork_item> new_head = _fork_db.push_block(new_block);
+      shared_ptr< const std::vector< char > > packed_block;
+      if( _prevalidated_block != nullptr && _prevalidated_block->block_id == new_block.id() )
+         packed_block = _prevalidated_block->packed_block;
+
+      shared_ptr<fork_item> new_head = _fork_db.push_block(new_block, std::move(packed_block));
       _maybe_warn_multiple_production( new_head->num );
 
       //If the head block from the longest chain does not build off of the current head, we need to switch forks.
@@ -1013,6 +1183,7 @@ void database::post_push_virtual_operation( const operation& op )
 void database::notify_pre_apply_operation( const operation_notification& note )
 {
    freezone_TRY_NOTIFY( _pre_apply_operation_signal, note )
+   freezone_TRY_NOTIFY( notify_operation_subscribers< true >, _pre_apply_operation_handlers, note )
 }
 
 struct action_validate_visitor
@@ -1094,6 +1265,7 @@ void database::notify_post_apply_optional_action( const optional_action_notifica
 void database::notify_post_apply_operation( const operation_notification& note )
 {
    freezone_TRY_NOTIFY( _post_apply_operation_signal, note )
+   freezone_TRY_NOTIFY( notify_operation_subscribers< false >, _post_apply_operation_handlers, note )
 }
 
 void database::notify_pre_apply_block( const block_notification& note )
@@ -1283,6 +1455,7 @@ void database::adjust_proxied_witness_votes( const account_object& a,
       for( int i = freezone_MAX_PROXY_RECURSION_DEPTH - depth; i >= 0; --i )
          total_delta += delta[i];
       adjust_witness_votes( a, total_delta );
+      adjust_proposal_votes( a, total_delta );
    }
 }
 
@@ -1306,6 +1479,7 @@ void database::adjust_proxied_witness_votes( const account_object& a, share_type
    else
    {
      adjust_witness_votes( a, delta );
+     adjust_proposal_votes( a, delta );
    }
 }
 
@@ -1320,6 +1494,25 @@ void database::adjust_witness_votes( const account_object& a, share_type delta )
    }
 }
 
+void database::adjust_proposal_votes( const account_object& a, share_type delta )
+{
+   if( delta == 0 )
+      return;
+
+   const auto& pvidx = get_index< proposal_vote_index >().indices().get< by_voter_proposal >();
+   const auto& pidx = get_index< proposal_index >().indices().get< by_proposal_id >();
+
+   auto itr = pvidx.lower_bound( a.name );
+   while( itr != pvidx.end() && itr->voter == a.name )
+   {
+      modify( *pidx.find( itr->proposal_id ), [&]( proposal_object& p )
+      {
+         p.running_votes += delta.value;
+      } );
+      ++itr;
+   }
+}
+
 void database::adjust_witness_vote( const witness_object& witness, share_type delta )
 {
    const witness_schedule_object& wso = get_witness_schedule_object();
@@ -1518,6 +1711,8 @@ void database::update_owner_authority( const account_object& account, const auth
          hist.previous_owner_authority = get< account_authority_object, by_account >( account.name ).owner;
          hist.last_valid_time = head_block_time();
       });
+
+      schedule_expiration( expired_owner_authority_history, time_point_sec( head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD ) );
    }
 
    modify( get< account_authority_object, by_account >( account.name ), [&]( account_authority_object& auth )
@@ -1529,9 +1724,13 @@ void database::update_owner_authority( const account_object& account, const auth
 
 void database::process_vesting_withdrawals()
 {
+   if( !is_expiration_due( matured_vesting_withdrawals ) )
+      return;
+
    const auto& token_balance_idx = get_index < account_regular_balance_index, by_next_vesting_withdrawal >();
    for ( auto iter = token_balance_idx.begin(); iter != token_balance_idx.end() && iter->next_vesting_withdrawal <= head_block_time(); ++iter )
    {
+      ++_expiration_counts[ matured_vesting_withdrawals ];
       const auto& token = get< SST_token_object, by_symbol >( iter->get_liquid_symbol() );
       share_type to_withdraw;
       if ( iter->to_withdraw - iter->withdrawn < iter->vesting_withdraw_rate.amount )
@@ -1582,6 +1781,7 @@ void database::process_vesting_withdrawals()
    while( current != widx.end() && current->next_vesting_withdrawal <= head_block_time() )
    {
       const auto& from_account = *current; ++current;
+      ++_expiration_counts[ matured_vesting_withdrawals ];
 
       /**
       *  Let T = total tokens in vesting fund
@@ -1700,6 +1900,13 @@ void database::process_vesting_withdrawals()
 
       post_push_virtual_operation( vop );
    }
+
+   auto next_due = fc::time_point_sec::maximum();
+   if( token_balance_idx.begin() != token_balance_idx.end() )
+      next_due = token_balance_idx.begin()->next_vesting_withdrawal;
+   if( widx.begin() != widx.end() )
+      next_due = std::min( next_due, widx.begin()->next_vesting_withdrawal );
+   reschedule_expiration( matured_vesting_withdrawals, next_due );
 }
 
 void database::adjust_total_payout( const comment_object& cur, const asset& sbd_created, const asset& curator_sbd_value, const asset& beneficiary_value )
@@ -1714,13 +1921,20 @@ void database::adjust_total_payout( const comment_object& cur, const asset& sbd_
    /// TODO: potentially modify author's total payout numbers as well
 }
 
+void fill_comment_reward_context_local_state( util::comment_reward_context& ctx, const comment_object& comment )
+{
+   ctx.rshares = comment.net_rshares;
+   ctx.reward_weight = comment.reward_weight;
+}
+
 /**
  *  This method will iterate through all comment_vote_objects and give them
  *  (max_rewards * weight) / c.total_vote_weight.
  *
- *  @returns unclaimed rewards.
+ *  @returns the payout of the comment, including the claims of curators
+ *  and the unclaimed rewards.
  */
-share_type database::pay_curators( const comment_object& c, share_type& max_rewards )
+comment_payout database::compute_comment_payout( util::comment_reward_context ctx, const comment_object& comment, const price& current_freezone_price )const
 {
    struct cmp
    {
@@ -1735,100 +1949,186 @@ share_type database::pay_curators( const comment_object& c, share_type& max_rewa
 
    try
    {
-      uint128_t total_weight( c.total_vote_weight );
-      //edump( (total_weight)(max_rewards) );
-      share_type unclaimed_rewards = max_rewards;
+      comment_payout payout;
+      payout.comment = comment.id;
+
+      if( comment.net_rshares <= 0 )
+         return payout;
 
-      if( !c.allow_curation_rewards )
+      fill_comment_reward_context_local_state( ctx, comment );
+
+      if( has_hardfork( freezone_HARDFORK_0_17__774 ) )
+      {
+         const auto& rf = get_reward_fund( comment );
+         ctx.reward_curve = rf.author_reward_curve;
+         ctx.content_constant = rf.content_constant;
+      }
+
+      uint64_t reward = util::get_rshare_reward( ctx );
+
+      // If it is payout dust
+      if( util::to_sbd( current_freezone_price, asset( reward, freezone_SYMBOL ) ) < freezone_MIN_PAYOUT_SBD )
+         reward = 0;
+
+      uint64_t max_freezone = util::to_freezone( current_freezone_price, comment.max_accepted_payout ).amount.value;
+
+      reward = std::min( reward, max_freezone );
+
+      uint128_t reward_tokens = uint128_t( reward );
+
+      if( reward_tokens == 0 )
+         return payout;
+
+      share_type curation_tokens = ( ( reward_tokens * get_curation_rewards_percent( comment ) ) / freezone_100_PERCENT ).to_uint64();
+      payout.reward_tokens = reward_tokens.to_uint64();
+      payout.author_tokens = payout.reward_tokens - curation_tokens;
+
+      uint128_t total_weight( comment.total_vote_weight );
+      share_type unclaimed_rewards = curation_tokens;
+
+      if( !comment.allow_curation_rewards )
       {
          unclaimed_rewards = 0;
-         max_rewards = 0;
+         curation_tokens = 0;
       }
-      else if( c.total_vote_weight > 0 )
+      else if( comment.total_vote_weight > 0 )
       {
          const auto& cvidx = get_index< comment_vote_index, by_comment_symbol_voter >();
-         auto itr = cvidx.lower_bound( boost::make_tuple( c.id, freezone_SYMBOL ) );
+         auto itr = cvidx.lower_bound( boost::make_tuple( comment.id, freezone_SYMBOL ) );
 
          std::set< const comment_vote_object*, cmp > proxy_set;
-         while( itr != cvidx.end() && itr->comment == c.id && itr->symbol == freezone_SYMBOL )
+         while( itr != cvidx.end() && itr->comment == comment.id && itr->symbol == freezone_SYMBOL )
          {
             proxy_set.insert( &( *itr ) );
             ++itr;
          }
 
          for( auto& item : proxy_set )
-         { try {
+         {
             uint128_t weight( item->weight );
-            auto claim = ( ( max_rewards.value * weight ) / total_weight ).to_uint64();
+            auto claim = ( ( curation_tokens.value * weight ) / total_weight ).to_uint64();
             if( claim > 0 ) // min_amt is non-zero satoshis
             {
                unclaimed_rewards -= claim;
-               const auto& voter = get( item->voter );
-               operation vop = curation_reward_operation( voter.name, asset(0, VESTS_SYMBOL), c.author, to_string( c.permlink ) );
-               create_vesting2( *this, voter, asset( claim, freezone_SYMBOL ), has_hardfork( freezone_HARDFORK_0_17__659 ),
-                  [&]( const asset& reward )
-                  {
-                     vop.get< curation_reward_operation >().reward = reward;
-                     pre_push_virtual_operation( vop );
-                  } );
-
-               #ifndef IS_LOW_MEM
-                  modify( voter, [&]( account_object& a )
-                  {
-                     a.curation_rewards += claim;
-                  });
-               #endif
-               post_push_virtual_operation( vop );
+               payout.curators.push_back( curation_payout{ item->voter, claim } );
             }
-         } FC_CAPTURE_AND_RETHROW( (*item) ) }
+         }
       }
-      max_rewards -= unclaimed_rewards;
 
-      return unclaimed_rewards;
-   } FC_CAPTURE_AND_RETHROW( (max_rewards) )
-}
+      payout.curation_tokens = curation_tokens - unclaimed_rewards;
+      payout.curation_remainder = unclaimed_rewards;
 
-void fill_comment_reward_context_local_state( util::comment_reward_context& ctx, const comment_object& comment )
-{
-   ctx.rshares = comment.net_rshares;
-   ctx.reward_weight = comment.reward_weight;
+      return payout;
+   } FC_CAPTURE_AND_RETHROW( (comment)(ctx) )
 }
 
-share_type database::cashout_comment_helper( util::comment_reward_context& ctx, const comment_object& comment, const price& current_freezone_price, bool forward_curation_remainder )
+util::block_vector< comment_payout > database::compute_comment_payouts( const util::block_vector< const comment_object* >& comments,
+   const util::block_vector< util::comment_reward_context >& contexts, const price& current_freezone_price )const
 {
-   try
+   FC_ASSERT( comments.size() == contexts.size() );
+
+   util::block_vector< comment_payout > payouts( comments.size(), comment_payout(), comments.get_allocator() );
+
+   // Starting threads is only worth it when each of them has a few comments with votes to walk
+   size_t num_threads = std::min< size_t >( _comment_payout_threads, comments.size() / 8 );
+
+#ifdef ENABLE_MIRA
+   // MIRA indices cache objects as they are read and may not be read from several threads
+   num_threads = 0;
+#endif
+
+   if( num_threads <= 1 )
    {
-      share_type claimed_reward = 0;
+      for( size_t i = 0; i < comments.size(); ++i )
+         payouts[ i ] = compute_comment_payout( contexts[ i ], *comments[ i ], current_freezone_price );
 
-      if( comment.net_rshares > 0 )
-      {
-         fill_comment_reward_context_local_state( ctx, comment );
+      return payouts;
+   }
 
-         if( has_hardfork( freezone_HARDFORK_0_17__774 ) )
+   // Nothing modifies the database while the payouts are computed, so the indices may be read concurrently
+   vector< std::thread > threads;
+   vector< std::exception_ptr > errors( num_threads );
+
+   for( size_t t = 0; t < num_threads; ++t )
+   {
+      threads.emplace_back( [&, t]()
+      {
+         try
          {
-            const auto rf = get_reward_fund( comment );
-            ctx.reward_curve = rf.author_reward_curve;
-            ctx.content_constant = rf.content_constant;
+            for( size_t i = t; i < comments.size(); i += num_threads )
+               payouts[ i ] = compute_comment_payout( contexts[ i ], *comments[ i ], current_freezone_price );
          }
+         catch( ... )
+         {
+            errors[ t ] = std::current_exception();
+         }
+      } );
+   }
 
-         uint64_t reward = util::get_rshare_reward( ctx );
+   for( auto& thread : threads )
+      thread.join();
 
-         // If it is payout dust
-         if( util::to_sbd( current_freezone_price, asset( reward, freezone_SYMBOL ) ) < freezone_MIN_PAYOUT_SBD )
-            reward = 0;
+   for( auto& error : errors )
+   {
+      if( error )
+         std::rethrow_exception( error );
+   }
 
-         uint64_t max_freezone = util::to_freezone( current_freezone_price, comment.max_accepted_payout ).amount.value;
+   return payouts;
+}
 
-         reward = std::min( reward, max_freezone );
+/**
+ *  Pays the curation rewards computed by compute_comment_payout.
+ *
+ *  @returns unclaimed rewards.
+ */
+share_type database::pay_curators( const comment_object& c, const comment_payout& payout )
+{
+   try
+   {
+      for( const auto& item : payout.curators )
+      { try {
+         const auto& voter = get( item.voter );
+         operation vop = curation_reward_operation( voter.name, asset(0, VESTS_SYMBOL), c.author, to_string( c.permlink ) );
+         create_vesting2( *this, voter, asset( item.claim, freezone_SYMBOL ), has_hardfork( freezone_HARDFORK_0_17__659 ),
+            [&]( const asset& reward )
+            {
+               vop.get< curation_reward_operation >().reward = reward;
+               pre_push_virtual_operation( vop );
+            } );
 
-         uint128_t reward_tokens = uint128_t( reward );
+         #ifndef IS_LOW_MEM
+            modify( voter, [&]( account_object& a )
+            {
+               a.curation_rewards += item.claim;
+            });
+         #endif
+         post_push_virtual_operation( vop );
+      } FC_CAPTURE_AND_RETHROW( (item) ) }
 
-         if( reward_tokens > 0 )
+      return payout.curation_remainder;
+   } FC_CAPTURE_AND_RETHROW( (payout) )
+}
+
+share_type database::cashout_comment_helper( util::comment_reward_context& ctx, const comment_object& comment, const price& current_freezone_price, bool forward_curation_remainder )
+{
+   return cashout_comment_helper( comment, compute_comment_payout( ctx, comment, current_freezone_price ), forward_curation_remainder );
+}
+
+share_type database::cashout_comment_helper( const comment_object& comment, const comment_payout& payout, bool forward_curation_remainder )
+{
+   try
+   {
+      share_type claimed_reward = 0;
+
+      if( comment.net_rshares > 0 )
+      {
+         if( payout.reward_tokens > 0 )
          {
-            share_type curation_tokens = ( ( reward_tokens * get_curation_rewards_percent( comment ) ) / freezone_100_PERCENT ).to_uint64();
-            share_type author_tokens = reward_tokens.to_uint64() - curation_tokens;
+            share_type curation_tokens = payout.curation_tokens;
+            share_type author_tokens = payout.author_tokens;
 
-            share_type curation_remainder = pay_curators( comment, curation_tokens );
+            share_type curation_remainder = pay_curators( comment, payout );
 
             if( forward_curation_remainder )
                author_tokens += curation_remainder;
@@ -1965,7 +2265,7 @@ share_type database::cashout_comment_helper( util::comment_reward_context& ctx,
       }
 
       return claimed_reward;
-   } FC_CAPTURE_AND_RETHROW( (comment)(ctx) )
+   } FC_CAPTURE_AND_RETHROW( (comment)(payout) )
 }
 
 void database::process_comment_cashout()
@@ -1986,8 +2286,7 @@ void database::process_comment_cashout()
    util::comment_reward_context ctx;
    const price current_freezone_price = get_feed_history().current_median_history;
 
-   vector< reward_fund_context > funds;
-   vector< share_type > freezone_awarded;
+   util::block_vector< reward_fund_context > funds( _block_arena );
    const auto& reward_idx = get_index< reward_fund_index, by_id >();
 
    // Decay recent rshares of each fund
@@ -2021,6 +2320,7 @@ void database::process_comment_cashout()
    const auto& com_by_root = get_index< comment_index >().indices().get< by_root >();
 
    auto current = cidx.begin();
+   util::block_vector< const comment_object* > due_comments( _block_arena );
    //  add all rshares about to be cashed out to the reward funds. This ensures equal satoshi per rshare payment
    if( has_hardfork( freezone_HARDFORK_0_17__771 ) )
    {
@@ -2032,6 +2332,7 @@ void database::process_comment_cashout()
             funds[ rf.id._id ].recent_claims += util::evaluate_reward_curve( current->net_rshares.value, rf.author_reward_curve, rf.content_constant );
          }
 
+         due_comments.push_back( &( *current ) );
          ++current;
       }
 
@@ -2051,19 +2352,33 @@ void database::process_comment_cashout()
     * the global state updated each payout. After the hardfork, each payout is done
     * against a reward fund state that is snapshotted before all payouts in the block.
     */
-   while( current != cidx.end() && current->cashout_time <= head_block_time() )
+   if( has_hardfork( freezone_HARDFORK_0_17__771 ) )
    {
-      if( has_hardfork( freezone_HARDFORK_0_17__771 ) )
+      /*
+       * After the hardfork a payout does not change the reward fund state or any other comment, so the
+       * payouts of all due comments are computed up front, possibly concurrently, and then applied in
+       * cashout order. Paid comments never cash out again, so this is the order of the loop below.
+       */
+      util::block_vector< util::comment_reward_context > contexts( due_comments.size(), util::comment_reward_context(), _block_arena );
+      for( size_t i = 0; i < due_comments.size(); ++i )
       {
-         auto fund_id = get_reward_fund( *current ).id._id;
-         ctx.total_claims = funds[ fund_id ].recent_claims;
-         ctx.reward_fund = funds[ fund_id ].reward_balance.amount;
+         auto fund_id = get_reward_fund( *due_comments[ i ] ).id._id;
+         contexts[ i ].total_claims = funds[ fund_id ].recent_claims;
+         contexts[ i ].reward_fund = funds[ fund_id ].reward_balance.amount;
+      }
 
-         bool forward_curation_remainder = !has_hardfork( freezone_HARDFORK_0_20__1877 );
+      auto payouts = compute_comment_payouts( due_comments, contexts, current_freezone_price );
+      bool forward_curation_remainder = !has_hardfork( freezone_HARDFORK_0_20__1877 );
 
-         funds[ fund_id ].tokens_awarded += cashout_comment_helper( ctx, *current, current_freezone_price, forward_curation_remainder );
+      for( size_t i = 0; i < due_comments.size(); ++i )
+      {
+         auto fund_id = get_reward_fund( *due_comments[ i ] ).id._id;
+         funds[ fund_id ].tokens_awarded += cashout_comment_helper( *due_comments[ i ], payouts[ i ], forward_curation_remainder );
       }
-      else
+   }
+   else
+   {
+      while( current != cidx.end() && current->cashout_time <= head_block_time() )
       {
          auto itr = com_by_root.lower_bound( current->root_comment );
          while( itr != com_by_root.end() && itr->root_comment == current->root_comment )
@@ -2082,9 +2397,9 @@ void database::process_comment_cashout()
                });
             }
          }
-      }
 
-      current = cidx.begin();
+         current = cidx.begin();
+      }
    }
 
    // Write the cached fund state back to the database
@@ -2208,11 +2523,15 @@ void database::process_funds()
 
 void database::process_savings_withdraws()
 {
+  if( !is_expiration_due( matured_savings_withdraws ) )
+     return;
+
   const auto& idx = get_index< savings_withdraw_index >().indices().get< by_complete_from_rid >();
   auto itr = idx.begin();
   while( itr != idx.end() ) {
      if( itr->complete > head_block_time() )
         break;
+     ++_expiration_counts[ matured_savings_withdraws ];
      adjust_balance( get_account( itr->to ), itr->amount );
 
      modify( get_account( itr->from ), [&]( account_object& a )
@@ -2225,6 +2544,8 @@ void database::process_savings_withdraws()
      remove( *itr );
      itr = idx.begin();
   }
+
+  reschedule_expiration( matured_savings_withdraws, itr != idx.end() ? itr->complete : fc::time_point_sec::maximum() );
 }
 
 void database::process_subsidized_accounts()
@@ -2399,6 +2720,9 @@ share_type database::pay_reward_funds( share_type reward )
  */
 void database::process_conversions()
 {
+   if( !is_expiration_due( matured_conversions ) )
+      return;
+
    auto now = head_block_time();
    const auto& request_by_date = get_index< convert_request_index >().indices().get< by_conversion_date >();
    auto itr = request_by_date.begin();
@@ -2412,6 +2736,7 @@ void database::process_conversions()
 
    while( itr != request_by_date.end() && itr->conversion_date <= now )
    {
+      ++_expiration_counts[ matured_conversions ];
       auto amount_to_issue = itr->amount * fhistory.current_median_history;
 
       adjust_balance( itr->owner, amount_to_issue );
@@ -2425,6 +2750,11 @@ void database::process_conversions()
       itr = request_by_date.begin();
    }
 
+   reschedule_expiration( matured_conversions, itr != request_by_date.end() ? itr->conversion_date : fc::time_point_sec::maximum() );
+
+   if( net_sbd.amount == 0 )
+      return;
+
    const auto& props = get_dynamic_global_properties();
    modify( props, [&]( dynamic_global_property_object& p )
    {
@@ -2448,43 +2778,65 @@ asset database::to_freezone( const asset& sbd )const
 void database::account_recovery_processing()
 {
    // Clear expired recovery requests
-   const auto& rec_req_idx = get_index< account_recovery_request_index >().indices().get< by_expiration >();
-   auto rec_req = rec_req_idx.begin();
-
-   while( rec_req != rec_req_idx.end() && rec_req->expires <= head_block_time() )
+   if( is_expiration_due( expired_recovery_requests ) )
    {
-      remove( *rec_req );
-      rec_req = rec_req_idx.begin();
+      const auto& rec_req_idx = get_index< account_recovery_request_index >().indices().get< by_expiration >();
+      auto rec_req = rec_req_idx.begin();
+
+      while( rec_req != rec_req_idx.end() && rec_req->expires <= head_block_time() )
+      {
+         ++_expiration_counts[ expired_recovery_requests ];
+         remove( *rec_req );
+         rec_req = rec_req_idx.begin();
+      }
+
+      reschedule_expiration( expired_recovery_requests, rec_req != rec_req_idx.end() ? rec_req->expires : fc::time_point_sec::maximum() );
    }
 
    // Clear invalid historical authorities
-   const auto& hist_idx = get_index< owner_authority_history_index >().indices(); //by id
-   auto hist = hist_idx.begin();
-
-   while( hist != hist_idx.end() && time_point_sec( hist->last_valid_time + freezone_OWNER_AUTH_RECOVERY_PERIOD ) < head_block_time() )
+   if( is_expiration_due( expired_owner_authority_history ) )
    {
-      remove( *hist );
-      hist = hist_idx.begin();
+      const auto& hist_idx = get_index< owner_authority_history_index >().indices(); //by id
+      auto hist = hist_idx.begin();
+
+      while( hist != hist_idx.end() && time_point_sec( hist->last_valid_time + freezone_OWNER_AUTH_RECOVERY_PERIOD ) < head_block_time() )
+      {
+         ++_expiration_counts[ expired_owner_authority_history ];
+         remove( *hist );
+         hist = hist_idx.begin();
+      }
+
+      reschedule_expiration( expired_owner_authority_history,
+         hist != hist_idx.end() ? time_point_sec( hist->last_valid_time + freezone_OWNER_AUTH_RECOVERY_PERIOD ) : fc::time_point_sec::maximum() );
    }
 
    // Apply effective recovery_account changes
-   const auto& change_req_idx = get_index< change_recovery_account_request_index >().indices().get< by_effective_date >();
-   auto change_req = change_req_idx.begin();
-
-   while( change_req != change_req_idx.end() && change_req->effective_on <= head_block_time() )
+   if( is_expiration_due( matured_change_recovery_requests ) )
    {
-      modify( get_account( change_req->account_to_recover ), [&]( account_object& a )
+      const auto& change_req_idx = get_index< change_recovery_account_request_index >().indices().get< by_effective_date >();
+      auto change_req = change_req_idx.begin();
+
+      while( change_req != change_req_idx.end() && change_req->effective_on <= head_block_time() )
       {
-         a.recovery_account = change_req->recovery_account;
-      });
+         ++_expiration_counts[ matured_change_recovery_requests ];
+         modify( get_account( change_req->account_to_recover ), [&]( account_object& a )
+         {
+            a.recovery_account = change_req->recovery_account;
+         });
 
-      remove( *change_req );
-      change_req = change_req_idx.begin();
+         remove( *change_req );
+         change_req = change_req_idx.begin();
+      }
+
+      reschedule_expiration( matured_change_recovery_requests, change_req != change_req_idx.end() ? change_req->effective_on : fc::time_point_sec::maximum() );
    }
 }
 
 void database::expire_escrow_ratification()
 {
+   if( !is_expiration_due( expired_escrow_ratifications ) )
+      return;
+
    const auto& escrow_idx = get_index< escrow_index >().indices().get< by_ratification_deadline >();
    auto escrow_itr = escrow_idx.lower_bound( false );
 
@@ -2492,6 +2844,7 @@ void database::expire_escrow_ratification()
    {
       const auto& old_escrow = *escrow_itr;
       ++escrow_itr;
+      ++_expiration_counts[ expired_escrow_ratifications ];
 
       adjust_balance( old_escrow.from, old_escrow.freezone_balance );
       adjust_balance( old_escrow.from, old_escrow.sbd_balance );
@@ -2499,15 +2852,22 @@ void database::expire_escrow_ratification()
 
       remove( old_escrow );
    }
+
+   reschedule_expiration( expired_escrow_ratifications, escrow_itr != escrow_idx.end() && !escrow_itr->is_approved() ?
+      escrow_itr->ratification_deadline : fc::time_point_sec::maximum() );
 }
 
 void database::process_decline_voting_rights()
 {
+   if( !is_expiration_due( matured_decline_voting_rights ) )
+      return;
+
    const auto& request_idx = get_index< decline_voting_rights_request_index >().indices().get< by_effective_date >();
    auto itr = request_idx.begin();
 
    while( itr != request_idx.end() && itr->effective_date <= head_block_time() )
    {
+      ++_expiration_counts[ matured_decline_voting_rights ];
       const auto& account = get< account_object, by_name >( itr->account );
 
       /// remove all current votes
@@ -2525,9 +2885,14 @@ void database::process_decline_voting_rights()
          a.proxy = freezone_PROXY_TO_SELF_ACCOUNT;
       });
 
+      /// declining voting rights does not remove proposal votes, which count again now that the account proxies to itself
+      adjust_proposal_votes( account, account.witness_vote_weight() );
+
       remove( *itr );
       itr = request_idx.begin();
    }
+
+   reschedule_expiration( matured_decline_voting_rights, itr != request_idx.end() ? itr->effective_date : fc::time_point_sec::maximum() );
 }
 
 time_point_sec database::head_block_time()const
@@ -2841,6 +3206,9 @@ void database::init_genesis( uint64_t init_supply, uint64_t sbd_init_supply )
          hpo.processed_hardforks.push_back( freezone_GENESIS_TIME );
       } );
 
+      // Every expiration subsystem runs in the first block and schedules itself from there
+      create< expiration_agenda_object >( [&]( expiration_agenda_object& ) {} );
+
       // Create witness scheduler
       create< witness_schedule_object >( [&]( witness_schedule_object& wso )
       {
@@ -2966,6 +3334,7 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
          _next_flush_block = 0;
          //ilog( "Flushing database shared memory at block ${b}", ("b", block_num) );
          chainbase::database::flush();
+         _comment_body_store.flush();
       }
    }
 
@@ -3022,6 +3391,38 @@ void database::_apply_block( const signed_block& next_block )
 
    uint32_t skip = get_node_properties().skip_flags;
 
+   if( _prevalidated_block != nullptr && _prevalidated_block->block_id == note.block_id )
+      _current_prevalidated_block = _prevalidated_block;
+
+   // Runs after notify_post_apply_block, or when the block fails, so no temporary of the block is still alive
+   BOOST_SCOPE_EXIT(this_) {
+      this_->_current_prevalidated_block = nullptr;
+      this_->_current_signature_keys = nullptr;
+      this_->_applying_block = false;
+      this_->_block_arena.reset();
+   } BOOST_SCOPE_EXIT_END
+   _applying_block = true;
+
+   // Without prevalidated keys, the signatures of all transactions are recovered together before any is applied.
+   // Like the prevalidated keys, they are recovered without a canonicality requirement.
+   vector< fc::optional< flat_set< public_key_type > > > signature_keys;
+   if( _current_prevalidated_block != nullptr && !_current_prevalidated_block->signature_keys.empty() )
+   {
+      _current_signature_keys = &_current_prevalidated_block->signature_keys;
+   }
+   else if( !( skip & ( skip_transaction_signatures | skip_authority_check ) ) && next_block.transactions.size() > 0 )
+   {
+      if( _signature_recovery_threads > 1 && !_signature_recovery_pool )
+         _signature_recovery_pool.reset( new util::worker_pool( _signature_recovery_threads - 1 ) );
+
+      if( _signature_recovery_pool )
+         signature_keys = signed_transaction::get_signature_keys( next_block.transactions, get_chain_id(),
+            fc::ecc::non_canonical, _signature_recovery_pool->poster(), _signature_recovery_pool->size() );
+      else
+         signature_keys = signed_transaction::get_signature_keys( next_block.transactions, get_chain_id(), fc::ecc::non_canonical );
+      _current_signature_keys = &signature_keys;
+   }
+
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
    _current_virtual_op   = 0;
@@ -3065,7 +3466,7 @@ void database::_apply_block( const signed_block& next_block )
 
    if( !( skip & skip_merkle_check ) )
    {
-      auto merkle_root = next_block.calculate_merkle_root();
+      auto merkle_root = _current_prevalidated_block ? _current_prevalidated_block->merkle_root : next_block.calculate_merkle_root();
 
       try
       {
@@ -3081,10 +3482,10 @@ void database::_apply_block( const signed_block& next_block )
       }
    }
 
-   const witness_object& signing_witness = validate_block_header(skip, next_block);
+   const witness_object& signing_witness = validate_block_header(skip, next_block, _current_prevalidated_block);
 
    const auto& gprops = get_dynamic_global_properties();
-   auto block_size = fc::raw::pack_size( next_block );
+   auto block_size = _current_prevalidated_block ? _current_prevalidated_block->block_size : fc::raw::pack_size( next_block );
    if( has_hardfork( freezone_HARDFORK_0_12 ) )
    {
       FC_ASSERT( block_size <= gprops.maximum_block_size, "Block Size is too Big", ("next_block_num",next_block_num)("block_size", block_size)("max",gprops.maximum_block_size) );
@@ -3103,8 +3504,9 @@ void database::_apply_block( const signed_block& next_block )
       dgp.current_witness = next_block.witness;
    });
 
-   required_automated_actions req_actions;
-   optional_automated_actions opt_actions;
+   // The actions stay in the block, only pointers to them are collected
+   util::block_vector< const required_automated_action* > req_actions( _block_arena );
+   util::block_vector< const optional_automated_action* > opt_actions( _block_arena );
    /// parse witness version reporting
    process_header_extensions( next_block, req_actions, opt_actions );
 
@@ -3140,6 +3542,8 @@ void database::_apply_block( const signed_block& next_block )
    update_last_irreversible_block();
 
    create_block_summary(next_block);
+
+   _expiration_counts.fill( 0 );
    clear_expired_transactions();
    clear_expired_orders();
    clear_expired_delegations();
@@ -3193,7 +3597,8 @@ void database::_apply_block( const signed_block& next_block )
 
 struct process_header_visitor
 {
-   process_header_visitor( const std::string& witness, required_automated_actions& req_actions, optional_automated_actions& opt_actions, database& db ) :
+   process_header_visitor( const std::string& witness, util::block_vector< const required_automated_action* >& req_actions,
+      util::block_vector< const optional_automated_action* >& opt_actions, database& db ) :
       _witness( witness ),
       _req_actions( req_actions ),
       _opt_actions( opt_actions ),
@@ -3202,8 +3607,8 @@ struct process_header_visitor
    typedef void result_type;
 
    const std::string& _witness;
-   required_automated_actions& _req_actions;
-   optional_automated_actions& _opt_actions;
+   util::block_vector< const required_automated_action* >& _req_actions;
+   util::block_vector< const optional_automated_action* >& _opt_actions;
    database& _db;
 
    void operator()( const void_t& obj ) const
@@ -3241,17 +3646,20 @@ struct process_header_visitor
    void operator()( const required_automated_actions& req_actions ) const
    {
       FC_ASSERT( _db.has_hardfork( freezone_SST_HARDFORK ), "Automated actions are not enabled until SST hardfork." );
-      std::copy( req_actions.begin(), req_actions.end(), std::back_inserter( _req_actions ) );
+      for( const auto& a : req_actions )
+         _req_actions.push_back( &a );
    }
 
    void operator()( const optional_automated_actions& opt_actions ) const
    {
       FC_ASSERT( _db.has_hardfork( freezone_SST_HARDFORK ), "Automated actions are not enabled until SST hardfork." );
-      std::copy( opt_actions.begin(), opt_actions.end(), std::back_inserter( _opt_actions ) );
+      for( const auto& a : opt_actions )
+         _opt_actions.push_back( &a );
    }
 };
 
-void database::process_header_extensions( const signed_block& next_block, required_automated_actions& req_actions, optional_automated_actions& opt_actions )
+void database::process_header_extensions( const signed_block& next_block, util::block_vector< const required_automated_action* >& req_actions,
+   util::block_vector< const optional_automated_action* >& opt_actions )
 {
    process_header_visitor _v( next_block.witness, req_actions, opt_actions, *this );
 
@@ -3266,7 +3674,7 @@ try {
 
    auto now = head_block_time();
    const witness_schedule_object& wso = get_witness_schedule_object();
-   vector<price> feeds; feeds.reserve( wso.num_scheduled_witnesses );
+   util::block_vector< price > feeds( _block_arena ); feeds.reserve( wso.num_scheduled_witnesses );
    for( int i = 0; i < wso.num_scheduled_witnesses; i++ )
    {
       const auto& wit = get_witness( wso.current_shuffled_witnesses[i] );
@@ -3303,7 +3711,7 @@ try {
          if( fho.price_history.size() )
          {
             /// BW-TODO Why deque is used here ? Also why don't make copy of whole container ?
-            std::deque< price > copy;
+            util::block_deque< price > copy( _block_arena );
             for( const auto& i : fho.price_history )
             {
                copy.push_back( i );
@@ -3348,7 +3756,23 @@ void database::apply_transaction(const signed_transaction& trx, uint32_t skip)
 
 void database::_apply_transaction(const signed_transaction& trx)
 { try {
-   transaction_notification note(trx);
+   // Outside of a block nothing else resets the arena, so a pending transaction releases what it took itself
+   BOOST_SCOPE_EXIT(this_) {
+      if( !this_->_applying_block )
+         this_->_block_arena.reset();
+   } BOOST_SCOPE_EXIT_END
+
+   // When applying a prevalidated block, the id and the serialized transaction were already computed
+   const prevalidated_block* prevalidated = nullptr;
+   if( _current_prevalidated_block != nullptr && _current_trx_in_block >= 0
+      && static_cast< size_t >( _current_trx_in_block ) < _current_prevalidated_block->transaction_ids.size() )
+   {
+      prevalidated = _current_prevalidated_block;
+   }
+
+   transaction_notification note = prevalidated != nullptr
+      ? transaction_notification( trx, prevalidated->transaction_ids[ _current_trx_in_block ] )
+      : transaction_notification( trx );
    _current_trx_id = note.transaction_id;
    const transaction_id_type& trx_id = note.transaction_id;
    _current_virtual_op = 0;
@@ -3367,16 +3791,44 @@ void database::_apply_transaction(const signed_transaction& trx)
 
    if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
    {
-      auto get_active  = [&]( const string& name ) { return authority( get< account_authority_object, by_account >( name ).active ); };
-      auto get_owner   = [&]( const string& name ) { return authority( get< account_authority_object, by_account >( name ).owner );  };
-      auto get_posting = [&]( const string& name ) { return authority( get< account_authority_object, by_account >( name ).posting );  };
+      shared_authority_getter get_active  = [&]( const account_name_type& name ) -> const shared_authority& { return get< account_authority_object, by_account >( name ).active; };
+      shared_authority_getter get_owner   = [&]( const account_name_type& name ) -> const shared_authority& { return get< account_authority_object, by_account >( name ).owner; };
+      shared_authority_getter get_posting = [&]( const account_name_type& name ) -> const shared_authority& { return get< account_authority_object, by_account >( name ).posting; };
+
+      uint32_t max_membership = has_hardfork( freezone_HARDFORK_0_20 ) || is_producing() ? freezone_MAX_AUTHORITY_MEMBERSHIP : 0;
+      uint32_t max_account_auths = has_hardfork( freezone_HARDFORK_0_20 ) || is_producing() ? freezone_MAX_SIG_CHECK_ACCOUNTS : 0;
+      auto canon_type = has_hardfork( freezone_HARDFORK_0_20__1944 ) ? fc::ecc::bip_0062 : fc::ecc::fc_canonical;
+
+      const fc::optional< flat_set< public_key_type > >* recovered_keys = nullptr;
+      if( _current_signature_keys != nullptr && _current_trx_in_block >= 0
+         && static_cast< size_t >( _current_trx_in_block ) < _current_signature_keys->size() )
+      {
+         recovered_keys = &(*_current_signature_keys)[ _current_trx_in_block ];
+      }
 
       try
       {
-         trx.verify_authority( chain_id, get_active, get_owner, get_posting, freezone_MAX_SIG_CHECK_DEPTH,
-            has_hardfork( freezone_HARDFORK_0_20 ) || is_producing() ? freezone_MAX_AUTHORITY_MEMBERSHIP : 0,
-            has_hardfork( freezone_HARDFORK_0_20 ) || is_producing() ? freezone_MAX_SIG_CHECK_ACCOUNTS : 0,
-            has_hardfork( freezone_HARDFORK_0_20__1944 ) ? fc::ecc::bip_0062 : fc::ecc::fc_canonical );
+         // Authorities are evaluated in place in the database rather than copied for every account visited
+         auto verify = [&]( const auto& keys )
+         {
+            verify_shared_authority( trx.operations, keys, get_active, get_owner, get_posting, _block_arena,
+               freezone_MAX_SIG_CHECK_DEPTH, max_membership, max_account_auths );
+         };
+
+         if( recovered_keys != nullptr && recovered_keys->valid() )
+         {
+            // The keys were recovered ahead of time without a canonicality requirement
+            for( const auto& sig : trx.signatures )
+               FC_ASSERT( fc::ecc::public_key::is_canonical( sig, canon_type ), "signature is not canonical" );
+
+            verify( **recovered_keys );
+         }
+         else
+         {
+            util::block_flat_set< public_key_type > signature_keys( _block_arena );
+            protocol::get_signature_keys( trx, chain_id, canon_type, signature_keys );
+            verify( signature_keys );
+         }
       }
       catch( protocol::tx_missing_active_auth& e )
       {
@@ -3413,8 +3865,19 @@ void database::_apply_transaction(const signed_transaction& trx)
       create<transaction_object>([&](transaction_object& transaction) {
          transaction.trx_id = trx_id;
          transaction.expiration = trx.expiration;
-         fc::raw::pack_to_buffer( transaction.packed_trx, trx );
+         if( prevalidated != nullptr )
+         {
+            const auto& packed = prevalidated->packed_transactions[ _current_trx_in_block ];
+            const char* packed_begin = prevalidated->packed_block->data() + packed.first;
+            transaction.packed_trx.assign( packed_begin, packed_begin + packed.second );
+         }
+         else
+         {
+            fc::raw::pack_to_buffer( transaction.packed_trx, trx );
+         }
       });
+
+      schedule_expiration( expired_transactions, trx.expiration );
    }
 
    notify_pre_apply_transaction( note );
@@ -3466,7 +3929,7 @@ struct action_equal_visitor
    }
 };
 
-void database::process_required_actions( const required_automated_actions& actions )
+void database::process_required_actions( const util::block_vector< const required_automated_action* >& actions )
 {
    const auto& pending_action_idx = get_index< pending_required_action_index, by_execution >();
    auto actions_itr = actions.begin();
@@ -3497,13 +3960,13 @@ void database::process_required_actions( const required_automated_actions& actio
          "Block included required action that does not exist in queue" );
 
       action_equal_visitor equal_visitor( pending_itr->action );
-      FC_ASSERT( actions_itr->visit( equal_visitor ),
+      FC_ASSERT( (*actions_itr)->visit( equal_visitor ),
          "Unexpected action included. Expected: ${e} Observed: ${o}",
-         ("e", pending_itr->action)("o", *actions_itr) );
+         ("e", pending_itr->action)("o", **actions_itr) );
 
-      apply_required_action( *actions_itr );
+      apply_required_action( **actions_itr );
 
-      total_actions_size += fc::raw::pack_size( *actions_itr );
+      total_actions_size += fc::raw::pack_size( **actions_itr );
 
       remove( *pending_itr );
       ++actions_itr;
@@ -3526,7 +3989,7 @@ void database::apply_required_action( const required_automated_action& a )
    notify_post_apply_required_action( note );
 }
 
-void database::process_optional_actions( const optional_automated_actions& actions )
+void database::process_optional_actions( const util::block_vector< const optional_automated_action* >& actions )
 {
    if( !has_hardfork( freezone_SST_HARDFORK ) ) return;
 
@@ -3534,13 +3997,13 @@ void database::process_optional_actions( const optional_automated_actions& actio
 
    for( auto actions_itr = actions.begin(); actions_itr != actions.end(); ++actions_itr )
    {
-      actions_itr->visit( validate_visitor );
+      (*actions_itr)->visit( validate_visitor );
 
       // There is no execution check because we don't have a good way of indexing into local
       // optional actions from those contained in a block. It is the responsibility of the
       // action evaluator to prevent early execution.
-      apply_optional_action( *actions_itr );
-      auto action_itr = find< pending_optional_action_object, by_hash >( fc::sha256::hash( *actions_itr ) );
+      apply_optional_action( **actions_itr );
+      auto action_itr = find< pending_optional_action_object, by_hash >( fc::sha256::hash( **actions_itr ) );
       if( action_itr != nullptr ) remove( *action_itr );
    }
 
@@ -3665,6 +4128,33 @@ boost::signals2::connection database::any_apply_operation_handler_impl( const ap
       return _post_apply_operation_signal.connect(group, complex_func);
 }
 
+template< bool IS_PRE_OPERATION >
+void database::notify_operation_subscribers( const operation_handler_table& handlers, const operation_notification& note )
+{
+   for( const auto* subscriber : handlers.subscribers( note.op ) )
+   {
+      if( !subscriber->connected )
+         continue;
+
+      if( BOOST_UNLIKELY( _benchmark_dumper.is_enabled() ) )
+      {
+         std::string name;
+         if( _my->_evaluator_registry.is_evaluator( note.op ) )
+            name = _benchmark_dumper.generate_desc< IS_PRE_OPERATION >( subscriber->plugin_name, _my->_evaluator_registry.get_evaluator( note.op ).get_name( note.op ) );
+         else
+            name = util::advanced_benchmark_dumper::get_virtual_operation_name();
+
+         _benchmark_dumper.begin();
+         subscriber->handler( note );
+         _benchmark_dumper.end( name );
+      }
+      else
+      {
+         subscriber->handler( note );
+      }
+   }
+}
+
 boost::signals2::connection database::add_pre_apply_required_action_handler( const apply_required_action_handler_t& func,
    const abstract_plugin& plugin, int32_t group )
 {
@@ -3761,15 +4251,23 @@ boost::signals2::connection database::add_generate_optional_actions_handler(cons
    return connect_impl(_generate_optional_actions_signal, func, plugin, group, "->generate_optional_actions");
 }
 
-const witness_object& database::validate_block_header( uint32_t skip, const signed_block& next_block )const
+const witness_object& database::validate_block_header( uint32_t skip, const signed_block& next_block, const prevalidated_block* prevalidated )const
 { try {
    FC_ASSERT( head_block_id() == next_block.previous, "", ("head_block_id",head_block_id())("next.prev",next_block.previous) );
    FC_ASSERT( head_block_time() < next_block.timestamp, "", ("head_block_time",head_block_time())("next",next_block.timestamp)("blocknum",next_block.block_num()) );
    const witness_object& witness = get_witness( next_block.witness );
 
    if( !(skip&skip_witness_signature) )
-      FC_ASSERT( next_block.validate_signee( witness.signing_key,
-         has_hardfork( freezone_HARDFORK_0_20__1944 ) ? fc::ecc::bip_0062 : fc::ecc::fc_canonical ) );
+   {
+      auto canon_type = has_hardfork( freezone_HARDFORK_0_20__1944 ) ? fc::ecc::bip_0062 : fc::ecc::fc_canonical;
+
+      // The prevalidated signee was recovered without a canonicality requirement
+      if( prevalidated != nullptr && prevalidated->signee.valid() )
+         FC_ASSERT( fc::ecc::public_key::is_canonical( next_block.witness_signature, canon_type )
+            && *prevalidated->signee == witness.signing_key );
+      else
+         FC_ASSERT( next_block.validate_signee( witness.signing_key, canon_type ) );
+   }
 
    if( !(skip&skip_witness_schedule_check) )
    {
@@ -3953,6 +4451,9 @@ void database::update_last_irreversible_block()
    {
       notify_irreversible_block( i );
    }
+
+   if( dpo.last_irreversible_block_num > old_last_irreversible )
+      prune_recent_comment_bodies( dpo.last_irreversible_block_num );
 } FC_CAPTURE_AND_RETHROW() }
 
 void database::migrate_irreversible_state()
@@ -3994,7 +4495,11 @@ void database::migrate_irreversible_state()
 
             for( auto block_itr = blocks_to_write.begin(); block_itr != blocks_to_write.end(); ++block_itr )
             {
-               _block_log.append( block_itr->get()->data );
+               const auto& item = *block_itr;
+               if( item->packed_data )
+                  _block_log.append( item->data, *item->packed_data );
+               else
+                  _block_log.append( item->data );
             }
 
             _block_log.flush();
@@ -4203,26 +4708,69 @@ void database::cancel_order( const limit_order_object& order )
 }
 
 
+bool database::is_expiration_due( expiration_subsystem subsystem )const
+{
+   return head_block_time() >= get_expiration_agenda().next_due[ subsystem ];
+}
+
+void database::schedule_expiration( expiration_subsystem subsystem, const time_point_sec& due )
+{
+   const auto& agenda = get_expiration_agenda();
+   if( due < agenda.next_due[ subsystem ] )
+   {
+      modify( agenda, [&]( expiration_agenda_object& a )
+      {
+         a.next_due[ subsystem ] = due;
+      });
+   }
+}
+
+void database::reschedule_expiration( expiration_subsystem subsystem, const time_point_sec& next_due )
+{
+   const auto& agenda = get_expiration_agenda();
+   if( next_due != agenda.next_due[ subsystem ] )
+   {
+      modify( agenda, [&]( expiration_agenda_object& a )
+      {
+         a.next_due[ subsystem ] = next_due;
+      });
+   }
+}
+
 void database::clear_expired_transactions()
 {
+   if( !is_expiration_due( expired_transactions ) )
+      return;
+
    //Look for expired transactions in the deduplication list, and remove them.
    //Transactions must have expired by at least two forking windows in order to be removed.
    auto& transaction_idx = get_index< transaction_index >();
    const auto& dedupe_index = transaction_idx.indices().get< by_expiration >();
    while( ( !dedupe_index.empty() ) && ( head_block_time() > dedupe_index.begin()->expiration ) )
+   {
+      ++_expiration_counts[ expired_transactions ];
       remove( *dedupe_index.begin() );
+   }
+
+   reschedule_expiration( expired_transactions, dedupe_index.empty() ? fc::time_point_sec::maximum() : dedupe_index.begin()->expiration );
 }
 
 void database::clear_expired_orders()
 {
+   if( !is_expiration_due( expired_limit_orders ) )
+      return;
+
    auto now = head_block_time();
    const auto& orders_by_exp = get_index<limit_order_index>().indices().get<by_expiration>();
    auto itr = orders_by_exp.begin();
    while( itr != orders_by_exp.end() && itr->expiration < now )
    {
+      ++_expiration_counts[ expired_limit_orders ];
       cancel_order( *itr );
       itr = orders_by_exp.begin();
    }
+
+   reschedule_expiration( expired_limit_orders, itr != orders_by_exp.end() ? itr->expiration : fc::time_point_sec::maximum() );
 }
 
 template< class AccountType >
@@ -4251,12 +4799,16 @@ void generic_clear_expired_delegations(
 
 void database::clear_expired_delegations()
 {
+   if( !is_expiration_due( expired_delegations ) )
+      return;
+
    auto now = head_block_time();
    const auto& delegations_by_exp = get_index< vesting_delegation_expiration_index, by_expiration >();
    auto itr = delegations_by_exp.begin();
 
    while( itr != delegations_by_exp.end() && itr->expiration < now )
    {
+      ++_expiration_counts[ expired_delegations ];
       operation vop = return_vesting_delegation_operation( itr->delegator, itr->vesting_shares );
       try{
       pre_push_virtual_operation( vop );
@@ -4278,6 +4830,8 @@ void database::clear_expired_delegations()
       remove( *itr );
       itr = delegations_by_exp.begin();
    } FC_CAPTURE_AND_RETHROW( (vop) ) }
+
+   reschedule_expiration( expired_delegations, itr != delegations_by_exp.end() ? itr->expiration : fc::time_point_sec::maximum() );
 }
 
 template< typename SST_balance_object_type, class balance_operator_type >
@@ -5436,6 +5990,72 @@ void database::validate_invariants()const
 
       int64_t max_vote_denom = gpo.target_votes_per_period * freezone_VOTING_MANA_REGENERATION_SECONDS;
       FC_ASSERT( max_vote_denom > 0, "target_votes_per_period overflowed" );
+
+      /// verify the running votes of proposals against a recount of their votes
+      std::map< proposal_id_type, uint64_t > proposal_votes;
+      const auto& proposal_vote_idx = get_index< proposal_vote_index, by_id >();
+
+      for( auto itr = proposal_vote_idx.begin(); itr != proposal_vote_idx.end(); ++itr )
+      {
+         const auto& voter = get_account( itr->voter );
+         if( voter.proxy == freezone_PROXY_TO_SELF_ACCOUNT )
+            proposal_votes[ itr->proposal_id ] += voter.witness_vote_weight().value;
+      }
+
+      const auto& proposal_idx = get_index< proposal_index, by_id >();
+
+      for( auto itr = proposal_idx.begin(); itr != proposal_idx.end(); ++itr )
+      {
+         /// the votes of expired proposals may already be partially removed
+         if( itr->end_date < head_block_time() )
+            continue;
+
+         uint64_t recount = proposal_votes[ itr->proposal_id ];
+         FC_ASSERT( itr->running_votes == recount, "", ("proposal",itr->proposal_id)("running_votes",itr->running_votes)("recount",recount) );
+      }
+
+      /// verify no expiration subsystem is scheduled after its earliest object
+      fc::array< time_point_sec, expiration_subsystem_count > earliest_due;
+      for( auto& due : earliest_due )
+         due = fc::time_point_sec::maximum();
+
+      auto earliest = [&]( expiration_subsystem subsystem, const time_point_sec& due )
+      {
+         earliest_due[ subsystem ] = std::min( earliest_due[ subsystem ], due );
+      };
+
+      const auto& trx_idx = get_index< transaction_index, by_expiration >();
+      if( trx_idx.begin() != trx_idx.end() ) earliest( expired_transactions, trx_idx.begin()->expiration );
+      const auto& order_idx = get_index< limit_order_index, by_expiration >();
+      if( order_idx.begin() != order_idx.end() ) earliest( expired_limit_orders, order_idx.begin()->expiration );
+      const auto& delegation_idx = get_index< vesting_delegation_expiration_index, by_expiration >();
+      if( delegation_idx.begin() != delegation_idx.end() ) earliest( expired_delegations, delegation_idx.begin()->expiration );
+      const auto& convert_idx = get_index< convert_request_index, by_conversion_date >();
+      if( convert_idx.begin() != convert_idx.end() ) earliest( matured_conversions, convert_idx.begin()->conversion_date );
+      const auto& withdraw_idx = get_index< account_index, by_next_vesting_withdrawal >();
+      if( withdraw_idx.begin() != withdraw_idx.end() ) earliest( matured_vesting_withdrawals, withdraw_idx.begin()->next_vesting_withdrawal );
+      const auto& SST_withdraw_idx = get_index< account_regular_balance_index, by_next_vesting_withdrawal >();
+      if( SST_withdraw_idx.begin() != SST_withdraw_idx.end() ) earliest( matured_vesting_withdrawals, SST_withdraw_idx.begin()->next_vesting_withdrawal );
+      const auto& savings_idx = get_index< savings_withdraw_index, by_complete_from_rid >();
+      if( savings_idx.begin() != savings_idx.end() ) earliest( matured_savings_withdraws, savings_idx.begin()->complete );
+      const auto& recovery_idx = get_index< account_recovery_request_index, by_expiration >();
+      if( recovery_idx.begin() != recovery_idx.end() ) earliest( expired_recovery_requests, recovery_idx.begin()->expires );
+      const auto& history_idx = get_index< owner_authority_history_index, by_id >();
+      if( history_idx.begin() != history_idx.end() ) earliest( expired_owner_authority_history, time_point_sec( history_idx.begin()->last_valid_time + freezone_OWNER_AUTH_RECOVERY_PERIOD ) );
+      const auto& change_recovery_idx = get_index< change_recovery_account_request_index, by_effective_date >();
+      if( change_recovery_idx.begin() != change_recovery_idx.end() ) earliest( matured_change_recovery_requests, change_recovery_idx.begin()->effective_on );
+      const auto& ratification_idx = get_index< escrow_index, by_ratification_deadline >();
+      auto escrow_itr = ratification_idx.lower_bound( false );
+      if( escrow_itr != ratification_idx.end() && !escrow_itr->is_approved() ) earliest( expired_escrow_ratifications, escrow_itr->ratification_deadline );
+      const auto& decline_idx = get_index< decline_voting_rights_request_index, by_effective_date >();
+      if( decline_idx.begin() != decline_idx.end() ) earliest( matured_decline_voting_rights, decline_idx.begin()->effective_date );
+
+      const auto& agenda = get_expiration_agenda();
+      for( int i = 0; i < expiration_subsystem_count; ++i )
+      {
+         FC_ASSERT( agenda.next_due[ i ] <= earliest_due[ i ], "Expiration subsystem is scheduled after its earliest object",
+            ("subsystem", expiration_subsystem( i ))("next_due", agenda.next_due[ i ])("earliest_due", earliest_due[ i ]) );
+      }
    }
    FC_CAPTURE_LOG_AND_RETHROW( (head_block_num()) );
 }
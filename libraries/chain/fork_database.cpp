@@ -32,9 +32,9 @@ void     fork_database::start_block(signed_block b)
  * Pushes the block into the fork database and caches it if it doesn't link
  *
  */
-shared_ptr<fork_item>  fork_database::push_block(const signed_block& b)
+shared_ptr<fork_item>  fork_database::push_block(const signed_block& b, shared_ptr< const std::vector< char > > packed)
 {
-   auto item = std::make_shared<fork_item>(b);
+   auto item = std::make_shared<fork_item>(b, std::move(packed));
    try {
       _push_block(item);
    }
@@ -0,0 +1,56 @@
+#pragma once
+#include <fc/filesystem.hpp>
+
+#include <memory>
+#include <string>
+
+namespace freezone { namespace chain {
+
+   namespace detail { class blob_store_impl; }
+
+   /* The blob store is an append only, memory mapped file holding large values that should not live
+    * in shared memory. Objects in shared memory reference a blob by its offset and size, which never
+    * change once written. Because blobs are never modified or freed, undoing a change to an object
+    * restores a reference to a blob that still exists, and blobs written by undone changes are simply
+    * never referenced again.
+    *
+    * +--------+--------+--------+-----+--------+-----------------------------+
+    * | Header | Blob 1 | Blob 2 | ... | Blob N | Unused (preallocated) space |
+    * +--------+--------+--------+-----+--------+-----------------------------+
+    *
+    * The header holds the offset of the end of the last blob. The file is grown geometrically and
+    * remapped as blobs are appended.
+    *
+    * Recently read blobs are kept in an LRU cache so that hot values do not have to be copied out
+    * of the mapping on every read. Reads are thread safe. Appends must be serialized by the caller,
+    * but may run concurrently with reads.
+    */
+   class blob_store
+   {
+      public:
+         blob_store();
+         ~blob_store();
+
+         void open( const fc::path& file );
+         void close();
+         bool is_open()const;
+         void flush();
+
+         /// Maximum total size of cached blobs, in bytes. 0 disables caching.
+         void set_cache_size( uint64_t bytes );
+
+         /// Append a blob and return its offset.
+         uint64_t append( const std::string& data );
+         std::string read( uint64_t offset, uint32_t size )const;
+
+         /// Offset one past the end of the last blob
+         uint64_t size()const;
+
+         /// True when no blob has been appended, or the store is not open
+         bool empty()const;
+
+      private:
+         std::unique_ptr< detail::blob_store_impl > my;
+   };
+
+} }
@@ -43,6 +43,8 @@ namespace freezone { namespace chain {
          bool is_open()const;
 
          uint64_t append( const signed_block& b );
+         /// Appends a block that has already been serialized. data must be the packed block.
+         uint64_t append( const signed_block& b, const std::vector< char >& data );
          void flush();
          std::pair< signed_block, uint64_t > read_block( uint64_t file_pos )const;
          optional< signed_block > read_block_by_num( uint32_t block_num )const;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <freezone/protocol/block.hpp>
+
+#include <memory>
+
+namespace freezone { namespace chain {
+
+using freezone::protocol::block_id_type;
+using freezone::protocol::checksum_type;
+using freezone::protocol::digest_type;
+using freezone::protocol::public_key_type;
+using freezone::protocol::signed_block;
+using freezone::protocol::chain_id_type;
+using freezone::protocol::transaction_id_type;
+
+/**
+ * The results of the checks on a block that do not depend on chain state: merkle root,
+ * serialized size, witness signature recovery and transaction signature recovery.
+ *
+ * These are computed off the write thread so that, while syncing, the write thread only
+ * has to apply blocks. Signatures are recovered without a canonicality requirement because
+ * the required canonicality depends on hardfork state; the database checks canonicality of
+ * the signatures before using any recovered key.
+ *
+ * The block is serialized once, and the digests, ids and sizes are all computed from those
+ * bytes. The bytes are kept so that the database can store transactions and write the block
+ * log without packing them again.
+ *
+ * Results are only valid for the exact block contents they were computed from. Callers keep
+ * them with the block instance they were computed for rather than matching them by contents.
+ */
+struct prevalidated_block
+{
+   block_id_type                                            block_id;
+   uint32_t                                                 block_size = 0;
+   checksum_type                                            merkle_root;
+   fc::optional< public_key_type >                          signee;
+
+   /// Recovered signature keys by transaction index. Empty when recovery was not requested.
+   /// An individual entry is empty when recovery failed and must be repeated by the database.
+   vector< fc::optional< flat_set< public_key_type > > >    signature_keys;
+
+   /// The serialized block. Shared with the fork database until the block is written to the block log.
+   std::shared_ptr< const std::vector< char > >             packed_block;
+
+   /// Offset and size of each serialized transaction within packed_block, by transaction index
+   vector< std::pair< uint32_t, uint32_t > >                packed_transactions;
+
+   /// Transaction ids by transaction index
+   vector< transaction_id_type >                            transaction_ids;
+};
+
+/**
+ * Perform all of the state independent checks for a block. This function is thread safe and
+ * does not throw; any check that fails is left empty and performed again by the database.
+ *
+ * The transaction signatures are recovered together, with the help of up to signature_helpers tasks
+ * posted with post, see fc::ecc::public_key::recover_many. post may use the pool running this call.
+ */
+prevalidated_block prevalidate_block( const signed_block& block, const chain_id_type& chain_id, bool recover_transaction_signatures,
+   const fc::ecc::public_key::task_poster& post = fc::ecc::public_key::task_poster(), uint32_t signature_helpers = 0 );
+
+} } // freezone::chain
@@ -7,6 +7,7 @@
 #include <freezone/chain/freezone_object_types.hpp>
 #include <freezone/chain/witness_objects.hpp>
 
+#include <fc/crypto/city.hpp>
 
 namespace freezone { namespace chain {
 
@@ -41,6 +42,28 @@ namespace freezone { namespace chain {
          }
    };
 
+   /**
+    * Fixed size key for a permlink. Comments are looked up by (author, permlink_hash) so that the
+    * consensus path compares integers instead of strings. Hashes may collide, so a lookup must always
+    * compare the full permlink of each candidate, see database::find_comment().
+    */
+   inline uint64_t hash_permlink( const char* permlink, size_t size )
+   {
+      return fc::city_hash64( permlink, size );
+   }
+
+   inline uint64_t hash_permlink( const string& permlink )
+   {
+      return hash_permlink( permlink.c_str(), permlink.size() );
+   }
+
+#ifndef ENABLE_MIRA
+   inline uint64_t hash_permlink( const shared_string& permlink )
+   {
+      return hash_permlink( permlink.c_str(), permlink.size() );
+   }
+#endif
+
    struct rshare_context
    {
       share_type        net_rshares; // reward is proportional to rshares^2, this is the sum of all votes (positive and negative)
@@ -83,6 +106,7 @@ namespace freezone { namespace chain {
          shared_string     parent_permlink;
          account_name_type author;
          shared_string     permlink;
+         uint64_t          permlink_hash = 0; ///< hash_permlink( permlink ), key of by_permlink_hash
 
          time_point_sec    last_update;
          time_point_sec    created;
@@ -149,8 +173,12 @@ namespace freezone { namespace chain {
          comment_id_type   comment;
 
          shared_string     title;
-         shared_string     body;
+         shared_string     body;             ///< Empty when the body is kept in the comment body store
          shared_string     json_metadata;
+
+         /// Location of the body in the comment body store, see database::get_comment_body()
+         uint64_t          body_blob_offset = 0;
+         uint32_t          body_blob_size = 0;
    };
 
    class comment_SST_beneficiaries_object : public object< comment_SST_beneficiaries_object_type, comment_SST_beneficiaries_object >
@@ -244,6 +272,7 @@ namespace freezone { namespace chain {
 
    struct by_cashout_time; /// cashout_time
    struct by_permlink; /// author, perm
+   struct by_permlink_hash; /// author, hash( perm )
    struct by_root;
    struct by_parent;
    struct by_last_update; /// parent_auth, last_update
@@ -263,13 +292,20 @@ namespace freezone { namespace chain {
                member< comment_object, comment_id_type, &comment_object::id >
             >
          >,
-         ordered_unique< tag< by_permlink >, /// used by consensus to find posts referenced in ops
+         ordered_unique< tag< by_permlink >, /// used to order posts by permlink
             composite_key< comment_object,
                member< comment_object, account_name_type, &comment_object::author >,
                member< comment_object, shared_string, &comment_object::permlink >
             >,
             composite_key_compare< std::less< account_name_type >, strcmp_less >
          >,
+         ordered_unique< tag< by_permlink_hash >, /// used by consensus to find posts referenced in ops
+            composite_key< comment_object,
+               member< comment_object, account_name_type, &comment_object::author >,
+               member< comment_object, uint64_t, &comment_object::permlink_hash >,
+               member< comment_object, comment_id_type, &comment_object::id >
+            >
+         >,
          ordered_unique< tag< by_root >,
             composite_key< comment_object,
                member< comment_object, comment_id_type, &comment_object::root_comment >,
@@ -354,7 +390,7 @@ FC_REFLECT( freezone::chain::comment_votable_asset_options,
           )
 
 FC_REFLECT( freezone::chain::comment_object,
-             (id)(author)(permlink)
+             (id)(author)(permlink)(permlink_hash)
              (category)(parent_author)(parent_permlink)
              (last_update)(created)(active)(last_payout)
              (depth)(children)
@@ -369,7 +405,7 @@ FC_REFLECT( freezone::chain::comment_object,
 CHAINBASE_SET_INDEX_TYPE( freezone::chain::comment_object, freezone::chain::comment_index )
 
 FC_REFLECT( freezone::chain::comment_content_object,
-            (id)(comment)(title)(body)(json_metadata) )
+            (id)(comment)(title)(body)(json_metadata)(body_blob_offset)(body_blob_size) )
 CHAINBASE_SET_INDEX_TYPE( freezone::chain::comment_content_object, freezone::chain::comment_content_index )
 
 FC_REFLECT( freezone::chain::comment_vote_object,
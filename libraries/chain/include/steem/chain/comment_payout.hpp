@@ -0,0 +1,32 @@
+#pragma once
+
+#include <freezone/chain/freezone_object_types.hpp>
+
+namespace freezone { namespace chain {
+
+struct curation_payout
+{
+   account_id_type   voter;
+   share_type        claim = 0;
+};
+
+/**
+ * The amounts paid out for a comment. These only depend on the comment, its votes and the state of the
+ * reward funds snapshotted before the first payout of a block, so the payouts of all comments due in a
+ * block can be computed concurrently. They are then applied one comment at a time, in cashout order,
+ * because vesting the rewards changes the vesting share price for every later payout.
+ */
+struct comment_payout
+{
+   comment_id_type            comment;
+   share_type                 reward_tokens = 0;
+   share_type                 author_tokens = 0;         ///< Before beneficiaries and the curation remainder
+   share_type                 curation_tokens = 0;       ///< Claimed by curators
+   share_type                 curation_remainder = 0;    ///< Curation tokens that were not claimed
+   vector< curation_payout >  curators;                  ///< In the order they are paid
+};
+
+} } // freezone::chain
+
+FC_REFLECT( freezone::chain::curation_payout, (voter)(claim) )
+FC_REFLECT( freezone::chain::comment_payout, (comment)(reward_tokens)(author_tokens)(curation_tokens)(curation_remainder)(curators) )
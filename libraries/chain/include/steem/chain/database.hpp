@@ -2,15 +2,22 @@
  * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
  */
 #pragma once
+#include <freezone/chain/blob_store.hpp>
 #include <freezone/chain/block_log.hpp>
+#include <freezone/chain/block_prevalidation.hpp>
+#include <freezone/chain/comment_payout.hpp>
+#include <freezone/chain/expiration_agenda_object.hpp>
 #include <freezone/chain/fork_database.hpp>
 #include <freezone/chain/global_property_object.hpp>
 #include <freezone/chain/hardfork_property_object.hpp>
 #include <freezone/chain/node_property_object.hpp>
 #include <freezone/chain/notifications.hpp>
+#include <freezone/chain/operation_subscriptions.hpp>
 
 #include <freezone/chain/util/advanced_benchmark_dumper.hpp>
+#include <freezone/chain/util/block_arena.hpp>
 #include <freezone/chain/util/signal.hpp>
+#include <freezone/chain/util/worker_pool.hpp>
 
 #include <freezone/protocol/protocol.hpp>
 #include <freezone/protocol/hardfork.hpp>
@@ -23,6 +30,7 @@
 
 #include <functional>
 #include <map>
+#include <unordered_map>
 
 namespace freezone { namespace chain {
 
@@ -129,6 +137,11 @@ namespace freezone { namespace chain {
             fc::variant database_cfg;
             bool replay_in_memory = false;
             std::vector< std::string > replay_memory_indices{};
+            bool comment_body_store = false;
+            bool compact_comment_body_store = false;
+            uint64_t comment_body_cache_size = 0;
+            uint32_t comment_payout_threads = 0;
+            uint32_t signature_recovery_threads = 1;
 
             std::shared_ptr< std::function< void( database&, const open_args& ) > > genesis_func;
 
@@ -206,14 +219,27 @@ namespace freezone { namespace chain {
          const account_object&  get_account(  const account_name_type& name )const;
          const account_object*  find_account( const account_name_type& name )const;
 
+         /// Comments are found through by_permlink_hash, comparing the full permlink of each candidate
          const comment_object&  get_comment(  const account_name_type& author, const shared_string& permlink )const;
          const comment_object*  find_comment( const account_name_type& author, const shared_string& permlink )const;
+         const comment_object*  find_comment( const account_name_type& author, const char* permlink, size_t size )const;
 
 #ifndef ENABLE_MIRA
          const comment_object&  get_comment(  const account_name_type& author, const string& permlink )const;
          const comment_object*  find_comment( const account_name_type& author, const string& permlink )const;
 #endif
 
+         /**
+          * Comment bodies are kept in shared memory, or in the comment body store outside of it when
+          * open_args::comment_body_store is set. Bodies are always read through these so that both can
+          * be mixed. set_comment_body() must be called from within create() or modify() of the content.
+          */
+         std::string get_comment_body( const comment_content_object& content )const;
+         void        set_comment_body( comment_content_object& content, const std::string& body );
+
+         /// True when some comment bodies are kept in the comment body store, which state files do not carry
+         bool        has_comment_body_store_bodies()const;
+
          const escrow_object&   get_escrow(  const account_name_type& name, uint32_t escrow_id )const;
          const escrow_object*   find_escrow( const account_name_type& name, uint32_t escrow_id )const;
 
@@ -228,6 +254,7 @@ namespace freezone { namespace chain {
          const feed_history_object&             get_feed_history()const;
          const witness_schedule_object&         get_witness_schedule_object()const;
          const hardfork_property_object&        get_hardfork_property_object()const;
+         const expiration_agenda_object&        get_expiration_agenda()const;
 
          const time_point_sec                   calculate_discussion_payout_time( const comment_object& comment )const;
          const reward_fund_object&              get_reward_fund( const comment_object& c )const;
@@ -246,7 +273,11 @@ namespace freezone { namespace chain {
          const flat_map<uint32_t,block_id_type> get_checkpoints()const { return _checkpoints; }
          bool                                   before_last_checkpoint()const;
 
-         bool push_block( const signed_block& b, uint32_t skip = skip_nothing );
+         /**
+          * @param prevalidated Optional results of the state independent checks on the block, see
+          *        prevalidate_block(). They are only used if they were computed for this block.
+          */
+         bool push_block( const signed_block& b, uint32_t skip = skip_nothing, const prevalidated_block* prevalidated = nullptr );
          void push_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
          void _maybe_warn_multiple_production( uint32_t height )const;
          bool _push_block( const signed_block& b );
@@ -311,6 +342,9 @@ namespace freezone { namespace chain {
          boost::signals2::connection any_apply_operation_handler_impl( const apply_operation_handler_t& func,
             const abstract_plugin& plugin, int32_t group );
 
+         template< bool IS_PRE_OPERATION >
+         void notify_operation_subscribers( const operation_handler_table& handlers, const operation_notification& note );
+
       public:
 
          boost::signals2::connection add_pre_apply_required_action_handler  ( const apply_required_action_handler_t&     func, const abstract_plugin& plugin, int32_t group = -1 );
@@ -330,6 +364,23 @@ namespace freezone { namespace chain {
          boost::signals2::connection add_post_reindex_handler               ( const reindex_handler_t&                   func, const abstract_plugin& plugin, int32_t group = -1 );
          boost::signals2::connection add_generate_optional_actions_handler  ( const generate_optional_actions_handler_t& func, const abstract_plugin& plugin, int32_t group = -1 );
 
+         /**
+          * Adds an operation handler that is only called for operations of the listed types, so plugins
+          * that act on a few operation types are not called for every operation. These handlers are
+          * called after the ones added with add_pre_apply_operation_handler/add_post_apply_operation_handler.
+          */
+         template< typename... Operations >
+         operation_subscription subscribe_pre_apply_operation( const apply_operation_handler_t& func, const abstract_plugin& plugin, int32_t group = -1 )
+         {
+            return _pre_apply_operation_handlers.subscribe( func, { operation::tag< Operations >::value... }, plugin.get_name(), group );
+         }
+
+         template< typename... Operations >
+         operation_subscription subscribe_post_apply_operation( const apply_operation_handler_t& func, const abstract_plugin& plugin, int32_t group = -1 )
+         {
+            return _post_apply_operation_handlers.subscribe( func, { operation::tag< Operations >::value... }, plugin.get_name(), group );
+         }
+
          //////////////////// db_witness_schedule.cpp ////////////////////
 
          /**
@@ -385,6 +436,13 @@ namespace freezone { namespace chain {
          void        adjust_rshares2( const comment_object& comment, fc::uint128_t old_rshares2, fc::uint128_t new_rshares2 );
          void        update_owner_authority( const account_object& account, const authority& owner_authority );
 
+         /** this must be called whenever an object processed by an expiration subsystem is created or
+          *  becomes due earlier, so that the subsystem runs no later than due */
+         void        schedule_expiration( expiration_subsystem subsystem, const time_point_sec& due );
+
+         /// The number of objects each expiration subsystem processed in the last applied block
+         const expiration_counts& get_expiration_counts()const { return _expiration_counts; }
+
          asset       get_balance( const account_object& a, asset_symbol_type symbol )const;
          asset       get_savings_balance( const account_object& a, asset_symbol_type symbol )const;
          asset       get_balance( const account_name_type& aname, asset_symbol_type symbol )const;
@@ -400,6 +458,9 @@ namespace freezone { namespace chain {
          /** this is called by `adjust_proxied_witness_votes` when account proxy to self */
          void adjust_witness_votes( const account_object& a, share_type delta );
 
+         /** this updates the running votes of all proposals approved by an account whose governance vesting changed */
+         void adjust_proposal_votes( const account_object& a, share_type delta );
+
          /** this updates the vote of a single witness as a result of a vote being added or removed*/
          void adjust_witness_vote( const witness_object& obj, share_type delta );
 
@@ -409,8 +470,19 @@ namespace freezone { namespace chain {
           */
          void clear_witness_votes( const account_object& a );
          void process_vesting_withdrawals();
-         share_type pay_curators( const comment_object& c, share_type& max_rewards );
+         share_type pay_curators( const comment_object& c, const comment_payout& payout );
          share_type cashout_comment_helper( util::comment_reward_context& ctx, const comment_object& comment, const price& current_freezone_price, bool forward_curation_remainder = true );
+         share_type cashout_comment_helper( const comment_object& comment, const comment_payout& payout, bool forward_curation_remainder = true );
+
+         /// Computes the payout of a comment without modifying any state
+         comment_payout compute_comment_payout( util::comment_reward_context ctx, const comment_object& comment, const price& current_freezone_price )const;
+
+         /**
+          * Computes the payouts of comments using up to the configured number of comment payout threads.
+          * contexts holds the reward context of each comment. Payouts are returned in the order of comments.
+          */
+         util::block_vector< comment_payout > compute_comment_payouts( const util::block_vector< const comment_object* >& comments,
+            const util::block_vector< util::comment_reward_context >& contexts, const price& current_freezone_price )const;
          void process_comment_cashout();
          void process_funds();
          void process_conversions();
@@ -532,18 +604,21 @@ namespace freezone { namespace chain {
       private:
          optional< chainbase::database::session > _pending_tx_session;
 
+         void compact_comment_body_store( const fc::path& file );
+         void prune_recent_comment_bodies( uint32_t last_irreversible_block_num );
+
          void apply_block( const signed_block& next_block, uint32_t skip = skip_nothing );
          void _apply_block( const signed_block& next_block );
          void _apply_transaction( const signed_transaction& trx );
          void apply_operation( const operation& op );
 
-         void process_required_actions( const required_automated_actions& actions );
-         void process_optional_actions( const optional_automated_actions& actions );
+         void process_required_actions( const util::block_vector< const required_automated_action* >& actions );
+         void process_optional_actions( const util::block_vector< const optional_automated_action* >& actions );
 
          ///Steps involved in applying a new block
          ///@{
 
-         const witness_object& validate_block_header( uint32_t skip, const signed_block& next_block )const;
+         const witness_object& validate_block_header( uint32_t skip, const signed_block& next_block, const prevalidated_block* prevalidated = nullptr )const;
          void create_block_summary(const signed_block& next_block);
 
          void clear_null_account_balance();
@@ -553,10 +628,13 @@ namespace freezone { namespace chain {
          void update_signing_witness(const witness_object& signing_witness, const signed_block& new_block);
          void update_last_irreversible_block();
          void migrate_irreversible_state();
+         bool is_expiration_due( expiration_subsystem subsystem )const;
+         void reschedule_expiration( expiration_subsystem subsystem, const time_point_sec& next_due );
          void clear_expired_transactions();
          void clear_expired_orders();
          void clear_expired_delegations();
-         void process_header_extensions( const signed_block& next_block, required_automated_actions& req_actions, optional_automated_actions& opt_actions );
+         void process_header_extensions( const signed_block& next_block, util::block_vector< const required_automated_action* >& req_actions,
+            util::block_vector< const optional_automated_action* >& opt_actions );
 
          void generate_required_actions();
          void generate_optional_actions();
@@ -603,11 +681,50 @@ namespace freezone { namespace chain {
             _sps_remove_threshold = val;
          }
 
+         uint32_t get_comment_payout_threads() const
+         {
+            return _comment_payout_threads;
+         }
+
+         /// Number of threads computing comment payouts. 0 computes them on the calling thread.
+         void set_comment_payout_threads( uint32_t threads )
+         {
+            _comment_payout_threads = threads;
+         }
+
+         uint32_t get_signature_recovery_threads() const
+         {
+            return _signature_recovery_threads;
+         }
+
+         /// Number of threads recovering the transaction signature keys of a block that was not prevalidated.
+         void set_signature_recovery_threads( uint32_t threads )
+         {
+            _signature_recovery_threads = threads;
+            _signature_recovery_pool.reset();
+         }
+
          util::advanced_benchmark_dumper& get_benchmark_dumper()
          {
             return _benchmark_dumper;
          }
 
+         /**
+          * Arena for temporaries that do not outlive the block being applied, reset once it is applied.
+          * A transaction applied outside of a block, such as a pending one, resets it when it is done.
+          * Nothing else resets it: anything else using it outside of _apply_block, such as a test calling
+          * update_witness_schedule directly, keeps its allocations until the next block is applied.
+          */
+         util::block_arena& get_block_arena()
+         {
+            return _block_arena;
+         }
+
+         const util::block_arena& get_block_arena()const
+         {
+            return _block_arena;
+         }
+
          const hardfork_versions& get_hardfork_versions()
          {
             return _hardfork_versions;
@@ -622,6 +739,20 @@ namespace freezone { namespace chain {
 
          block_log                     _block_log;
 
+         blob_store                    _comment_body_store;
+         bool                          _comment_body_store_enabled = false;
+
+         struct recent_comment_body
+         {
+            uint64_t offset = 0;
+            uint32_t size = 0;
+            uint32_t head_block_num = 0; ///< head block when the body was appended
+         };
+
+         /// Bodies appended since the last irreversible block by hash of their contents, so that
+         /// pending transactions applied again around blocks and fork switches reuse the same blob
+         std::unordered_multimap< uint64_t, recent_comment_body > _recent_comment_bodies;
+
          // this function needs access to _plugin_index_signal
          template< typename MultiIndexType >
          friend void add_plugin_index( database& db );
@@ -636,6 +767,12 @@ namespace freezone { namespace chain {
 
          node_property_object              _node_property_object;
 
+         const prevalidated_block*     _prevalidated_block = nullptr;         ///< Passed to push_block, may be for a different block
+         const prevalidated_block*     _current_prevalidated_block = nullptr; ///< Set while applying the block it was computed for
+
+         /// Signature keys of the transactions of the block being applied, by transaction index
+         const vector< fc::optional< flat_set< public_key_type > > >* _current_signature_keys = nullptr;
+
          uint32_t                      _flush_blocks = 0;
          uint32_t                      _next_flush_block = 0;
 
@@ -644,11 +781,18 @@ namespace freezone { namespace chain {
          uint16_t                      _shared_file_full_threshold = 0;
          uint16_t                      _shared_file_scale_rate = 0;
          int16_t                       _sps_remove_threshold = -1;
+         uint32_t                      _comment_payout_threads = 0;
+         uint32_t                      _signature_recovery_threads = 1;
+         /// Helps the write thread recover signatures, started with the first block that needs it
+         std::unique_ptr< util::worker_pool > _signature_recovery_pool;
+         expiration_counts             _expiration_counts = {};
 
          flat_map< custom_id_type, std::shared_ptr< custom_operation_interpreter > >   _custom_operation_interpreters;
          std::string                   _json_schema;
 
          util::advanced_benchmark_dumper  _benchmark_dumper;
+         util::block_arena                _block_arena;
+         bool                             _applying_block = false;
          index_delegate_map            _index_delegate_map;
 
          fc::signal<void(const required_action_notification&)> _pre_apply_required_action_signal;
@@ -663,6 +807,9 @@ namespace freezone { namespace chain {
           */
          fc::signal<void(const operation_notification&)>       _post_apply_operation_signal;
 
+         operation_handler_table                                _pre_apply_operation_handlers;
+         operation_handler_table                                _post_apply_operation_handlers;
+
          fc::signal<void(const custom_operation_notification&)> _pre_apply_custom_operation_signal;
          fc::signal<void(const custom_operation_notification&)> _post_apply_custom_operation_signal;
 
@@ -0,0 +1,80 @@
+#pragma once
+#include <freezone/chain/freezone_fwd.hpp>
+
+#include <freezone/chain/freezone_object_types.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace freezone { namespace chain {
+
+   /// The subsystems that expire or mature objects by time at the end of every block
+   enum expiration_subsystem
+   {
+      expired_transactions,
+      expired_limit_orders,
+      expired_delegations,
+      matured_conversions,
+      matured_vesting_withdrawals,
+      matured_savings_withdraws,
+      expired_recovery_requests,
+      expired_owner_authority_history,
+      matured_change_recovery_requests,
+      expired_escrow_ratifications,
+      matured_decline_voting_rights,
+      expiration_subsystem_count
+   };
+
+   typedef std::array< uint32_t, expiration_subsystem_count > expiration_counts;
+
+   /**
+    *  @brief Holds the time at which each expiration subsystem next has work to do
+    *  @ingroup object
+    *
+    *  next_due is a lower bound on the due time of the earliest object of each subsystem. A subsystem
+    *  is not run while the head block time is before its entry, so a block with nothing due does not
+    *  probe any of the subsystem indexes.
+    *
+    *  Anything creating an object, or moving it to an earlier due time, must call
+    *  database::schedule_expiration. After a subsystem runs it raises its entry to the due time of
+    *  its earliest remaining object. Entries that are too early only cost an extra probe.
+    */
+   class expiration_agenda_object : public object< expiration_agenda_object_type, expiration_agenda_object >
+   {
+      public:
+         template< typename Constructor, typename Allocator >
+         expiration_agenda_object( Constructor&& c, allocator< Allocator > a )
+         {
+            c( *this );
+         }
+
+         expiration_agenda_object(){}
+
+         id_type                                                        id;
+         fc::array< time_point_sec, expiration_subsystem_count >        next_due;
+
+         time_point_sec earliest_due()const
+         {
+            return *std::min_element( next_due.begin(), next_due.end() );
+         }
+   };
+
+   typedef multi_index_container<
+      expiration_agenda_object,
+      indexed_by<
+         ordered_unique< tag< by_id >,
+            member< expiration_agenda_object, expiration_agenda_object::id_type, &expiration_agenda_object::id > >
+      >,
+      allocator< expiration_agenda_object >
+   > expiration_agenda_index;
+
+} } // freezone::chain
+
+FC_REFLECT_ENUM( freezone::chain::expiration_subsystem,
+   (expired_transactions)(expired_limit_orders)(expired_delegations)(matured_conversions)
+   (matured_vesting_withdrawals)(matured_savings_withdraws)(expired_recovery_requests)
+   (expired_owner_authority_history)(matured_change_recovery_requests)(expired_escrow_ratifications)
+   (matured_decline_voting_rights) )
+
+FC_REFLECT( freezone::chain::expiration_agenda_object, (id)(next_due) )
+CHAINBASE_SET_INDEX_TYPE( freezone::chain::expiration_agenda_object, freezone::chain::expiration_agenda_index )
@@ -17,8 +17,8 @@ namespace freezone { namespace chain {
       private:
          fork_item(){}
       public:
-         fork_item( signed_block d )
-         :num(d.block_num()),id(d.id()),data( std::move(d) ){}
+         fork_item( signed_block d, shared_ptr< const std::vector< char > > packed = shared_ptr< const std::vector< char > >() )
+         :num(d.block_num()),id(d.id()),data( std::move(d) ),packed_data( std::move(packed) ){}
 
          block_id_type previous_id()const { return data.previous; }
 
@@ -31,6 +31,9 @@ namespace freezone { namespace chain {
          bool                  invalid = false;
          block_id_type         id;
          signed_block          data;
+
+         /// The serialized block when it was available on push, so it need not be packed again for the block log
+         shared_ptr< const std::vector< char > > packed_data;
    };
    typedef shared_ptr<fork_item> item_ptr;
 
@@ -65,7 +68,7 @@ namespace freezone { namespace chain {
          /**
           *  @return the new head block ( the longest fork )
           */
-         shared_ptr<fork_item>            push_block(const signed_block& b);
+         shared_ptr<fork_item>            push_block(const signed_block& b, shared_ptr< const std::vector< char > > packed = shared_ptr< const std::vector< char > >());
          shared_ptr<fork_item>            head()const { return _head; }
          void                             pop_block();
 
@@ -24,6 +24,9 @@ struct transaction_notification
       transaction_id = tx.id();
    }
 
+   transaction_notification( const freezone::protocol::signed_transaction& tx, const freezone::protocol::transaction_id_type& id )
+      : transaction_id(id), transaction(tx) {}
+
    freezone::protocol::transaction_id_type          transaction_id;
    const freezone::protocol::signed_transaction&    transaction;
 };
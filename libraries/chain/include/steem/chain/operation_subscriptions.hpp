@@ -0,0 +1,104 @@
+#pragma once
+
+#include <freezone/chain/notifications.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace freezone { namespace chain {
+
+namespace detail {
+
+   struct operation_subscriber
+   {
+      std::function< void( const operation_notification& ) >   handler;
+      std::string                                             plugin_name;
+      int32_t                                                 group = 0;
+      std::atomic< bool >                                     connected{ true };
+   };
+
+}
+
+/**
+ * Handle to a handler subscribed to some operation types. Disconnecting stops the handler from being
+ * called. The handle may outlive the database it was subscribed to.
+ */
+class operation_subscription
+{
+   public:
+      operation_subscription() {}
+      operation_subscription( const std::shared_ptr< detail::operation_subscriber >& s ) : _subscriber( s ) {}
+
+      bool connected()const
+      {
+         auto s = _subscriber.lock();
+         return s && s->connected;
+      }
+
+      void disconnect()
+      {
+         if( auto s = _subscriber.lock() )
+            s->connected = false;
+      }
+
+   private:
+      std::weak_ptr< detail::operation_subscriber > _subscriber;
+};
+
+/**
+ * Operation handlers indexed by the tags of the operation types they handle. An operation is only passed to
+ * the handlers subscribed to its type, found by indexing a table with the operation tag. Handlers of a type
+ * are called in order of group, then of subscription.
+ *
+ * Handlers must be subscribed before operations are applied, from plugin initialization or startup.
+ * Disconnecting is allowed at any time; disconnected handlers are skipped and freed with the table.
+ */
+class operation_handler_table
+{
+   public:
+      typedef std::vector< const detail::operation_subscriber* > subscriber_list;
+
+      operation_handler_table() : _by_tag( freezone::protocol::operation::count() ) {}
+
+      operation_subscription subscribe( const std::function< void( const operation_notification& ) >& handler,
+         const std::vector< int64_t >& tags, const std::string& plugin_name, int32_t group )
+      {
+         auto subscriber = std::make_shared< detail::operation_subscriber >();
+         subscriber->handler = handler;
+         subscriber->plugin_name = plugin_name;
+         subscriber->group = group;
+
+         for( int64_t tag : tags )
+         {
+            FC_ASSERT( tag >= 0 && tag < int64_t( _by_tag.size() ), "Invalid operation tag ${t}", ("t", tag) );
+
+            auto& subscribers = _by_tag[ tag ];
+            auto pos = std::upper_bound( subscribers.begin(), subscribers.end(), group,
+               []( int32_t g, const detail::operation_subscriber* s ) { return g < s->group; } );
+
+            if( pos == subscribers.begin() || *( pos - 1 ) != subscriber.get() )
+               subscribers.insert( pos, subscriber.get() );
+         }
+
+         _subscribers.push_back( subscriber );
+         return operation_subscription( subscriber );
+      }
+
+      /// The handlers subscribed to the type of op, including any that have been disconnected
+      const subscriber_list& subscribers( const freezone::protocol::operation& op )const
+      {
+         return _by_tag[ op.which() ];
+      }
+
+   private:
+      std::vector< subscriber_list >                                    _by_tag;
+      std::vector< std::shared_ptr< detail::operation_subscriber > >    _subscribers;
+};
+
+} } // freezone::chain
@@ -0,0 +1,75 @@
+#pragma once
+#include <freezone/chain/shared_authority.hpp>
+#include <freezone/chain/util/block_arena.hpp>
+
+#include <freezone/protocol/operations.hpp>
+
+namespace freezone { namespace chain {
+
+   using freezone::protocol::operation;
+
+   typedef std::function< const shared_authority&( const account_name_type& ) > shared_authority_getter;
+
+   /**
+    *  Counterpart of protocol::sign_state that reads the authorities of accounts directly from
+    *  the shared_authority stored in the database instead of copying each of them into an authority.
+    *
+    *  Accounts whose active authority has been satisfied are remembered in approved_by, so an account
+    *  referenced by several authorities of the same transaction is only evaluated once.
+    *  The order of evaluation and the limits are the same as in protocol::sign_state.
+    *
+    *  The provided signatures and the approved accounts are kept on the arena, which must not be
+    *  reset while the state is alive.
+    */
+   class shared_sign_state
+   {
+      public:
+         template< typename KeySet >
+         shared_sign_state( const KeySet& sigs, const shared_authority_getter& get_active, util::block_arena& arena )
+            : approved_by( arena ), _get_active( get_active ), _provided_signatures( arena )
+         {
+            _provided_signatures.reserve( sigs.size() );
+            for( const auto& key : sigs )
+               _provided_signatures.emplace_hint( _provided_signatures.end(), key, false );
+            approved_by.insert( account_name_type( "temp" ) );
+         }
+
+         bool signed_by( const public_key_type& k );
+
+         /// Checks the active authority of the account
+         bool check_authority( const account_name_type& id );
+         bool check_authority( const shared_authority& auth );
+         bool check_authority( const authority& auth );
+
+         bool remove_unused_signatures();
+
+         util::block_flat_set< account_name_type >   approved_by;
+         uint32_t                                     max_recursion = freezone_MAX_SIG_CHECK_DEPTH;
+         uint32_t                                     max_membership = ~0;
+         uint32_t                                     max_account_auths = ~0;
+
+      private:
+         template< typename AuthorityType >
+         bool check_authority_impl( const AuthorityType& auth, uint32_t depth, uint32_t* account_auth_count );
+
+         const shared_authority_getter&                  _get_active;
+         util::block_flat_map< public_key_type, bool >   _provided_signatures;
+   };
+
+   /**
+    *  Same as protocol::verify_authority for the operations of a transaction, with the authorities
+    *  of accounts taken by reference from the database. The signature state is kept on the arena.
+    *
+    *  Defined for flat_set and util::block_flat_set of public_key_type.
+    */
+   template< typename KeySet >
+   void verify_shared_authority( const vector< operation >& ops, const KeySet& sigs,
+                                 const shared_authority_getter& get_active,
+                                 const shared_authority_getter& get_owner,
+                                 const shared_authority_getter& get_posting,
+                                 util::block_arena& arena,
+                                 uint32_t max_recursion_depth = freezone_MAX_SIG_CHECK_DEPTH,
+                                 uint32_t max_membership = freezone_MAX_AUTHORITY_MEMBERSHIP,
+                                 uint32_t max_account_auths = freezone_MAX_SIG_CHECK_ACCOUNTS );
+
+} } // freezone::chain
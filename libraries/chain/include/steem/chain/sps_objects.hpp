@@ -52,6 +52,9 @@ class proposal_object : public object< proposal_object_type, proposal_object >
       //This will be calculate every maintenance period
       uint64_t total_votes = 0;
 
+      //Governance vesting of the voters, kept up to date as votes and voting power change and copied to `total_votes` every maintenance period
+      uint64_t running_votes = 0;
+
       bool removed = false;
 
       time_point_sec get_end_date_with_delay() const
@@ -161,7 +164,7 @@ template<> struct is_static_length< freezone::chain::proposal_vote_object > : pu
 } // mira
 #endif
 
-FC_REFLECT( freezone::chain::proposal_object, (id)(proposal_id)(creator)(receiver)(start_date)(end_date)(daily_pay)(subject)(permlink)(total_votes)(removed) )
+FC_REFLECT( freezone::chain::proposal_object, (id)(proposal_id)(creator)(receiver)(start_date)(end_date)(daily_pay)(subject)(permlink)(total_votes)(running_votes)(removed) )
 CHAINBASE_SET_INDEX_TYPE( freezone::chain::proposal_object, freezone::chain::proposal_index )
 
 FC_REFLECT( freezone::chain::proposal_vote_object, (id)(voter)(proposal_id) )
@@ -88,6 +88,7 @@ enum object_type
    pending_optional_action_object_type,
    proposal_object_type,
    proposal_vote_object_type,
+   expiration_agenda_object_type,
    // SST objects
    SST_token_object_type,
    account_regular_balance_object_type,
@@ -146,6 +147,8 @@ class SST_ico_tier_object;
 class proposal_object;
 class proposal_vote_object;
 
+class expiration_agenda_object;
+
 typedef oid< dynamic_global_property_object         > dynamic_global_property_id_type;
 typedef oid< account_object                         > account_id_type;
 typedef oid< account_metadata_object                > account_metadata_id_type;
@@ -192,6 +195,8 @@ typedef oid< SST_ico_tier_object                    > SST_ico_tier_object_id_typ
 typedef oid< proposal_object > proposal_id_type;
 typedef oid< proposal_vote_object > proposal_vote_id_type;
 
+typedef oid< expiration_agenda_object > expiration_agenda_id_type;
+
 enum bandwidth_type
 {
    post,    ///< Rate limiting posting reward eligibility over time
@@ -396,6 +401,7 @@ FC_REFLECT_ENUM( freezone::chain::object_type,
                  (pending_optional_action_object_type)
                  (proposal_object_type)
                  (proposal_vote_object_type)
+                 (expiration_agenda_object_type)
                  (SST_token_object_type)
                  (account_regular_balance_object_type)
                  (account_rewards_balance_object_type)
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace freezone { namespace chain { namespace util {
+
+/**
+ * Monotonic arena for temporaries that do not outlive the block being applied.
+ *
+ * Allocation bumps a pointer through chunks of memory, deallocation does nothing, and reset()
+ * releases everything at once after the block is applied. The chunks are kept for the next block,
+ * so a node applying blocks in steady state does not return to the heap for these temporaries.
+ *
+ * Not thread safe. Containers using the arena must be destroyed before it is reset.
+ */
+class block_arena
+{
+   public:
+      struct statistics
+      {
+         uint64_t allocations = 0;        ///< Allocations served since the arena was created
+         uint64_t bytes = 0;              ///< Bytes served since the arena was created
+         uint64_t peak_block_bytes = 0;   ///< Most bytes served between two resets
+         uint64_t chunk_allocations = 0;  ///< Chunks taken from the heap, including oversized allocations
+      };
+
+      explicit block_arena( size_t chunk_size = 256 * 1024 );
+      ~block_arena();
+
+      block_arena( const block_arena& ) = delete;
+      block_arena& operator=( const block_arena& ) = delete;
+
+      void* allocate( size_t size, size_t alignment );
+
+      /// Releases everything allocated since the last reset.
+      void reset();
+
+      const statistics& get_statistics()const { return _stats; }
+
+   private:
+      void next_chunk( size_t size );
+
+      const size_t         _chunk_size;
+      std::vector< char* > _chunks;          ///< Chunks of _chunk_size bytes, reused after a reset
+      std::vector< char* > _large;           ///< Allocations too large for a chunk, freed on reset
+      size_t               _current = 0;     ///< Index of the chunk being carved
+      char*                _next = nullptr;
+      char*                _end = nullptr;
+      uint64_t             _block_bytes = 0;
+      statistics           _stats;
+};
+
+/// Allocator handing out memory from a block_arena
+template< typename T >
+class block_allocator
+{
+   public:
+      typedef T value_type;
+
+      template< typename U >
+      struct rebind { typedef block_allocator< U > other; };
+
+      block_allocator( block_arena& arena ) : _arena( &arena ) {}
+
+      template< typename U >
+      block_allocator( const block_allocator< U >& other ) : _arena( &other.arena() ) {}
+
+      T* allocate( size_t n )
+      {
+         return static_cast< T* >( _arena->allocate( n * sizeof( T ), alignof( T ) ) );
+      }
+
+      void deallocate( T*, size_t ) {}
+
+      block_arena& arena()const { return *_arena; }
+
+      template< typename U >
+      bool operator==( const block_allocator< U >& other )const { return _arena == &other.arena(); }
+
+      template< typename U >
+      bool operator!=( const block_allocator< U >& other )const { return _arena != &other.arena(); }
+
+   private:
+      block_arena* _arena;
+};
+
+template< typename T >
+using block_vector = std::vector< T, block_allocator< T > >;
+
+template< typename T >
+using block_deque = std::deque< T, block_allocator< T > >;
+
+template< typename T, typename Compare = std::less< T > >
+using block_flat_set = boost::container::flat_set< T, Compare, block_allocator< T > >;
+
+template< typename K, typename V, typename Compare = std::less< K > >
+using block_flat_map = boost::container::flat_map< K, V, Compare, block_allocator< std::pair< K, V > > >;
+
+} } } // freezone::chain::util
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <freezone/chain/operation_subscriptions.hpp>
+
 #include <fc/signals.hpp>
 
 namespace freezone { namespace chain { namespace util {
@@ -11,4 +13,10 @@ inline void disconnect_signal( boost::signals2::connection& signal )
    FC_ASSERT( !signal.connected() );
 }
 
+inline void disconnect_signal( operation_subscription& subscription )
+{
+   subscription.disconnect();
+   FC_ASSERT( !subscription.connected() );
+}
+
 } } }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace freezone { namespace chain { namespace util {
+
+/**
+ * A fixed set of threads running posted tasks until the pool is destroyed, so that work spread over
+ * several threads for every block does not start and join threads each time.
+ *
+ * Tasks still queued when the pool is destroyed are dropped.
+ */
+class worker_pool
+{
+   public:
+      explicit worker_pool( uint32_t threads );
+      ~worker_pool();
+
+      worker_pool( const worker_pool& ) = delete;
+      worker_pool& operator=( const worker_pool& ) = delete;
+
+      void post( std::function< void() > task );
+
+      /// Posts tasks to this pool
+      std::function< void( std::function< void() > ) > poster();
+
+      uint32_t size()const { return _size; }
+
+   private:
+      uint32_t                                           _size = 0;
+      boost::asio::io_service                            _ios;
+      std::unique_ptr< boost::asio::io_service::work >   _work;
+      boost::thread_group                                _threads;
+};
+
+} } } // freezone::chain::util
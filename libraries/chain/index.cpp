@@ -4,6 +4,7 @@
 #include <freezone/chain/index.hpp>
 
 #include <freezone/chain/block_summary_object.hpp>
+#include <freezone/chain/expiration_agenda_object.hpp>
 #include <freezone/chain/history_object.hpp>
 #include <freezone/chain/pending_required_action_object.hpp>
 #include <freezone/chain/pending_optional_action_object.hpp>
@@ -59,6 +60,7 @@ void initialize_core_indexes( database& db )
    freezone_ADD_CORE_INDEX(db, comment_SST_beneficiaries_index);
    freezone_ADD_CORE_INDEX(db, proposal_index);
    freezone_ADD_CORE_INDEX(db, proposal_vote_index);
+   freezone_ADD_CORE_INDEX(db, expiration_agenda_index);
 }
 
 index_info::index_info() {}
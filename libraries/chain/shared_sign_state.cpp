@@ -0,0 +1,203 @@
+#include <freezone/chain/shared_sign_state.hpp>
+
+#include <freezone/protocol/exceptions.hpp>
+#include <freezone/protocol/operation_util.hpp>
+
+namespace freezone { namespace chain {
+
+bool shared_sign_state::signed_by( const public_key_type& k )
+{
+   auto itr = _provided_signatures.find( k );
+   if( itr == _provided_signatures.end() )
+      return false;
+   return itr->second = true;
+}
+
+bool shared_sign_state::check_authority( const account_name_type& id )
+{
+   if( approved_by.find( id ) != approved_by.end() ) return true;
+   uint32_t account_auth_count = 1;
+   return check_authority_impl( _get_active( id ), 0, &account_auth_count );
+}
+
+bool shared_sign_state::check_authority( const shared_authority& auth )
+{
+   uint32_t account_auth_count = 0;
+   return check_authority_impl( auth, 0, &account_auth_count );
+}
+
+bool shared_sign_state::check_authority( const authority& auth )
+{
+   uint32_t account_auth_count = 0;
+   return check_authority_impl( auth, 0, &account_auth_count );
+}
+
+template< typename AuthorityType >
+bool shared_sign_state::check_authority_impl( const AuthorityType& auth, uint32_t depth, uint32_t* account_auth_count )
+{
+   uint32_t total_weight = 0;
+   size_t membership = 0;
+   for( const auto& k : auth.key_auths )
+   {
+      if( signed_by( k.first ) )
+      {
+         total_weight += k.second;
+         if( total_weight >= auth.weight_threshold )
+            return true;
+      }
+
+      membership++;
+      if( max_membership > 0 && membership >= max_membership )
+      {
+         return false;
+      }
+   }
+
+   for( const auto& a : auth.account_auths )
+   {
+      if( approved_by.find( a.first ) == approved_by.end() )
+      {
+         if( depth == max_recursion )
+            continue;
+
+         if( max_account_auths > 0 && *account_auth_count >= max_account_auths )
+         {
+            return false;
+         }
+
+         (*account_auth_count)++;
+
+         if( check_authority_impl( _get_active( a.first ), depth + 1, account_auth_count ) )
+         {
+            approved_by.insert( a.first );
+            total_weight += a.second;
+            if( total_weight >= auth.weight_threshold )
+               return true;
+         }
+      }
+      else
+      {
+         total_weight += a.second;
+         if( total_weight >= auth.weight_threshold )
+            return true;
+      }
+
+      membership++;
+      if( max_membership > 0 && membership >= max_membership )
+      {
+         return false;
+      }
+   }
+   return total_weight >= auth.weight_threshold;
+}
+
+bool shared_sign_state::remove_unused_signatures()
+{
+   bool removed = false;
+   for( auto itr = _provided_signatures.begin(); itr != _provided_signatures.end(); )
+   {
+      if( !itr->second )
+      {
+         itr = _provided_signatures.erase( itr );
+         removed = true;
+      }
+      else
+      {
+         ++itr;
+      }
+   }
+   return removed;
+}
+
+template< typename KeySet >
+void verify_shared_authority( const vector< operation >& ops, const KeySet& sigs,
+                              const shared_authority_getter& get_active,
+                              const shared_authority_getter& get_owner,
+                              const shared_authority_getter& get_posting,
+                              util::block_arena& arena,
+                              uint32_t max_recursion_depth,
+                              uint32_t max_membership,
+                              uint32_t max_account_auths )
+{ try {
+   flat_set< account_name_type > required_active;
+   flat_set< account_name_type > required_owner;
+   flat_set< account_name_type > required_posting;
+   vector< authority > other;
+
+   protocol::get_required_auth_visitor auth_visitor( required_active, required_owner, required_posting, other );
+
+   for( const auto& op : ops )
+      auth_visitor( op );
+
+   /**
+    *  Transactions with operations required posting authority cannot be combined
+    *  with transactions requiring active or owner authority.
+    */
+   if( required_posting.size() ) {
+      FC_ASSERT( required_active.size() == 0 );
+      FC_ASSERT( required_owner.size() == 0 );
+      FC_ASSERT( other.size() == 0 );
+
+      shared_sign_state s( sigs, get_posting, arena );
+      s.max_recursion = max_recursion_depth;
+      s.max_membership = max_membership;
+      s.max_account_auths = max_account_auths;
+      for( const auto& id : required_posting )
+      {
+         freezone_ASSERT( s.check_authority( id ) ||
+                          s.check_authority( get_active( id ) ) ||
+                          s.check_authority( get_owner( id ) ),
+                          protocol::tx_missing_posting_auth, "Missing Posting Authority ${id}",
+                          ("id",id)
+                          ("posting",authority( get_posting( id ) ))
+                          ("active",authority( get_active( id ) ))
+                          ("owner",authority( get_owner( id ) )) );
+      }
+      freezone_ASSERT(
+         !s.remove_unused_signatures(),
+         protocol::tx_irrelevant_sig,
+         "Unnecessary signature(s) detected"
+         );
+      return;
+   }
+
+   shared_sign_state s( sigs, get_active, arena );
+   s.max_recursion = max_recursion_depth;
+   s.max_membership = max_membership;
+   s.max_account_auths = max_account_auths;
+
+   for( const auto& auth : other )
+   {
+      freezone_ASSERT( s.check_authority( auth ), protocol::tx_missing_other_auth, "Missing Authority", ("auth",auth)("sigs",sigs) );
+   }
+
+   for( const auto& id : required_active )
+   {
+      freezone_ASSERT( s.check_authority( id ) ||
+                       s.check_authority( get_owner( id ) ),
+                       protocol::tx_missing_active_auth, "Missing Active Authority ${id}",
+                       ("id",id)("auth",authority( get_active( id ) ))("owner",authority( get_owner( id ) )) );
+   }
+
+   for( const auto& id : required_owner )
+   {
+      freezone_ASSERT( s.check_authority( get_owner( id ) ),
+                       protocol::tx_missing_owner_auth, "Missing Owner Authority ${id}", ("id",id)("auth",authority( get_owner( id ) )) );
+   }
+
+   freezone_ASSERT(
+      !s.remove_unused_signatures(),
+      protocol::tx_irrelevant_sig,
+      "Unnecessary signature(s) detected"
+      );
+} FC_CAPTURE_AND_RETHROW( (ops)(sigs) ) }
+
+template void verify_shared_authority( const vector< operation >&, const flat_set< public_key_type >&,
+   const shared_authority_getter&, const shared_authority_getter&, const shared_authority_getter&,
+   util::block_arena&, uint32_t, uint32_t, uint32_t );
+
+template void verify_shared_authority( const vector< operation >&, const util::block_flat_set< public_key_type >&,
+   const shared_authority_getter&, const shared_authority_getter&, const shared_authority_getter&,
+   util::block_arena&, uint32_t, uint32_t, uint32_t );
+
+} } // freezone::chain
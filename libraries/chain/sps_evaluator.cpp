@@ -2,6 +2,7 @@
 
 #include <freezone/protocol/sps_operations.hpp>
 
+#include <freezone/chain/account_object.hpp>
 #include <freezone/chain/database.hpp>
 #include <freezone/chain/freezone_evaluator.hpp>
 #include <freezone/chain/sps_objects.hpp>
@@ -77,6 +78,10 @@ void update_proposal_votes_evaluator::do_apply( const update_proposal_votes_oper
       const auto& pidx = _db.get_index< proposal_index >().indices().get< by_proposal_id >();
       const auto& pvidx = _db.get_index< proposal_vote_index >().indices().get< by_voter_proposal >();
 
+      // Votes of accounts that set a proxy are not counted, see database::validate_invariants
+      const auto& voter = _db.get_account( o.voter );
+      share_type weight = voter.proxy == freezone_PROXY_TO_SELF_ACCOUNT ? voter.witness_vote_weight() : share_type( 0 );
+
       for( const auto id : o.proposal_ids )
       {
          //checking if proposal id exists
@@ -89,16 +94,30 @@ void update_proposal_votes_evaluator::do_apply( const update_proposal_votes_oper
          if( o.approve )
          {
             if( found == pvidx.end() )
+            {
                _db.create< proposal_vote_object >( [&]( proposal_vote_object& proposal_vote )
                {
                   proposal_vote.voter = o.voter;
                   proposal_vote.proposal_id = id;
                } );
+
+               _db.modify( *found_id, [&]( proposal_object& proposal )
+               {
+                  proposal.running_votes += weight.value;
+               } );
+            }
          }
          else
          {
             if( found != pvidx.end() )
+            {
                _db.remove( *found );
+
+               _db.modify( *found_id, [&]( proposal_object& proposal )
+               {
+                  proposal.running_votes -= weight.value;
+               } );
+            }
          }
       }
    }
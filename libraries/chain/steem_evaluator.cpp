@@ -834,8 +834,7 @@ void comment_evaluator::do_apply( const comment_operation& o )
    if( _db.has_hardfork( freezone_HARDFORK_0_5__55 ) )
       FC_ASSERT( o.title.size() + o.body.size() + o.json_metadata.size(), "Cannot update comment because nothing appears to be changing." );
 
-   const auto& by_permlink_idx = _db.get_index< comment_index >().indices().get< by_permlink >();
-   auto itr = by_permlink_idx.find( boost::make_tuple( o.author, o.permlink ) );
+   const comment_object* existing = _db.find_comment( o.author, o.permlink.c_str(), o.permlink.size() );
 
    const auto& auth = _db.get_account( o.author ); /// prove it exists
 
@@ -855,7 +854,7 @@ void comment_evaluator::do_apply( const comment_operation& o )
 
    auto now = _db.head_block_time();
 
-   if ( itr == by_permlink_idx.end() )
+   if ( existing == nullptr )
    {
       if( o.parent_author != freezone_ROOT_POST_PARENT )
       {
@@ -904,6 +903,7 @@ void comment_evaluator::do_apply( const comment_operation& o )
 
          com.author = o.author;
          from_string( com.permlink, o.permlink );
+         com.permlink_hash = hash_permlink( o.permlink );
          com.last_update = _db.head_block_time();
          com.created = com.last_update;
          com.active = com.last_update;
@@ -947,7 +947,7 @@ void comment_evaluator::do_apply( const comment_operation& o )
          from_string( con.title, o.title );
          if( o.body.size() < 1024*1024*128 )
          {
-            from_string( con.body, o.body );
+            _db.set_comment_body( con, o.body );
          }
          from_string( con.json_metadata, o.json_metadata );
       });
@@ -972,7 +972,7 @@ void comment_evaluator::do_apply( const comment_operation& o )
    }
    else // start edit case
    {
-      const auto& comment = *itr;
+      const auto& comment = *existing;
 
       if( _db.is_producing() || _db.has_hardfork( freezone_HARDFORK_0_21__3313 ) )
       {
@@ -1024,18 +1024,18 @@ void comment_evaluator::do_apply( const comment_operation& o )
             diff_match_patch<std::wstring> dmp;
             auto patch = dmp.patch_fromText( utf8_to_wstring(o.body) );
             if( patch.size() ) {
-               auto result = dmp.patch_apply( patch, utf8_to_wstring( to_string( con.body ) ) );
+               auto result = dmp.patch_apply( patch, utf8_to_wstring( _db.get_comment_body( con ) ) );
                auto patched_body = wstring_to_utf8(result.first);
                if( !fc::is_utf8( patched_body ) ) {
                   idump(("invalid utf8")(patched_body));
-                  from_string( con.body, fc::prune_invalid_utf8(patched_body) );
-               } else { from_string( con.body, patched_body ); }
+                  _db.set_comment_body( con, fc::prune_invalid_utf8(patched_body) );
+               } else { _db.set_comment_body( con, patched_body ); }
             }
             else { // replace
-               from_string( con.body, o.body );
+               _db.set_comment_body( con, o.body );
             }
             } catch ( ... ) {
-               from_string( con.body, o.body );
+               _db.set_comment_body( con, o.body );
             }
          }
       });
@@ -1080,6 +1080,8 @@ void escrow_transfer_evaluator::do_apply( const escrow_transfer_operation& o )
          esc.freezone_balance          = o.freezone_amount;
          esc.pending_fee            = o.fee;
       });
+
+      _db.schedule_expiration( expired_escrow_ratifications, o.ratification_deadline );
    }
    FC_CAPTURE_AND_RETHROW( (o) )
 }
@@ -1308,6 +1310,8 @@ void withdraw_vesting_evaluator::do_apply( const withdraw_vesting_operation& o )
             a.to_withdraw = o.vesting_shares.amount;
             a.withdrawn = 0;
          } );
+
+         _db.schedule_expiration( matured_vesting_withdrawals, bal_obj->next_vesting_withdrawal );
       }
    }
    else
@@ -1352,6 +1356,8 @@ void withdraw_vesting_evaluator::do_apply( const withdraw_vesting_operation& o )
             a.to_withdraw = o.vesting_shares.amount;
             a.withdrawn = 0;
          });
+
+         _db.schedule_expiration( matured_vesting_withdrawals, account.next_vesting_withdrawal );
       }
    }
 }
@@ -1468,6 +1474,9 @@ void account_witness_proxy_evaluator::do_apply( const account_witness_proxy_oper
       _db.modify( account, [&]( account_object& a ) {
           a.proxy = o.proxy;
       });
+
+      /// proposals approved by the account count its votes again
+      _db.adjust_proposal_votes( account, account.witness_vote_weight() );
    }
 }
 
@@ -3085,6 +3094,8 @@ void convert_evaluator::do_apply( const convert_operation& o )
       obj.conversion_date = _db.head_block_time() + freezone_conversion_delay;
   });
 
+  _db.schedule_expiration( matured_conversions, _db.head_block_time() + freezone_conversion_delay );
+
 }
 
 void limit_order_create_evaluator::do_apply( const limit_order_create_operation& o )
@@ -3120,6 +3131,8 @@ void limit_order_create_evaluator::do_apply( const limit_order_create_operation&
        }
    });
 
+   _db.schedule_expiration( expired_limit_orders, order.expiration );
+
    bool filled = _db.apply_order( order );
 
    if( o.fill_or_kill ) FC_ASSERT( filled, "Cancelling order because it was not filled." );
@@ -3184,6 +3197,8 @@ void limit_order_create2_evaluator::do_apply( const limit_order_create2_operatio
        }
    });
 
+   _db.schedule_expiration( expired_limit_orders, order.expiration );
+
    bool filled = _db.apply_order( order );
 
    if( o.fill_or_kill ) FC_ASSERT( filled, "Cancelling order because it was not filled." );
@@ -3340,6 +3355,8 @@ void request_account_recovery_evaluator::do_apply( const request_account_recover
          req.new_owner_authority = o.new_owner_authority;
          req.expires = _db.head_block_time() + freezone_ACCOUNT_RECOVERY_REQUEST_EXPIRATION_PERIOD;
       });
+
+      _db.schedule_expiration( expired_recovery_requests, _db.head_block_time() + freezone_ACCOUNT_RECOVERY_REQUEST_EXPIRATION_PERIOD );
    }
    else if( o.new_owner_authority.weight_threshold == 0 ) // Cancel Request if authority is open
    {
@@ -3363,6 +3380,8 @@ void request_account_recovery_evaluator::do_apply( const request_account_recover
          req.new_owner_authority = o.new_owner_authority;
          req.expires = _db.head_block_time() + freezone_ACCOUNT_RECOVERY_REQUEST_EXPIRATION_PERIOD;
       });
+
+      _db.schedule_expiration( expired_recovery_requests, _db.head_block_time() + freezone_ACCOUNT_RECOVERY_REQUEST_EXPIRATION_PERIOD );
    }
 }
 
@@ -3416,6 +3435,8 @@ void change_recovery_account_evaluator::do_apply( const change_recovery_account_
          req.recovery_account = o.new_recovery_account;
          req.effective_on = _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD;
       });
+
+      _db.schedule_expiration( matured_change_recovery_requests, _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD );
    }
    else if( account_to_recover.recovery_account != o.new_recovery_account ) // Change existing request
    {
@@ -3424,6 +3445,8 @@ void change_recovery_account_evaluator::do_apply( const change_recovery_account_
          req.recovery_account = o.new_recovery_account;
          req.effective_on = _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD;
       });
+
+      _db.schedule_expiration( matured_change_recovery_requests, _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD );
    }
    else // Request exists and changing back to current recovery account
    {
@@ -3472,6 +3495,8 @@ void transfer_from_savings_evaluator::do_apply( const transfer_from_savings_oper
       s.complete = _db.head_block_time() + freezone_SAVINGS_WITHDRAW_TIME;
    });
 
+   _db.schedule_expiration( matured_savings_withdraws, _db.head_block_time() + freezone_SAVINGS_WITHDRAW_TIME );
+
    _db.modify( from, [&]( account_object& a )
    {
       a.savings_withdraw_requests++;
@@ -3508,6 +3533,8 @@ void decline_voting_rights_evaluator::do_apply( const decline_voting_rights_oper
          req.account = account.name;
          req.effective_date = _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD;
       });
+
+      _db.schedule_expiration( matured_decline_voting_rights, _db.head_block_time() + freezone_OWNER_AUTH_RECOVERY_PERIOD );
    }
    else
    {
@@ -3899,13 +3926,15 @@ void generic_delegate_vesting_shares_evaluator(
          FC_ASSERT( delegation->vesting_shares.amount > 0, "Delegation would set vesting_shares to zero, but it is already zero");
       }
 
-      _db.create< vesting_delegation_expiration_object >( [&]( vesting_delegation_expiration_object& obj )
+      const auto& expiration = _db.create< vesting_delegation_expiration_object >( [&]( vesting_delegation_expiration_object& obj )
       {
          obj.delegator = delegator.name;
          obj.vesting_shares = delta;
          obj.expiration = std::max( _db.head_block_time() + gpo.delegation_return_period, delegation->min_delegation_time );
       });
 
+      _db.schedule_expiration( expired_delegations, expiration.expiration );
+
       _db.modify( delegatee, [&]( AccountType& a )
       {
          if( _db.has_hardfork( freezone_HARDFORK_0_22__3485 ) )
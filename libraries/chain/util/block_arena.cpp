@@ -0,0 +1,79 @@
+#include <freezone/chain/util/block_arena.hpp>
+
+#include <algorithm>
+#include <new>
+
+namespace freezone { namespace chain { namespace util {
+
+   block_arena::block_arena( size_t chunk_size )
+      : _chunk_size( chunk_size )
+   {
+   }
+
+   block_arena::~block_arena()
+   {
+      reset();
+
+      for( char* chunk : _chunks )
+         ::operator delete( chunk );
+   }
+
+   void* block_arena::allocate( size_t size, size_t alignment )
+   {
+      ++_stats.allocations;
+      _stats.bytes += size;
+      _block_bytes += size;
+      _stats.peak_block_bytes = std::max( _stats.peak_block_bytes, _block_bytes );
+
+      if( size == 0 )
+         size = 1;
+
+      // Allocations taking a large part of a chunk would waste the rest of it
+      if( size > _chunk_size / 4 )
+      {
+         ++_stats.chunk_allocations;
+         _large.push_back( static_cast< char* >( ::operator new( size ) ) );
+         return _large.back();
+      }
+
+      for( ;; )
+      {
+         char* p = reinterpret_cast< char* >( ( reinterpret_cast< uintptr_t >( _next ) + alignment - 1 ) & ~uintptr_t( alignment - 1 ) );
+         if( _next != nullptr && p + size <= _end )
+         {
+            _next = p + size;
+            return p;
+         }
+
+         next_chunk( size );
+      }
+   }
+
+   void block_arena::next_chunk( size_t size )
+   {
+      if( _next != nullptr )
+         ++_current;
+
+      if( _current == _chunks.size() )
+      {
+         ++_stats.chunk_allocations;
+         _chunks.push_back( static_cast< char* >( ::operator new( _chunk_size ) ) );
+      }
+
+      _next = _chunks[ _current ];
+      _end = _next + _chunk_size;
+   }
+
+   void block_arena::reset()
+   {
+      for( char* p : _large )
+         ::operator delete( p );
+      _large.clear();
+
+      _current = 0;
+      _next = nullptr;
+      _end = nullptr;
+      _block_bytes = 0;
+   }
+
+} } } // freezone::chain::util
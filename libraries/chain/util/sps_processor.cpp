@@ -59,40 +59,17 @@ void sps_processor::find_active_proposals( const time_point_sec& head_time, t_pr
                                              } );
 }
 
-uint64_t sps_processor::calculate_votes( const proposal_id_type& id )
-{
-   uint64_t ret = 0;
-
-   const auto& pvidx = db.get_index< proposal_vote_index >().indices().get< by_proposal_voter >();
-   auto found = pvidx.find( id );
-
-   while( found != pvidx.end() && found->proposal_id == id )
-   {
-      const auto& _voter = db.get_account( found->voter );
-
-      //If _voter has set proxy, then his votes aren't taken into consideration
-      if( _voter.proxy == freezone_PROXY_TO_SELF_ACCOUNT )
-      {
-         auto sum = _voter.witness_vote_weight();
-         ret += sum.value;
-      }
-
-      ++found;
-   }
-
-   return ret;
-}
-
 void sps_processor::calculate_votes( const t_proposals& proposals )
 {
    for( auto& item : proposals )
    {
       const proposal_object& _item = item;
-      auto total_votes = calculate_votes( _item.proposal_id );
+
+      // Running votes are updated incrementally, validate_invariants checks them against a recount
 
       db.modify( _item, [&]( auto& proposal )
                         {
-                           proposal.total_votes = total_votes;
+                           proposal.total_votes = proposal.running_votes;
                         } );
    }
 }
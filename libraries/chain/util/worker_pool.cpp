@@ -0,0 +1,29 @@
+#include <freezone/chain/util/worker_pool.hpp>
+
+namespace freezone { namespace chain { namespace util {
+
+   worker_pool::worker_pool( uint32_t threads )
+      : _size( threads ), _work( new boost::asio::io_service::work( _ios ) )
+   {
+      for( uint32_t i = 0; i < threads; ++i )
+         _threads.create_thread( [this]() { _ios.run(); } );
+   }
+
+   worker_pool::~worker_pool()
+   {
+      _work.reset();
+      _ios.stop();
+      _threads.join_all();
+   }
+
+   void worker_pool::post( std::function< void() > task )
+   {
+      _ios.post( std::move( task ) );
+   }
+
+   std::function< void( std::function< void() > ) > worker_pool::poster()
+   {
+      return [this]( std::function< void() > task ) { post( std::move( task ) ); };
+   }
+
+} } } // freezone::chain::util
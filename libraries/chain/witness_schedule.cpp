@@ -39,7 +39,7 @@ void update_median_witness_props( database& db )
    const witness_schedule_object& wso = db.get_witness_schedule_object();
 
    /// fetch all witness objects
-   vector<const witness_object*> active; active.reserve( wso.num_scheduled_witnesses );
+   util::block_vector< const witness_object* > active( db.get_block_arena() ); active.reserve( wso.num_scheduled_witnesses );
    for( int i = 0; i < wso.num_scheduled_witnesses; i++ )
    {
       active.push_back( &db.get_witness( wso.current_shuffled_witnesses[i] ) );
@@ -132,14 +132,21 @@ void update_median_witness_props( database& db )
    } );
 }
 
+/// Witnesses keep their schedule type across rounds, so only modify those whose type changes
+void set_witness_schedule_type( database& db, const witness_object& witness, witness_object::witness_schedule_type schedule )
+{
+   if( witness.schedule != schedule )
+      db.modify( witness, [&]( witness_object& wo ) { wo.schedule = schedule; } );
+}
+
 void update_witness_schedule4( database& db )
 {
    const witness_schedule_object& wso = db.get_witness_schedule_object();
-   vector< account_name_type > active_witnesses;
+   util::block_vector< account_name_type > active_witnesses( db.get_block_arena() );
    active_witnesses.reserve( freezone_MAX_WITNESSES );
 
    /// Add the highest voted witnesses
-   flat_set< witness_id_type > selected_voted;
+   util::block_flat_set< witness_id_type > selected_voted( db.get_block_arena() );
    selected_voted.reserve( wso.max_voted_witnesses );
 
    const auto& widx = db.get_index<witness_index>().indices().get<by_vote_name>();
@@ -151,13 +158,13 @@ void update_witness_schedule4( database& db )
          continue;
       selected_voted.insert( itr->id );
       active_witnesses.push_back( itr->owner) ;
-      db.modify( *itr, [&]( witness_object& wo ) { wo.schedule = witness_object::elected; } );
+      set_witness_schedule_type( db, *itr, witness_object::elected );
    }
 
    auto num_elected = active_witnesses.size();
 
    /// Add miners from the top of the mining queue
-   flat_set< witness_id_type > selected_miners;
+   util::block_flat_set< witness_id_type > selected_miners( db.get_block_arena() );
    selected_miners.reserve( wso.max_miner_witnesses );
    const auto& gprops = db.get_dynamic_global_properties();
    const auto& pow_idx      = db.get_index<witness_index>().indices().get<by_pow>();
@@ -168,11 +175,11 @@ void update_witness_schedule4( database& db )
       if( selected_voted.find(mitr->id) == selected_voted.end() )
       {
          // Only consider a miner who has a valid block signing key
-         if( !( db.has_hardfork( freezone_HARDFORK_0_14__278 ) && db.get_witness( mitr->owner ).signing_key == public_key_type() ) )
+         if( !( db.has_hardfork( freezone_HARDFORK_0_14__278 ) && mitr->signing_key == public_key_type() ) )
          {
             selected_miners.insert(mitr->id);
             active_witnesses.push_back(mitr->owner);
-            db.modify( *mitr, [&]( witness_object& wo ) { wo.schedule = witness_object::miner; } );
+            set_witness_schedule_type( db, *mitr, witness_object::miner );
          }
       }
       // Remove processed miner from the queue
@@ -194,7 +201,8 @@ void update_witness_schedule4( database& db )
    fc::uint128 new_virtual_time = wso.current_virtual_time;
    const auto& schedule_idx = db.get_index<witness_index>().indices().get<by_schedule_time>();
    auto sitr = schedule_idx.begin();
-   vector<decltype(sitr)> processed_witnesses;
+   util::block_vector< decltype( sitr ) > processed_witnesses( db.get_block_arena() );
+   processed_witnesses.reserve( freezone_MAX_WITNESSES );
    for( auto witness_count = selected_voted.size() + selected_miners.size();
         sitr != schedule_idx.end() && witness_count < freezone_MAX_WITNESSES;
         ++sitr )
@@ -209,7 +217,7 @@ void update_witness_schedule4( database& db )
           && selected_voted.find(sitr->id) == selected_voted.end() )
       {
          active_witnesses.push_back(sitr->owner);
-         db.modify( *sitr, [&]( witness_object& wo ) { wo.schedule = witness_object::timeshare; } );
+         set_witness_schedule_type( db, *sitr, witness_object::timeshare );
          ++witness_count;
       }
    }
@@ -247,22 +255,16 @@ void update_witness_schedule4( database& db )
 
    if( db.has_hardfork( freezone_HARDFORK_0_5__54 ) )
    {
-      flat_map< version, uint32_t, std::greater< version > > witness_versions;
-      flat_map< std::tuple< hardfork_version, time_point_sec >, uint32_t > hardfork_version_votes;
+      util::block_flat_map< version, uint32_t, std::greater< version > > witness_versions( db.get_block_arena() );
+      util::block_flat_map< std::tuple< hardfork_version, time_point_sec >, uint32_t > hardfork_version_votes( db.get_block_arena() );
+      witness_versions.reserve( wso.num_scheduled_witnesses );
+      hardfork_version_votes.reserve( wso.num_scheduled_witnesses );
 
       for( uint32_t i = 0; i < wso.num_scheduled_witnesses; i++ )
       {
-         auto witness = db.get_witness( wso.current_shuffled_witnesses[ i ] );
-         if( witness_versions.find( witness.running_version ) == witness_versions.end() )
-            witness_versions[ witness.running_version ] = 1;
-         else
-            witness_versions[ witness.running_version ] += 1;
-
-         auto version_vote = std::make_tuple( witness.hardfork_version_vote, witness.hardfork_time_vote );
-         if( hardfork_version_votes.find( version_vote ) == hardfork_version_votes.end() )
-            hardfork_version_votes[ version_vote ] = 1;
-         else
-            hardfork_version_votes[ version_vote ] += 1;
+         const auto& witness = db.get_witness( wso.current_shuffled_witnesses[ i ] );
+         ++witness_versions[ witness.running_version ];
+         ++hardfork_version_votes[ std::make_tuple( witness.hardfork_version_vote, witness.hardfork_time_vote ) ];
       }
 
       int witnesses_on_version = 0;
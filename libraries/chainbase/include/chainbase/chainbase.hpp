@@ -1216,6 +1216,8 @@ namespace chainbase {
             int_incrementer ii( _read_lock_count );
 #endif
 
+            auto wait_start = boost::chrono::steady_clock::now();
+
             if( !wait_micro )
             {
                lock.lock();
@@ -1223,9 +1225,13 @@ namespace chainbase {
             else
             {
                if( !lock.timed_lock( boost::posix_time::microsec_clock::universal_time() + boost::posix_time::microseconds( wait_micro ) ) )
+               {
+                  add_lock_wait( wait_start );
                   BOOST_THROW_EXCEPTION( lock_exception() );
+               }
             }
 
+            add_lock_wait( wait_start );
             return callback();
          }
 
@@ -1238,6 +1244,8 @@ namespace chainbase {
             int_incrementer ii( _write_lock_count );
 #endif
 
+            auto wait_start = boost::chrono::steady_clock::now();
+
 #if !defined ENABLE_MIRA || defined IS_TEST_NET
             if( wait_micro )
             {
@@ -1254,9 +1262,16 @@ namespace chainbase {
                lock.lock();
             }
 
+            add_lock_wait( wait_start );
             return callback();
          }
 
+         /**
+          * Microseconds the calling thread has spent waiting in with_read_lock and with_write_lock.
+          * Never reset by the database; callers reset it before the work they want to measure.
+          */
+         static uint64_t& thread_lock_wait_micros();
+
 #ifdef ENABLE_MIRA
          template< typename Lambda >
          void bulk_load( Lambda&& callback )
@@ -1304,6 +1319,12 @@ namespace chainbase {
             { return _index_list; }
 
       private:
+         static void add_lock_wait( const boost::chrono::steady_clock::time_point& wait_start )
+         {
+            thread_lock_wait_micros() += boost::chrono::duration_cast< boost::chrono::microseconds >(
+               boost::chrono::steady_clock::now() - wait_start ).count();
+         }
+
          template<typename MultiIndexType>
          void add_index_helper() {
             const uint16_t type_id = generic_index<MultiIndexType>::value_type::type_id;
@@ -290,6 +290,12 @@ namespace chainbase {
       return session( std::move( _sub_sessions ), _undo_session_count );
    }
 
+   uint64_t& database::thread_lock_wait_micros()
+   {
+      static thread_local uint64_t lock_wait = 0;
+      return lock_wait;
+   }
+
 }  // namespace chainbase
 
 
@@ -107,8 +107,8 @@ namespace fc { namespace raw {
    } // namespace raw
 
 
-   template<typename T>
-   void to_variant( const flat_set<T>& var,  variant& vo )
+   template<typename T, typename... A>
+   void to_variant( const flat_set<T, A...>& var,  variant& vo )
    {
        std::vector<variant> vars(var.size());
        size_t i = 0;
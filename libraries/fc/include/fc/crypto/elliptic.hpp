@@ -7,6 +7,8 @@
 #include <fc/array.hpp>
 #include <fc/io/raw_fwd.hpp>
 
+#include <functional>
+
 namespace fc {
 
   namespace ecc {
@@ -87,6 +89,23 @@ namespace fc {
 
            static bool is_canonical( const compact_signature& c, canonical_signature_type canon_type );
 
+           /// Runs a task on a thread of a pool owned by the caller
+           typedef std::function< void( std::function< void() > ) > task_poster;
+
+           /**
+            *  Recovers keys[i] from signatures[i] over digests[i] for count signatures. Keys that cannot be
+            *  recovered are left empty.
+            *
+            *  The calling thread recovers signatures itself, and up to helpers tasks posted with post recover
+            *  the others. The calling thread never waits for a task that has not started, so post may use the
+            *  pool the caller is running on. Exceptions other than failed recoveries are rethrown here.
+            *
+            *  @return the number of keys that could not be recovered
+            */
+           static size_t recover_many( const compact_signature* signatures, const fc::sha256* digests, size_t count,
+                                       public_key_data* keys, canonical_signature_type canon_type = fc_canonical,
+                                       const task_poster& post = task_poster(), uint32_t helpers = 0 );
+
         private:
           friend class private_key;
           static public_key from_key_data( const public_key_data& v );
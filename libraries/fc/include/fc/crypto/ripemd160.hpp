@@ -80,6 +80,12 @@ class ripemd160
 
   template<> struct get_typename<uint160_t>    { static const char* name()  { return "uint160_t";  } };
 
+  namespace raw {
+    template<> struct is_trivially_packable< ripemd160 > : std::true_type {};
+  }
+
+  static_assert( sizeof( ripemd160 ) == 20, "ripemd160 is packed as a copy of the object" );
+
 } // namespace fc
 
 namespace std
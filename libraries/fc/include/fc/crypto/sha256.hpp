@@ -24,6 +24,21 @@ class sha256
     static sha256 hash( const string& );
     static sha256 hash( const sha256& );
 
+    /**
+     *  Hashes count independent messages, out[i] being the hash of sizes[i] bytes at data[i].
+     *  Several messages are compressed at once when the CPU supports it.
+     */
+    static void hash_many( const char* const* data, const uint32_t* sizes, size_t count, sha256* out );
+
+    /// The implementations hash_many chooses from, the first supported of shani, avx2 and openssl
+    enum class hash_many_impl { openssl, shani, avx2 };
+
+    /// Whether the CPU supports the implementation
+    static bool hash_many_supported( hash_many_impl impl );
+
+    /// hash_many with the given implementation, which must be supported
+    static void hash_many( hash_many_impl impl, const char* const* data, const uint32_t* sizes, size_t count, sha256* out );
+
     template<typename T>
     static sha256 hash( const T& t )
     {
@@ -106,6 +121,12 @@ class sha256
 
   uint64_t hash64(const char* buf, size_t len);
 
+  namespace raw {
+    template<> struct is_trivially_packable< sha256 > : std::true_type {};
+  }
+
+  static_assert( sizeof( sha256 ) == 32, "sha256 is packed as a copy of the object" );
+
 } // fc
 namespace std
 {
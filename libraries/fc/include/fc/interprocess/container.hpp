@@ -127,6 +127,11 @@ namespace fc {
        template<typename Stream, typename T, typename... A>
        inline void pack( Stream& s, const bip::vector<T,A...>& value ) {
          pack( s, unsigned_int((uint32_t)value.size()) );
+         if( is_trivially_packable<T>::value ) {
+           if( value.size() )
+             s.write( (const char*)&value[0], value.size() * sizeof(T) );
+           return;
+         }
          auto itr = value.begin();
          auto end = value.end();
          while( itr != end ) {
@@ -141,6 +146,13 @@ namespace fc {
          unsigned_int size;
          unpack( s, size, depth );
          value.clear();
+         if( is_trivially_packable<T>::value ) {
+           FC_ASSERT( size.value*sizeof(T) < MAX_ARRAY_ALLOC_SIZE );
+           value.resize( size.value );
+           if( value.size() )
+             s.read( (char*)&value[0], value.size() * sizeof(T) );
+           return;
+         }
          for ( size_t i = 0; i < size.value; i++ )
          {
             T tmp;
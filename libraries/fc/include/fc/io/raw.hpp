@@ -291,11 +291,11 @@ namespace fc {
 
     template<typename Stream> inline void unpack( Stream& s, fc::string& v, uint32_t depth )  {
       depth++;
-      std::vector<char> tmp;
-      fc::raw::unpack(s,tmp,depth);
-      if( tmp.size() )
-         v = fc::string(tmp.data(),tmp.data()+tmp.size());
-      else v = fc::string();
+      unsigned_int size; fc::raw::unpack( s, size, depth );
+      FC_ASSERT( size.value < MAX_ARRAY_ALLOC_SIZE );
+      v.resize( size.value );
+      if( v.size() )
+         s.read( &v[0], v.size() );
     }
 
     // bool
@@ -414,6 +414,36 @@ namespace fc {
         }
       };
 
+      /// Packs the elements of a vector like container
+      template<typename Stream, typename Container>
+      inline void pack_elements( Stream& s, const Container& value, std::true_type ) {
+        if( value.size() )
+          s.write( (const char*)&value[0], value.size() * sizeof(typename Container::value_type) );
+      }
+      template<typename Stream, typename Container>
+      inline void pack_elements( Stream& s, const Container& value, std::false_type ) {
+        for( const auto& v : value )
+          fc::raw::pack( s, v );
+      }
+
+      /// Unpacks size elements into an empty vector like container
+      template<typename Stream, typename Container>
+      inline void unpack_elements( Stream& s, Container& value, uint32_t size, uint32_t depth, std::true_type ) {
+        value.resize( size );
+        if( size )
+          s.read( (char*)&value[0], size * sizeof(typename Container::value_type) );
+      }
+      template<typename Stream, typename Container>
+      inline void unpack_elements( Stream& s, Container& value, uint32_t size, uint32_t depth, std::false_type ) {
+        value.reserve( size );
+        for( uint32_t i = 0; i < size; ++i )
+        {
+           typename Container::value_type tmp;
+           fc::raw::unpack( s, tmp, depth );
+           value.emplace_back( std::move( tmp ) );
+        }
+      }
+
     } // namespace detail
 
     template<typename Stream, typename T>
@@ -536,12 +566,7 @@ namespace fc {
     template<typename Stream, typename T>
     inline void pack( Stream& s, const std::vector<T>& value ) {
       fc::raw::pack( s, unsigned_int((uint32_t)value.size()) );
-      auto itr = value.begin();
-      auto end = value.end();
-      while( itr != end ) {
-        fc::raw::pack( s, *itr );
-        ++itr;
-      }
+      detail::pack_elements( s, value, is_trivially_packable<T>() );
     }
 
     template<typename Stream, typename T>
@@ -551,12 +576,7 @@ namespace fc {
       unsigned_int size; fc::raw::unpack( s, size );
       FC_ASSERT( size.value*sizeof(T) < MAX_ARRAY_ALLOC_SIZE );
       value.clear();
-      for ( size_t i = 0; i < size.value; i++ )
-      {
-         T tmp;
-         fc::raw::unpack( s, tmp, depth );
-         value.emplace_back( std::move( tmp ) );
-      }
+      detail::unpack_elements( s, value, size.value, depth, is_trivially_packable<T>() );
     }
 
     template<typename Stream, typename... T>
@@ -623,12 +643,23 @@ namespace fc {
       fc::raw::detail::if_reflected< typename fc::reflector<T>::is_defined >::unpack(s,v,depth);
     } FC_RETHROW_EXCEPTIONS( warn, "error unpacking ${type}", ("type",fc::get_typename<T>::name() ) ) }
 
+    namespace detail {
+      template<typename T>
+      inline size_t pack_size( const T& v, std::true_type ) { return sizeof(T); }
+
+      template<typename T>
+      inline size_t pack_size( const T& v, std::false_type )
+      {
+        datastream<size_t> ps;
+        fc::raw::pack(ps,v );
+        return ps.tellp();
+      }
+    }
+
     template<typename T>
     inline size_t pack_size(  const T& v )
     {
-      datastream<size_t> ps;
-      fc::raw::pack(ps,v );
-      return ps.tellp();
+      return detail::pack_size( v, is_trivially_packable<T>() );
     }
 
     template<typename T>
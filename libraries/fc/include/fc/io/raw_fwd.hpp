@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <set>
 #include <boost/tuple/tuple.hpp>
+#include <type_traits>
 
 #define MAX_ARRAY_ALLOC_SIZE (1024*1024*10)
 #define MAX_RECURSION_DEPTH  (20)
@@ -31,6 +32,20 @@ namespace fc {
    template<typename Storage> class fixed_string;
 
    namespace raw {
+    /**
+     * True for types whose raw serialization is a copy of their sizeof(T) bytes, so that contiguous
+     * sequences of them are packed and unpacked with a single write or read and their packed size is
+     * known at compile time. Specialize it for fixed layout types that are packed as a copy of the object.
+     */
+    template<typename T>
+    struct is_trivially_packable : std::integral_constant< bool, std::is_arithmetic<T>::value && !std::is_same<T,bool>::value > {};
+
+    template<typename T, size_t N>
+    struct is_trivially_packable< fc::array<T,N> > : is_trivially_packable<T> {};
+
+    template<typename T, size_t N>
+    struct is_trivially_packable< fc::int_array<T,N> > : is_trivially_packable<T> {};
+
     template<typename T>
     inline size_t pack_size(  const T& v );
 
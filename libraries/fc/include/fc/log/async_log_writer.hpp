@@ -0,0 +1,78 @@
+#pragma once
+
+#include <fc/log/log_message.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fc
+{
+   /**
+    *  @brief Writes formatted log lines from a background thread.
+    *
+    *  Lines are queued in a bounded lock-free ring buffer that any number of threads may push to, and a
+    *  dedicated thread writes them out in batches, flushing once per batch.  When the buffer is full a
+    *  push either drops the line, which is counted and reported in the log once space is available, or
+    *  waits for the writer to catch up.
+    *
+    *  Lines still queued when the writer is destroyed are written before its thread exits.
+    */
+   class async_log_writer
+   {
+      public:
+         typedef std::function< void( const std::string& line, log_level level ) > write_function;
+         typedef std::function< void() >                                           flush_function;
+
+         /**
+          *  @param capacity rounded up to a power of two
+          *  @param drop_when_full whether push drops lines or waits when the buffer is full
+          */
+         async_log_writer( uint32_t capacity, bool drop_when_full, write_function write, flush_function flush );
+         ~async_log_writer();
+
+         async_log_writer( const async_log_writer& ) = delete;
+         async_log_writer& operator=( const async_log_writer& ) = delete;
+
+         /// @return false if the line was dropped
+         bool push( std::string line, log_level level );
+
+         /// Number of lines dropped because the buffer was full
+         uint64_t dropped_messages()const { return _dropped.load( std::memory_order_relaxed ); }
+
+      private:
+         struct cell
+         {
+            std::atomic< size_t >   sequence;
+            std::string             line;
+            log_level               level;
+         };
+
+         bool try_push( std::string& line, log_level level );
+         bool pop( std::string& line, log_level& level );
+         void run();
+         void wake();
+
+         const size_t                  _mask;
+         std::unique_ptr< cell[] >     _cells;
+         const bool                    _drop_when_full;
+         write_function                _write;
+         flush_function                _flush;
+
+         std::atomic< size_t >         _enqueue_pos{ 0 };
+         size_t                        _dequeue_pos = 0;
+         std::atomic< uint64_t >       _dropped{ 0 };
+         uint64_t                      _reported_dropped = 0;
+
+         std::atomic< bool >           _sleeping{ false };
+         std::atomic< bool >           _stopping{ false };
+         std::mutex                    _mutex;
+         std::condition_variable       _wakeup;
+         std::thread                   _thread;
+   };
+
+} // namespace fc
@@ -44,6 +44,11 @@ namespace fc
                console_appender::stream::type     stream;
                std::vector<level_color>           level_colors;
                bool                               flush;
+               /// Print from a background thread instead of the thread logging the message
+               bool                               async = false;
+               uint32_t                           async_queue_size = 8192;
+               /// When the queue is full, drop messages rather than wait for the writer
+               bool                               async_drop_when_full = true;
             };
 
 
@@ -54,12 +59,18 @@ namespace fc
             ~console_appender();
             virtual void log( const log_message& m );
 
+            /// Messages dropped because the async queue was full
+            uint64_t dropped_messages()const;
+
             void print( const std::string& text_to_print,
                         color::type text_color = color::console_default );
 
             void configure( const config& cfg );
 
        private:
+            void print( const std::string& text_to_print, color::type text_color, bool flush );
+            void print_line( const std::string& line, log_level level, bool flush );
+
             class impl;
             std::unique_ptr<impl> my;
    };
@@ -69,4 +80,4 @@ namespace fc
 FC_REFLECT_ENUM( fc::console_appender::stream::type, (std_out)(std_error) )
 FC_REFLECT_ENUM( fc::console_appender::color::type, (red)(green)(brown)(blue)(magenta)(cyan)(white)(console_default) )
 FC_REFLECT( fc::console_appender::level_color, (level)(color) )
-FC_REFLECT( fc::console_appender::config, (format)(stream)(level_colors)(flush) )
+FC_REFLECT( fc::console_appender::config, (format)(stream)(level_colors)(flush)(async)(async_queue_size)(async_drop_when_full) )
@@ -18,11 +18,19 @@ class file_appender : public appender {
             bool                               rotate = false;
             microseconds                       rotation_interval;
             microseconds                       rotation_limit;
+            /// Write from a background thread instead of the thread logging the message
+            bool                               async = false;
+            uint32_t                           async_queue_size = 8192;
+            /// When the queue is full, drop messages rather than wait for the writer
+            bool                               async_drop_when_full = true;
          };
          file_appender( const variant& args );
          ~file_appender();
          virtual void log( const log_message& m )override;
 
+         /// Messages dropped because the async queue was full
+         uint64_t dropped_messages()const;
+
       private:
          class impl;
          fc::shared_ptr<impl> my;
@@ -31,4 +39,5 @@ class file_appender : public appender {
 
 #include <fc/reflect/reflect.hpp>
 FC_REFLECT( fc::file_appender::config,
-            (format)(filename)(flush)(rotate)(rotation_interval)(rotation_limit) )
+            (format)(filename)(flush)(rotate)(rotation_interval)(rotation_limit)
+            (async)(async_queue_size)(async_drop_when_full) )
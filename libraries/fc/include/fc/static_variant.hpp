@@ -11,6 +11,7 @@
  **/
 #pragma once
 #include <stdexcept>
+#include <type_traits>
 #include <typeinfo>
 #include <fc/exception/exception.hpp>
 
@@ -19,7 +20,7 @@ namespace fc {
 // Implementation details, the user should not import this:
 namespace impl {
 
-template<int64_t N, typename... Ts>
+template<typename... Ts>
 struct storage_ops;
 
 template<typename X, typename... Ts>
@@ -54,84 +55,70 @@ struct move_construct
    }
 };
 
-template<int64_t N, typename T, typename... Ts>
-struct storage_ops<N, T&, Ts...> {
-    static void del(int64_t n, void *data) {}
-    static void con(int64_t n, void *data) {}
+/**
+ * Operations on the storage of a static_variant. Each operation indexes a table with one function per
+ * alternative by the tag, so the cost of visiting does not grow with the number of types. The tables
+ * are generated at compile time, one per operation and visitor type.
+ */
+template<typename... Ts>
+struct storage_ops {
+    static_assert(sizeof...(Ts) > 0, "static_variant storage needs at least one type.");
+    static_assert(type_info<Ts...>::no_reference_types, "Reference types are not permitted in static_variant.");
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, void *data, visitor& v) {}
+    static void check_tag(int64_t n) {
+        if(static_cast<uint64_t>(n) >= sizeof...(Ts))
+            FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+    }
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, void *data, const visitor& v) {}
+    template<typename T>
+    static void destroy(void *data) { reinterpret_cast<T*>(data)->~T(); }
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, const void *data, visitor& v) {}
+    template<typename T>
+    static void construct(void *data) { new(reinterpret_cast<T*>(data)) T(); }
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, const void *data, const visitor& v) {}
-};
-
-template<int64_t N, typename T, typename... Ts>
-struct storage_ops<N, T, Ts...> {
     static void del(int64_t n, void *data) {
-        if(n == N) reinterpret_cast<T*>(data)->~T();
-        else storage_ops<N + 1, Ts...>::del(n, data);
+        static void (* const table[])(void*) = { &destroy<Ts>... };
+        check_tag(n);
+        table[n](data);
     }
     static void con(int64_t n, void *data) {
-        if(n == N) new(reinterpret_cast<T*>(data)) T();
-        else storage_ops<N + 1, Ts...>::con(n, data);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, void *data, visitor& v) {
-        if(n == N) return v(*reinterpret_cast<T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, void *data, const visitor& v) {
-        if(n == N) return v(*reinterpret_cast<T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
+        static void (* const table[])(void*) = { &construct<Ts>... };
+        check_tag(n);
+        table[n](data);
     }
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, const void *data, visitor& v) {
-        if(n == N) return v(*reinterpret_cast<const T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
+    /// T is const qualified when Data is const void*
+    template<typename visitor, typename Data, typename T>
+    static typename std::remove_const<visitor>::type::result_type invoke(Data data, visitor& v) {
+        return v(*reinterpret_cast<T*>(data));
     }
 
-    template<typename visitor>
-    static typename visitor::result_type apply(int64_t n, const void *data, const visitor& v) {
-        if(n == N) return v(*reinterpret_cast<const T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-};
-
-template<int64_t N>
-struct storage_ops<N> {
-    static void del(int64_t n, void *data) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid.");
-    }
-    static void con(int64_t n, void *data) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+    template<typename visitor, typename Data, typename... Us>
+    static typename std::remove_const<visitor>::type::result_type dispatch(int64_t n, Data data, visitor& v) {
+        typedef typename std::remove_const<visitor>::type::result_type (* const visit_function)(Data, visitor&);
+        static visit_function table[] = { &invoke<visitor, Data, Us>... };
+        check_tag(n);
+        return table[n](data, v);
     }
 
     template<typename visitor>
     static typename visitor::result_type apply(int64_t n, void *data, visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+        return dispatch<visitor, void*, Ts...>(n, data, v);
     }
+
     template<typename visitor>
     static typename visitor::result_type apply(int64_t n, void *data, const visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+        return dispatch<const visitor, void*, Ts...>(n, data, v);
     }
+
     template<typename visitor>
     static typename visitor::result_type apply(int64_t n, const void *data, visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+        return dispatch<visitor, const void*, const Ts...>(n, data, v);
     }
+
     template<typename visitor>
     static typename visitor::result_type apply(int64_t n, const void *data, const visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
+        return dispatch<const visitor, const void*, const Ts...>(n, data, v);
     }
 };
 
@@ -213,7 +200,7 @@ public:
     static_variant()
     {
        _tag = 0;
-       impl::storage_ops<0, Types...>::con(0, storage);
+       impl::storage_ops<Types...>::con(0, storage);
     }
 
     template<typename... Other>
@@ -240,7 +227,7 @@ public:
         init(v);
     }
     ~static_variant() {
-       impl::storage_ops<0, Types...>::del(_tag, storage);
+       impl::storage_ops<Types...>::del(_tag, storage);
     }
 
 
@@ -307,22 +294,22 @@ public:
     }
     template<typename visitor>
     typename visitor::result_type visit(visitor& v) {
-        return impl::storage_ops<0, Types...>::apply(_tag, storage, v);
+        return impl::storage_ops<Types...>::apply(_tag, storage, v);
     }
 
     template<typename visitor>
     typename visitor::result_type visit(const visitor& v) {
-        return impl::storage_ops<0, Types...>::apply(_tag, storage, v);
+        return impl::storage_ops<Types...>::apply(_tag, storage, v);
     }
 
     template<typename visitor>
     typename visitor::result_type visit(visitor& v)const {
-        return impl::storage_ops<0, Types...>::apply(_tag, storage, v);
+        return impl::storage_ops<Types...>::apply(_tag, storage, v);
     }
 
     template<typename visitor>
     typename visitor::result_type visit(const visitor& v)const {
-        return impl::storage_ops<0, Types...>::apply(_tag, storage, v);
+        return impl::storage_ops<Types...>::apply(_tag, storage, v);
     }
 
     static int64_t count() { return static_cast< int64_t >( impl::type_info<Types...>::count ); }
@@ -330,7 +317,7 @@ public:
       FC_ASSERT( w < count() && w >= 0 );
       this->~static_variant();
       _tag = w;
-      impl::storage_ops<0, Types...>::con(_tag, storage);
+      impl::storage_ops<Types...>::con(_tag, storage);
     }
 
     int64_t which() const {return _tag;}
@@ -130,8 +130,8 @@ namespace fc
    template<typename T>
    void from_variant( const variant& var,  std::deque<T>& vo );
 
-   template<typename T>
-   void to_variant( const fc::flat_set<T>& var,  variant& vo );
+   template<typename T, typename... A>
+   void to_variant( const fc::flat_set<T, A...>& var,  variant& vo );
    template<typename T>
    void from_variant( const variant& var, fc::flat_set<T>& vo );
 
@@ -181,7 +181,8 @@ namespace fc
     *        and variant_object's.
     *
     * variant's allocate everything but strings, arrays, and objects on the
-    * stack and are 'move aware' for values allcoated on the heap.
+    * stack and are 'move aware' for values allcoated on the heap.  Those heap
+    * values are carved from the current variant_arena when there is one.
     *
     * Memory usage on 64 bit systems is 16 bytes and 12 bytes on 32 bit systems.
     */
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace fc
+{
+   namespace detail { struct variant_arena_block; }
+
+   /**
+    *  @brief Scope in which the heap nodes of variants are carved from a monotonic arena.
+    *
+    *  Strings, arrays and objects held by a variant live in nodes allocated apart from the variant
+    *  itself. While a variant_arena is alive on a thread, those nodes (and the entry storage of
+    *  variant_objects) are bump allocated from large blocks instead of one malloc each, and freeing
+    *  them only drops a count on their block.  This suits the variant trees built and thrown away
+    *  while answering a single API call.
+    *
+    *  A block is returned to the heap once the arena has moved past it and every node carved from it
+    *  has been freed, so variants may safely outlive the arena or be freed on another thread; an
+    *  escaping variant only keeps its block alive.
+    *
+    *  An arena created while another is alive on the same thread joins the enclosing one.
+    */
+   class variant_arena
+   {
+      public:
+         explicit variant_arena( size_t block_size = 64 * 1024 );
+         ~variant_arena();
+
+         variant_arena( const variant_arena& ) = delete;
+         variant_arena& operator=( const variant_arena& ) = delete;
+
+         /// Allocates from the arena of the calling thread, or from the heap when there is none
+         static void* allocate( size_t size );
+         /// Frees memory returned by allocate(), from whichever thread
+         static void  deallocate( void* p );
+
+         /// True when the calling thread is inside an arena scope
+         static bool  active();
+
+      private:
+         detail::variant_arena_block*  _block = nullptr;
+         size_t                        _block_size;
+         bool                          _owner;
+   };
+
+   namespace detail
+   {
+      /// Stateless allocator drawing from variant_arena::allocate()
+      template< typename T >
+      struct variant_allocator
+      {
+         typedef T value_type;
+
+         static_assert( alignof( T ) <= 16, "variant_arena allocations are only aligned to 16 bytes" );
+
+         variant_allocator() {}
+         template< typename U > variant_allocator( const variant_allocator< U >& ) {}
+
+         T* allocate( size_t n )
+         {
+            return static_cast< T* >( variant_arena::allocate( n * sizeof( T ) ) );
+         }
+
+         void deallocate( T* p, size_t )
+         {
+            variant_arena::deallocate( p );
+         }
+
+         template< typename U > bool operator==( const variant_allocator< U >& )const { return true; }
+         template< typename U > bool operator!=( const variant_allocator< U >& )const { return false; }
+      };
+
+      template< typename T, typename... Args >
+      T* new_variant_node( Args&&... args )
+      {
+         static_assert( alignof( T ) <= 16, "variant_arena allocations are only aligned to 16 bytes" );
+
+         void* p = variant_arena::allocate( sizeof( T ) );
+         try
+         {
+            return new( p ) T( std::forward< Args >( args )... );
+         }
+         catch( ... )
+         {
+            variant_arena::deallocate( p );
+            throw;
+         }
+      }
+
+      template< typename T >
+      void delete_variant_node( T* p )
+      {
+         if( p )
+         {
+            p->~T();
+            variant_arena::deallocate( p );
+         }
+      }
+
+      struct variant_node_deleter
+      {
+         template< typename T >
+         void operator()( T* p )const { delete_variant_node( p ); }
+      };
+   }
+
+} // namespace fc
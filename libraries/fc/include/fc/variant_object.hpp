@@ -1,5 +1,6 @@
 #pragma once
 #include <fc/variant.hpp>
+#include <fc/variant_arena.hpp>
 #include <fc/shared_ptr.hpp>
 #include <fc/unique_ptr.hpp>
 
@@ -44,7 +45,8 @@ namespace fc
          variant _value;
       };
 
-      typedef std::vector< entry >::const_iterator iterator;
+      typedef std::vector< entry, detail::variant_allocator< entry > > entry_vector;
+      typedef entry_vector::const_iterator iterator;
 
       /**
          * @name Immutable Interface
@@ -70,7 +72,7 @@ namespace fc
 
       template<typename T>
       variant_object( const map<string,T>& values )
-      :_key_value( new std::vector<entry>() ) {
+      :_key_value( make_entries() ) {
          _key_value->reserve( values.size() );
          for( const auto& item : values ) {
             _key_value->emplace_back( entry( item.first, fc::variant(item.second) ) );
@@ -79,7 +81,7 @@ namespace fc
        
       template<typename T>
       variant_object( string key, T&& val )
-      :_key_value( std::make_shared<std::vector<entry> >() )
+      :_key_value( empty_entries() )
       {
          *this = variant_object( std::move(key), variant(forward<T>(val)) );
       }
@@ -96,7 +98,12 @@ namespace fc
       variant_object& operator=( const mutable_variant_object& );
 
    private:
-      std::shared_ptr< std::vector< entry > > _key_value;
+      /// A new entry vector, allocated with its reference count
+      static std::shared_ptr< entry_vector > make_entries();
+      /// The entry vector shared by every empty object, which must never be modified
+      static const std::shared_ptr< entry_vector >& empty_entries();
+
+      std::shared_ptr< entry_vector > _key_value;
       friend class mutable_variant_object;
    };
    /** @ingroup Serializable */
@@ -122,8 +129,8 @@ namespace fc
       /** @brief a key/value pair */
       typedef variant_object::entry  entry;
 
-      typedef std::vector< entry >::iterator       iterator;
-      typedef std::vector< entry >::const_iterator const_iterator;
+      typedef variant_object::entry_vector::iterator       iterator;
+      typedef variant_object::entry_vector::const_iterator const_iterator;
 
       /**
          * @name Immutable Interface
@@ -199,7 +206,7 @@ namespace fc
 
       template<typename T>
       explicit mutable_variant_object( T&& v )
-      :_key_value( new std::vector<entry>() )
+      :_key_value( detail::new_variant_node< variant_object::entry_vector >() )
       {
           *this = variant(fc::forward<T>(v)).get_object();
       }
@@ -208,7 +215,7 @@ namespace fc
 
       template<typename T>
       mutable_variant_object( const map<string,T>& values )
-      :_key_value( new std::vector<entry>() ) {
+      :_key_value( detail::new_variant_node< variant_object::entry_vector >() ) {
          _key_value->reserve( values.size() );
          for( const auto& item : values ) {
             _key_value->emplace_back( variant_object::entry( item.first, fc::variant(item.second) ) );
@@ -219,7 +226,7 @@ namespace fc
       mutable_variant_object( string key, variant val );
       template<typename T>
       mutable_variant_object( string key, T&& val )
-      :_key_value( new std::vector<entry>() )
+      :_key_value( detail::new_variant_node< variant_object::entry_vector >() )
       {
          set( std::move(key), variant(forward<T>(val)) );
       }
@@ -234,7 +241,7 @@ namespace fc
 
 
    private:
-      std::unique_ptr< std::vector< entry > > _key_value;
+      std::unique_ptr< variant_object::entry_vector, detail::variant_node_deleter > _key_value;
       friend class variant_object;
    };
    /** @ingroup Serializable */
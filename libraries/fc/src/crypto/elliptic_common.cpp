@@ -8,6 +8,14 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #ifdef _WIN32
 # include <malloc.h>
 #else
@@ -208,6 +216,79 @@ namespace fc { namespace ecc {
       }
     }
 
+    size_t public_key::recover_many( const compact_signature* signatures, const fc::sha256* digests, size_t count,
+                                     public_key_data* keys, canonical_signature_type canon_type,
+                                     const task_poster& post, uint32_t helpers )
+    {
+        struct recovery_state
+        {
+            std::atomic< size_t >      next{ 0 };
+            std::atomic< size_t >      failures{ 0 };
+            size_t                     done = 0;
+            std::exception_ptr         error;
+            std::mutex                 mutex;
+            std::condition_variable    finished;
+        };
+
+        auto state = std::make_shared< recovery_state >();
+
+        // Claims signatures until none is left. A helper starting after all were claimed returns without
+        // touching the arguments, which may be gone by then.
+        auto recover = [state, signatures, digests, count, keys, canon_type]()
+        {
+            size_t completed = 0;
+            std::exception_ptr error;
+
+            for( size_t i = state->next++; i < count; i = state->next++ )
+            {
+                try
+                {
+                    keys[i] = public_key( signatures[i], digests[i], canon_type ).serialize();
+                }
+                catch( const fc::exception& )
+                {
+                    keys[i] = public_key_data();
+                    state->failures.fetch_add( 1, std::memory_order_relaxed );
+                }
+                catch( ... )
+                {
+                    keys[i] = public_key_data();
+                    if( !error )
+                        error = std::current_exception();
+                }
+                ++completed;
+            }
+
+            if( completed )
+            {
+                std::lock_guard< std::mutex > guard( state->mutex );
+                state->done += completed;
+                if( error && !state->error )
+                    state->error = error;
+                if( state->done == count )
+                    state->finished.notify_all();
+            }
+        };
+
+        if( post && count > 1 )
+        {
+            // The curve context is created once and only read while recovering, so all threads share it
+            size_t num_helpers = std::min< size_t >( helpers, count - 1 );
+            for( size_t h = 0; h < num_helpers; ++h )
+                post( recover );
+        }
+
+        recover();
+
+        std::unique_lock< std::mutex > lock( state->mutex );
+        state->finished.wait( lock, [&]() { return state->done == count; } );
+
+        if( state->error )
+            std::rethrow_exception( state->error );
+
+        return state->failures;
+    }
+
     private_key private_key::generate_from_seed( const fc::sha256& seed, const fc::sha256& offset )
     {
         ssl_bignum z;
@@ -0,0 +1,420 @@
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <openssl/sha.h>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define FC_SHA256_X86 1
+#endif
+
+namespace fc {
+
+namespace {
+
+   const uint32_t sha256_k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+   };
+
+   const uint32_t sha256_initial_state[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+
+   uint32_t padded_blocks( uint32_t size )
+   {
+      return ( uint64_t( size ) + 9 + 63 ) / 64;
+   }
+
+   /// A message split into the blocks fed to the compression function, padding included
+   struct padded_message
+   {
+      const uint8_t* data;
+      uint32_t       full_blocks;
+      uint32_t       blocks;
+      uint8_t        tail[128];
+
+      void init( const char* d, uint32_t size )
+      {
+         data = (const uint8_t*)d;
+         full_blocks = size / 64;
+         blocks = padded_blocks( size );
+
+         uint32_t rest = size % 64;
+         uint32_t tail_size = ( blocks - full_blocks ) * 64;
+         memset( tail, 0, tail_size );
+         if( rest )
+            memcpy( tail, data + uint64_t( full_blocks ) * 64, rest );
+         tail[ rest ] = 0x80;
+
+         uint64_t bits = uint64_t( size ) * 8;
+         for( int i = 0; i < 8; ++i )
+            tail[ tail_size - 1 - i ] = uint8_t( bits >> ( 8 * i ) );
+      }
+
+      const uint8_t* block( uint32_t b )const
+      {
+         return b < full_blocks ? data + uint64_t( b ) * 64 : tail + ( b - full_blocks ) * 64;
+      }
+   };
+
+   void store_digest( const uint32_t state[8], sha256& out )
+   {
+      uint8_t* d = (uint8_t*)out.data();
+      for( int i = 0; i < 8; ++i )
+      {
+         d[4*i]   = uint8_t( state[i] >> 24 );
+         d[4*i+1] = uint8_t( state[i] >> 16 );
+         d[4*i+2] = uint8_t( state[i] >> 8 );
+         d[4*i+3] = uint8_t( state[i] );
+      }
+   }
+
+   void hash_many_openssl( const char* const* data, const uint32_t* sizes, size_t count, sha256* out )
+   {
+      for( size_t i = 0; i < count; ++i )
+         SHA256( (const unsigned char*)data[i], sizes[i], (unsigned char*)out[i].data() );
+   }
+
+#ifdef FC_SHA256_X86
+
+   /**
+    *  SHA extensions. The rounds are latency bound, so two messages are interleaved to keep the
+    *  unit busy.
+    */
+   template< int N >
+   __attribute__((target("sha,sse4.1,ssse3")))
+   void shani_compress( uint32_t* states[N], const uint8_t* blocks[N] )
+   {
+      const __m128i byte_swap = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+
+      __m128i state0[N], state1[N], save0[N], save1[N], w[N][4];
+
+      for( int n = 0; n < N; ++n )
+      {
+         __m128i tmp = _mm_loadu_si128( (const __m128i*)&states[n][0] );
+         state1[n] = _mm_loadu_si128( (const __m128i*)&states[n][4] );
+         tmp = _mm_shuffle_epi32( tmp, 0xB1 );                       // CDAB
+         state1[n] = _mm_shuffle_epi32( state1[n], 0x1B );           // EFGH
+         state0[n] = _mm_alignr_epi8( tmp, state1[n], 8 );           // ABEF
+         state1[n] = _mm_blend_epi16( state1[n], tmp, 0xF0 );        // CDGH
+         save0[n] = state0[n];
+         save1[n] = state1[n];
+      }
+
+      for( int g = 0; g < 16; ++g )
+      {
+         const __m128i k = _mm_loadu_si128( (const __m128i*)&sha256_k[ 4 * g ] );
+
+         for( int n = 0; n < N; ++n )
+         {
+            __m128i& wg = w[n][ g & 3 ];
+            if( g < 4 )
+            {
+               wg = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)( blocks[n] + 16 * g ) ), byte_swap );
+            }
+            else
+            {
+               const __m128i& w1 = w[n][ ( g - 1 ) & 3 ];
+               const __m128i& w2 = w[n][ ( g - 2 ) & 3 ];
+               __m128i t = _mm_sha256msg1_epu32( wg, w[n][ ( g - 3 ) & 3 ] );
+               t = _mm_add_epi32( t, _mm_alignr_epi8( w1, w2, 4 ) );
+               wg = _mm_sha256msg2_epu32( t, w1 );
+            }
+
+            __m128i msg = _mm_add_epi32( wg, k );
+            state1[n] = _mm_sha256rnds2_epu32( state1[n], state0[n], msg );
+            msg = _mm_shuffle_epi32( msg, 0x0E );
+            state0[n] = _mm_sha256rnds2_epu32( state0[n], state1[n], msg );
+         }
+      }
+
+      for( int n = 0; n < N; ++n )
+      {
+         state0[n] = _mm_add_epi32( state0[n], save0[n] );
+         state1[n] = _mm_add_epi32( state1[n], save1[n] );
+
+         __m128i tmp = _mm_shuffle_epi32( state0[n], 0x1B );         // FEBA
+         state1[n] = _mm_shuffle_epi32( state1[n], 0xB1 );           // DCHG
+         state0[n] = _mm_blend_epi16( tmp, state1[n], 0xF0 );        // DCBA
+         state1[n] = _mm_alignr_epi8( state1[n], tmp, 8 );           // HGFE
+
+         _mm_storeu_si128( (__m128i*)&states[n][0], state0[n] );
+         _mm_storeu_si128( (__m128i*)&states[n][4], state1[n] );
+      }
+   }
+
+   void hash_many_shani( const padded_message* messages, const size_t* order, size_t count, sha256* out )
+   {
+      size_t i = 0;
+      for( ; i + 1 < count; i += 2 )
+      {
+         const padded_message* m[2] = { &messages[ order[i] ], &messages[ order[i+1] ] };
+         uint32_t state[2][8];
+         memcpy( state[0], sha256_initial_state, sizeof( sha256_initial_state ) );
+         memcpy( state[1], sha256_initial_state, sizeof( sha256_initial_state ) );
+         uint32_t* states[2] = { state[0], state[1] };
+
+         uint32_t common = std::min( m[0]->blocks, m[1]->blocks );
+         for( uint32_t b = 0; b < common; ++b )
+         {
+            const uint8_t* blocks[2] = { m[0]->block( b ), m[1]->block( b ) };
+            shani_compress< 2 >( states, blocks );
+         }
+
+         for( int n = 0; n < 2; ++n )
+         {
+            for( uint32_t b = common; b < m[n]->blocks; ++b )
+            {
+               const uint8_t* block = m[n]->block( b );
+               shani_compress< 1 >( &states[n], &block );
+            }
+            store_digest( state[n], out[ order[ i + n ] ] );
+         }
+      }
+
+      if( i < count )
+      {
+         const padded_message& m = messages[ order[i] ];
+         uint32_t state[8];
+         memcpy( state, sha256_initial_state, sizeof( sha256_initial_state ) );
+         uint32_t* s = state;
+         for( uint32_t b = 0; b < m.blocks; ++b )
+         {
+            const uint8_t* block = m.block( b );
+            shani_compress< 1 >( &s, &block );
+         }
+         store_digest( state, out[ order[i] ] );
+      }
+   }
+
+   uint32_t load_be32( const uint8_t* p )
+   {
+      uint32_t v;
+      memcpy( &v, p, sizeof( v ) );
+      return __builtin_bswap32( v );
+   }
+
+   #define FC_SHA256_AVX2 __attribute__((target("avx2")))
+
+   #define ROTR8( x, n ) _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) )
+
+   /// Eight messages at once, one per 32 bit lane
+   FC_SHA256_AVX2
+   void avx2_compress( __m256i state[8], const uint8_t* blocks[8] )
+   {
+      __m256i w[64];
+
+      for( int t = 0; t < 16; ++t )
+      {
+         w[t] = _mm256_set_epi32(
+            load_be32( blocks[7] + 4 * t ),
+            load_be32( blocks[6] + 4 * t ),
+            load_be32( blocks[5] + 4 * t ),
+            load_be32( blocks[4] + 4 * t ),
+            load_be32( blocks[3] + 4 * t ),
+            load_be32( blocks[2] + 4 * t ),
+            load_be32( blocks[1] + 4 * t ),
+            load_be32( blocks[0] + 4 * t ) );
+      }
+
+      for( int t = 16; t < 64; ++t )
+      {
+         __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( ROTR8( w[t-15], 7 ), ROTR8( w[t-15], 18 ) ), _mm256_srli_epi32( w[t-15], 3 ) );
+         __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( ROTR8( w[t-2], 17 ), ROTR8( w[t-2], 19 ) ), _mm256_srli_epi32( w[t-2], 10 ) );
+         w[t] = _mm256_add_epi32( _mm256_add_epi32( w[t-16], s0 ), _mm256_add_epi32( w[t-7], s1 ) );
+      }
+
+      __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+      __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+      for( int t = 0; t < 64; ++t )
+      {
+         __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( ROTR8( e, 6 ), ROTR8( e, 11 ) ), ROTR8( e, 25 ) );
+         __m256i ch = _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) );
+         __m256i t1 = _mm256_add_epi32( _mm256_add_epi32( h, s1 ),
+                         _mm256_add_epi32( ch, _mm256_add_epi32( _mm256_set1_epi32( sha256_k[t] ), w[t] ) ) );
+         __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( ROTR8( a, 2 ), ROTR8( a, 13 ) ), ROTR8( a, 22 ) );
+         __m256i maj = _mm256_or_si256( _mm256_and_si256( a, b ), _mm256_and_si256( c, _mm256_or_si256( a, b ) ) );
+         __m256i t2 = _mm256_add_epi32( s0, maj );
+
+         h = g; g = f; f = e;
+         e = _mm256_add_epi32( d, t1 );
+         d = c; c = b; b = a;
+         a = _mm256_add_epi32( t1, t2 );
+      }
+
+      state[0] = _mm256_add_epi32( state[0], a );
+      state[1] = _mm256_add_epi32( state[1], b );
+      state[2] = _mm256_add_epi32( state[2], c );
+      state[3] = _mm256_add_epi32( state[3], d );
+      state[4] = _mm256_add_epi32( state[4], e );
+      state[5] = _mm256_add_epi32( state[5], f );
+      state[6] = _mm256_add_epi32( state[6], g );
+      state[7] = _mm256_add_epi32( state[7], h );
+   }
+
+   #undef ROTR8
+
+   FC_SHA256_AVX2
+   void hash_many_avx2( const padded_message* messages, const size_t* order, size_t count, sha256* out )
+   {
+      for( size_t i = 0; i < count; i += 8 )
+      {
+         // Missing lanes of the last group repeat its first message and are not stored
+         size_t lanes = std::min< size_t >( 8, count - i );
+         const padded_message* m[8];
+         for( size_t n = 0; n < 8; ++n )
+            m[n] = &messages[ order[ i + ( n < lanes ? n : 0 ) ] ];
+
+         __m256i state[8];
+         for( int s = 0; s < 8; ++s )
+            state[s] = _mm256_set1_epi32( sha256_initial_state[s] );
+
+         uint32_t max_blocks = 0;
+         for( size_t n = 0; n < lanes; ++n )
+            max_blocks = std::max( max_blocks, m[n]->blocks );
+
+         for( uint32_t b = 0; b < max_blocks; ++b )
+         {
+            // Lanes already finished hash their last block again
+            const uint8_t* blocks[8];
+            for( size_t n = 0; n < 8; ++n )
+               blocks[n] = m[n]->block( std::min( b, m[n]->blocks - 1 ) );
+
+            avx2_compress( state, blocks );
+
+            for( size_t n = 0; n < lanes; ++n )
+            {
+               if( m[n]->blocks != b + 1 )
+                  continue;
+
+               uint32_t words[8][8];
+               for( int s = 0; s < 8; ++s )
+                  _mm256_storeu_si256( (__m256i*)words[s], state[s] );
+
+               uint32_t lane_state[8];
+               for( int s = 0; s < 8; ++s )
+                  lane_state[s] = words[s][n];
+               store_digest( lane_state, out[ order[ i + n ] ] );
+            }
+         }
+      }
+   }
+
+   bool supports_shani()
+   {
+      unsigned int eax, ebx, ecx, edx;
+      if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+         return false;
+
+      bool sse41 = ecx & bit_SSE4_1;
+      bool ssse3 = ecx & bit_SSSE3;
+
+      if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+         return false;
+
+      bool sha = ebx & ( 1u << 29 );
+      return sha && sse41 && ssse3;
+   }
+
+   bool supports_avx2()
+   {
+      unsigned int eax, ebx, ecx, edx;
+      if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+         return false;
+
+      bool osxsave = ecx & bit_OSXSAVE;
+      bool avx = ecx & bit_AVX;
+
+      if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+         return false;
+
+      bool avx2 = ebx & bit_AVX2;
+      if( !( avx2 && avx && osxsave ) )
+         return false;
+
+      // The OS must save the ymm registers across context switches
+      uint32_t xcr0_lo, xcr0_hi;
+      __asm__( "xgetbv" : "=a"( xcr0_lo ), "=d"( xcr0_hi ) : "c"( 0 ) );
+      return ( xcr0_lo & 0x6 ) == 0x6;
+   }
+
+   void hash_many_x86( sha256::hash_many_impl impl, const char* const* data, const uint32_t* sizes, size_t count, sha256* out )
+   {
+      std::vector< padded_message > messages( count );
+      std::vector< size_t > order( count );
+      for( size_t i = 0; i < count; ++i )
+      {
+         messages[i].init( data[i], sizes[i] );
+         order[i] = i;
+      }
+
+      // Messages hashed together should take the same number of blocks
+      std::stable_sort( order.begin(), order.end(),
+         [&]( size_t a, size_t b ) { return messages[a].blocks < messages[b].blocks; } );
+
+      if( impl == sha256::hash_many_impl::shani )
+         hash_many_shani( messages.data(), order.data(), count, out );
+      else
+         hash_many_avx2( messages.data(), order.data(), count, out );
+   }
+
+#endif // FC_SHA256_X86
+
+} // anonymous namespace
+
+bool sha256::hash_many_supported( hash_many_impl impl )
+{
+   switch( impl )
+   {
+      case hash_many_impl::openssl:
+         return true;
+#ifdef FC_SHA256_X86
+      case hash_many_impl::shani:
+         return supports_shani();
+      case hash_many_impl::avx2:
+         return supports_avx2();
+#endif
+      default:
+         return false;
+   }
+}
+
+void sha256::hash_many( hash_many_impl impl, const char* const* data, const uint32_t* sizes, size_t count, sha256* out )
+{
+   FC_ASSERT( hash_many_supported( impl ), "The CPU does not support this SHA-256 implementation" );
+
+#ifdef FC_SHA256_X86
+   if( impl != hash_many_impl::openssl )
+   {
+      hash_many_x86( impl, data, sizes, count, out );
+      return;
+   }
+#endif
+
+   hash_many_openssl( data, sizes, count, out );
+}
+
+void sha256::hash_many( const char* const* data, const uint32_t* sizes, size_t count, sha256* out )
+{
+   static const hash_many_impl impl = hash_many_supported( hash_many_impl::shani ) ? hash_many_impl::shani
+                                    : hash_many_supported( hash_many_impl::avx2 )  ? hash_many_impl::avx2
+                                    : hash_many_impl::openssl;
+
+   // A single message gains nothing from the multi buffer implementations
+   hash_many( count > 1 ? impl : hash_many_impl::openssl, data, sizes, count, out );
+}
+
+} // namespace fc
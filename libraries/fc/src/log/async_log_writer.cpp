@@ -0,0 +1,177 @@
+#include <fc/log/async_log_writer.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace fc
+{
+   namespace
+   {
+      /// Lines written between flushes, so a long backlog is not held back from the file
+      const size_t max_batch_size = 1024;
+
+      size_t round_up_to_power_of_two( uint32_t n )
+      {
+         size_t size = 2;
+         while( size < n )
+            size <<= 1;
+         return size;
+      }
+   }
+
+   async_log_writer::async_log_writer( uint32_t capacity, bool drop_when_full, write_function write, flush_function flush )
+      : _mask( round_up_to_power_of_two( capacity ) - 1 ),
+        _cells( new cell[ _mask + 1 ] ),
+        _drop_when_full( drop_when_full ),
+        _write( std::move( write ) ),
+        _flush( std::move( flush ) )
+   {
+      for( size_t i = 0; i <= _mask; ++i )
+         _cells[i].sequence.store( i, std::memory_order_relaxed );
+
+      _thread = std::thread( [this]() { run(); } );
+   }
+
+   async_log_writer::~async_log_writer()
+   {
+      _stopping = true;
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         _wakeup.notify_one();
+      }
+      _thread.join();
+   }
+
+   bool async_log_writer::try_push( std::string& line, log_level level )
+   {
+      size_t pos = _enqueue_pos.load( std::memory_order_relaxed );
+      cell* c;
+
+      for( ;; )
+      {
+         c = &_cells[ pos & _mask ];
+         size_t sequence = c->sequence.load( std::memory_order_acquire );
+         intptr_t diff = intptr_t( sequence ) - intptr_t( pos );
+
+         if( diff == 0 )
+         {
+            if( _enqueue_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+               break;
+         }
+         else if( diff < 0 )
+         {
+            // The writer has not yet taken the line queued a full lap ago
+            return false;
+         }
+         else
+         {
+            pos = _enqueue_pos.load( std::memory_order_relaxed );
+         }
+      }
+
+      c->line.swap( line );
+      c->level = level;
+      c->sequence.store( pos + 1, std::memory_order_release );
+      return true;
+   }
+
+   bool async_log_writer::pop( std::string& line, log_level& level )
+   {
+      cell& c = _cells[ _dequeue_pos & _mask ];
+      if( c.sequence.load( std::memory_order_acquire ) != _dequeue_pos + 1 )
+         return false;
+
+      line.swap( c.line );
+      c.line.clear();
+      level = c.level;
+      c.sequence.store( _dequeue_pos + _mask + 1, std::memory_order_release );
+      ++_dequeue_pos;
+      return true;
+   }
+
+   bool async_log_writer::push( std::string line, log_level level )
+   {
+      while( !try_push( line, level ) )
+      {
+         if( _drop_when_full )
+         {
+            _dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+         }
+
+         wake();
+         std::this_thread::yield();
+      }
+
+      wake();
+      return true;
+   }
+
+   void async_log_writer::wake()
+   {
+      // Pairs with the fence in run() so either the writer sees the line or we see it sleeping
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      if( _sleeping.load( std::memory_order_relaxed ) )
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         _wakeup.notify_one();
+      }
+   }
+
+   void async_log_writer::run()
+   {
+      std::string line;
+      log_level level;
+
+      for( ;; )
+      {
+         size_t written = 0;
+         try
+         {
+            while( written < max_batch_size && pop( line, level ) )
+            {
+               _write( line, level );
+               ++written;
+            }
+
+            uint64_t dropped = _dropped.load( std::memory_order_relaxed );
+            if( dropped != _reported_dropped )
+            {
+               _write( "Log buffer full, dropped " + std::to_string( dropped - _reported_dropped ) + " log messages", log_level::warn );
+               _reported_dropped = dropped;
+               ++written;
+            }
+
+            if( written )
+               _flush();
+         }
+         catch( const fc::exception& e )
+         {
+            std::cerr << "error writing log: " << e.to_detail_string() << "\n";
+         }
+         catch( const std::exception& e )
+         {
+            std::cerr << "error writing log: " << e.what() << "\n";
+         }
+
+         if( written )
+            continue;
+
+         if( _stopping )
+            return;
+
+         std::unique_lock< std::mutex > lock( _mutex );
+         _sleeping.store( true, std::memory_order_relaxed );
+         std::atomic_thread_fence( std::memory_order_seq_cst );
+
+         cell& next = _cells[ _dequeue_pos & _mask ];
+         if( next.sequence.load( std::memory_order_acquire ) != _dequeue_pos + 1 && !_stopping )
+            _wakeup.wait_for( lock, std::chrono::milliseconds( 100 ) );
+
+         _sleeping.store( false, std::memory_order_relaxed );
+      }
+   }
+
+} // namespace fc
@@ -1,5 +1,6 @@
 #include <fc/log/console_appender.hpp>
 #include <fc/log/log_message.hpp>
+#include <fc/log/async_log_writer.hpp>
 #include <fc/thread/unique_lock.hpp>
 #include <fc/string.hpp>
 #include <fc/variant.hpp>
@@ -22,11 +23,16 @@ namespace fc {
    public:
      config                      cfg;
      color::type                 lc[log_level::off+1];
+     std::unique_ptr< async_log_writer > writer;
 #ifdef WIN32
      HANDLE                      console_handle;
 #endif
    };
 
+   boost::mutex& log_mutex() {
+    static boost::mutex m; return m;
+   }
+
    console_appender::console_appender( const variant& args )
    :my(new impl)
    {
@@ -59,9 +65,28 @@ namespace fc {
             my->lc[i] = color::console_default;
          for( auto itr = my->cfg.level_colors.begin(); itr != my->cfg.level_colors.end(); ++itr )
             my->lc[itr->level] = itr->color;
+
+         my->writer.reset();
+         if( my->cfg.async )
+         {
+            my->writer.reset( new async_log_writer( my->cfg.async_queue_size, my->cfg.async_drop_when_full,
+               [this]( const string& line, log_level level ) { print_line( line, level, false ); },
+               [this]()
+               {
+                  if( my->cfg.flush )
+                  {
+                     fc::unique_lock<boost::mutex> lock(log_mutex());
+                     fflush( stream::std_error ? stderr : stdout );
+                  }
+               } ) );
+         }
    } FC_CAPTURE_AND_RETHROW( (console_appender_config) ) }
 
-   console_appender::~console_appender() {}
+   console_appender::~console_appender()
+   {
+      // Print what is still queued while the configuration is alive
+      my->writer.reset();
+   }
 
    #ifdef WIN32
    static WORD
@@ -83,16 +108,28 @@ namespace fc {
       }
    }
 
-   boost::mutex& log_mutex() {
-    static boost::mutex m; return m;
+   void console_appender::print_line( const std::string& line, log_level level, bool flush )
+   {
+      FILE* out = stream::std_error ? stderr : stdout;
+
+      fc::unique_lock<boost::mutex> lock(log_mutex());
+
+      print( line, my->lc[level], flush );
+
+      fprintf( out, "\n" );
+
+      if( flush ) fflush( out );
+   }
+
+   uint64_t console_appender::dropped_messages()const
+   {
+      return my->writer ? my->writer->dropped_messages() : 0;
    }
 
    void console_appender::log( const log_message& m ) {
       //fc::string message = fc::format_string( m.get_format(), m.get_data() );
       //fc::variant lmsg(m);
 
-      FILE* out = stream::std_error ? stderr : stdout;
-
       //fc::string fmt_str = fc::format_string( cfg.format, mutable_variant_object(m.get_context())( "message", message)  );
       std::stringstream file_line;
       file_line << m.get_context().get_file() <<":"<<m.get_context().get_line_number() <<" ";
@@ -119,16 +156,21 @@ namespace fc {
       fc::string message = fc::format_string( m.get_format(), m.get_data() );
       line << message;//.c_str();
 
-      fc::unique_lock<boost::mutex> lock(log_mutex());
-
-      print( line.str(), my->lc[m.get_context().get_log_level()] );
-
-      fprintf( out, "\n" );
+      if( my->writer )
+      {
+         my->writer->push( line.str(), m.get_context().get_log_level() );
+         return;
+      }
 
-      if( my->cfg.flush ) fflush( out );
+      print_line( line.str(), m.get_context().get_log_level(), my->cfg.flush );
    }
 
    void console_appender::print( const std::string& text, color::type text_color )
+   {
+      print( text, text_color, my->cfg.flush );
+   }
+
+   void console_appender::print( const std::string& text, color::type text_color, bool flush )
    {
       FILE* out = stream::std_error ? stderr : stdout;
 
@@ -149,7 +191,7 @@ namespace fc {
       if(isatty(fileno(out))) fprintf( out, "\r%s", CONSOLE_DEFAULT );
       #endif
 
-      if( my->cfg.flush ) fflush( out );
+      if( flush ) fflush( out );
    }
 
 }
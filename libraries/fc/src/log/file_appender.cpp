@@ -1,5 +1,6 @@
 #include <fc/exception/exception.hpp>
 #include <fc/io/fstream.hpp>
+#include <fc/log/async_log_writer.hpp>
 #include <fc/log/file_appender.hpp>
 #include <fc/reflect/variant.hpp>
 #include <fc/thread/scoped_lock.hpp>
@@ -19,6 +20,7 @@ namespace fc {
          config                     cfg;
          ofstream                   out;
          boost::mutex               slock;
+         std::unique_ptr< async_log_writer > writer;
 
       private:
          future<void>               _rotation_task;
@@ -48,6 +50,9 @@ namespace fc {
 
          ~impl()
          {
+            // Write out what is still queued before the file goes away
+            writer.reset();
+
             try
             {
               _rotation_task.cancel_and_wait("file_appender is destructing");
@@ -148,6 +153,23 @@ namespace fc {
          if(!my->cfg.rotate)
             my->out.open( my->cfg.filename, std::ios_base::out | std::ios_base::app);
 
+         if( my->cfg.async )
+         {
+            impl* i = my.get();
+            my->writer.reset( new async_log_writer( my->cfg.async_queue_size, my->cfg.async_drop_when_full,
+               [i]( const string& line, log_level )
+               {
+                  fc::scoped_lock<boost::mutex> lock( i->slock );
+                  i->out << line;
+               },
+               [i]()
+               {
+                  fc::scoped_lock<boost::mutex> lock( i->slock );
+                  if( i->cfg.flush )
+                     i->out.flush();
+               } ) );
+         }
+
       }
       catch( ... )
       {
@@ -188,12 +210,25 @@ namespace fc {
 
       // fc::string fmt_str = fc::format_string( my->cfg.format, mutable_variant_object(m.get_context())( "message", message)  );
 
+      line << "\t\t\t" << m.get_context().get_file() << ":" << m.get_context().get_line_number() << "\n";
+
+      if( my->writer )
+      {
+        my->writer->push( line.str(), m.get_context().get_log_level() );
+        return;
+      }
+
       {
         fc::scoped_lock<boost::mutex> lock( my->slock );
-        my->out << line.str() << "\t\t\t" << m.get_context().get_file() << ":" << m.get_context().get_line_number() << "\n";
+        my->out << line.str();
         if( my->cfg.flush )
           my->out.flush();
       }
    }
 
+   uint64_t file_appender::dropped_messages()const
+   {
+      return my->writer ? my->writer->dropped_messages() : 0;
+   }
+
 } // fc
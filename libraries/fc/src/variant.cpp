@@ -1,5 +1,6 @@
 #include <fc/variant.hpp>
 #include <fc/variant_object.hpp>
+#include <fc/variant_arena.hpp>
 #include <fc/exception/exception.hpp>
 #include <fc/io/sstream.hpp>
 #include <fc/io/json.hpp>
@@ -100,13 +101,13 @@ variant::variant( bool val )
 
 variant::variant( char* str )
 {
-   *reinterpret_cast<string**>(this)  = new string( str );
+   *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>( str );
    set_variant_type( this, string_type );
 }
 
 variant::variant( const char* str )
 {
-   *reinterpret_cast<string**>(this)  = new string( str );
+   *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>( str );
    set_variant_type( this, string_type );
 }
 
@@ -117,7 +118,7 @@ variant::variant( wchar_t* str )
    boost::scoped_array<char> buffer(new char[len]);
    for (unsigned i = 0; i < len; ++i)
      buffer[i] = (char)str[i];
-   *reinterpret_cast<string**>(this)  = new string(buffer.get(), len);
+   *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>(buffer.get(), len);
    set_variant_type( this, string_type );
 }
 
@@ -128,13 +129,13 @@ variant::variant( const wchar_t* str )
    boost::scoped_array<char> buffer(new char[len]);
    for (unsigned i = 0; i < len; ++i)
      buffer[i] = (char)str[i];
-   *reinterpret_cast<string**>(this)  = new string(buffer.get(), len);
+   *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>(buffer.get(), len);
    set_variant_type( this, string_type );
 }
 
 variant::variant( fc::string val )
 {
-   *reinterpret_cast<string**>(this)  = new string( fc::move(val) );
+   *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>( fc::move(val) );
    set_variant_type( this, string_type );
 }
 variant::variant( blob val )
@@ -145,18 +146,18 @@ variant::variant( blob val )
 
 variant::variant( variant_object obj)
 {
-   *reinterpret_cast<variant_object**>(this)  = new variant_object(fc::move(obj));
+   *reinterpret_cast<variant_object**>(this)  = detail::new_variant_node<variant_object>(fc::move(obj));
    set_variant_type(this,  object_type );
 }
 variant::variant( mutable_variant_object obj)
 {
-   *reinterpret_cast<variant_object**>(this)  = new variant_object(fc::move(obj));
+   *reinterpret_cast<variant_object**>(this)  = detail::new_variant_node<variant_object>(fc::move(obj));
    set_variant_type(this,  object_type );
 }
 
 variant::variant( variants arr )
 {
-   *reinterpret_cast<variants**>(this)  = new variants(fc::move(arr));
+   *reinterpret_cast<variants**>(this)  = detail::new_variant_node<variants>(fc::move(arr));
    set_variant_type(this,  array_type );
 }
 
@@ -171,13 +172,13 @@ void variant::clear()
    switch( get_type() )
    {
      case object_type:
-        delete *reinterpret_cast<variant_object**>(this);
+        detail::delete_variant_node( *reinterpret_cast<variant_object**>(this) );
         break;
      case array_type:
-        delete *reinterpret_cast<variants**>(this);
+        detail::delete_variant_node( *reinterpret_cast<variants**>(this) );
         break;
      case string_type:
-        delete *reinterpret_cast<string**>(this);
+        detail::delete_variant_node( *reinterpret_cast<string**>(this) );
         break;
      default:
         break;
@@ -191,17 +192,17 @@ variant::variant( const variant& v )
    {
        case object_type:
           *reinterpret_cast<variant_object**>(this)  =
-             new variant_object(**reinterpret_cast<const const_variant_object_ptr*>(&v));
+             detail::new_variant_node<variant_object>(**reinterpret_cast<const const_variant_object_ptr*>(&v));
           set_variant_type( this, object_type );
           return;
        case array_type:
           *reinterpret_cast<variants**>(this)  =
-             new variants(**reinterpret_cast<const const_variants_ptr*>(&v));
+             detail::new_variant_node<variants>(**reinterpret_cast<const const_variants_ptr*>(&v));
           set_variant_type( this,  array_type );
           return;
        case string_type:
           *reinterpret_cast<string**>(this)  =
-             new string(**reinterpret_cast<const const_string_ptr*>(&v) );
+             detail::new_variant_node<string>(**reinterpret_cast<const const_string_ptr*>(&v) );
           set_variant_type( this, string_type );
           return;
        default:
@@ -239,14 +240,14 @@ variant& variant::operator=( const variant& v )
    {
       case object_type:
          *reinterpret_cast<variant_object**>(this)  =
-            new variant_object((**reinterpret_cast<const const_variant_object_ptr*>(&v)));
+            detail::new_variant_node<variant_object>((**reinterpret_cast<const const_variant_object_ptr*>(&v)));
          break;
       case array_type:
          *reinterpret_cast<variants**>(this)  =
-            new variants((**reinterpret_cast<const const_variants_ptr*>(&v)));
+            detail::new_variant_node<variants>((**reinterpret_cast<const const_variants_ptr*>(&v)));
          break;
       case string_type:
-         *reinterpret_cast<string**>(this)  = new string((**reinterpret_cast<const const_string_ptr*>(&v)) );
+         *reinterpret_cast<string**>(this)  = detail::new_variant_node<string>((**reinterpret_cast<const const_string_ptr*>(&v)) );
          break;
 
       default:
@@ -0,0 +1,123 @@
+#include <fc/variant_arena.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace fc
+{
+   namespace detail
+   {
+      /**
+       *  Blocks count one reference for the arena carving from them plus one per live node, and are
+       *  freed by whoever drops the last one.
+       */
+      struct variant_arena_block
+      {
+         std::atomic< uint64_t > references{ 1 };
+         char*                   next;
+         char*                   end;
+      };
+   }
+
+   namespace
+   {
+      using detail::variant_arena_block;
+
+      /// Every allocation is preceded by the block it was carved from, or null when it came from the heap
+      const size_t header_size = 16;
+      static_assert( sizeof( variant_arena_block* ) <= header_size, "header too small" );
+
+      const size_t block_header_size = ( sizeof( variant_arena_block ) + header_size - 1 ) & ~( header_size - 1 );
+
+      thread_local variant_arena* current_arena = nullptr;
+
+      size_t round_up( size_t size )
+      {
+         return ( size + header_size - 1 ) & ~( header_size - 1 );
+      }
+
+      variant_arena_block* new_block( size_t block_size )
+      {
+         char* memory = static_cast< char* >( ::operator new( block_header_size + block_size ) );
+         auto b = new( memory ) variant_arena_block();
+         b->next = memory + block_header_size;
+         b->end = b->next + block_size;
+         return b;
+      }
+
+      void release( variant_arena_block* b )
+      {
+         if( b->references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+         {
+            b->~variant_arena_block();
+            ::operator delete( b );
+         }
+      }
+   }
+
+   variant_arena::variant_arena( size_t block_size )
+      : _block_size( round_up( block_size ) ), _owner( current_arena == nullptr )
+   {
+      if( _owner )
+         current_arena = this;
+   }
+
+   variant_arena::~variant_arena()
+   {
+      if( !_owner )
+         return;
+
+      current_arena = nullptr;
+      if( _block )
+         release( _block );
+   }
+
+   bool variant_arena::active()
+   {
+      return current_arena != nullptr;
+   }
+
+   void* variant_arena::allocate( size_t size )
+   {
+      size_t total = header_size + round_up( size );
+      variant_arena* arena = current_arena;
+
+      // Large allocations would waste most of a block, so they always come from the heap
+      if( arena == nullptr || total > arena->_block_size / 4 )
+      {
+         char* p = static_cast< char* >( ::operator new( total ) );
+         *reinterpret_cast< variant_arena_block** >( p ) = nullptr;
+         return p + header_size;
+      }
+
+      variant_arena_block* b = arena->_block;
+      if( b == nullptr || size_t( b->end - b->next ) < total )
+      {
+         if( b )
+            release( b );
+         b = arena->_block = new_block( arena->_block_size );
+      }
+
+      char* p = b->next;
+      b->next += total;
+      b->references.fetch_add( 1, std::memory_order_relaxed );
+
+      *reinterpret_cast< variant_arena_block** >( p ) = b;
+      return p + header_size;
+   }
+
+   void variant_arena::deallocate( void* p )
+   {
+      if( p == nullptr )
+         return;
+
+      char* header = static_cast< char* >( p ) - header_size;
+      variant_arena_block* b = *reinterpret_cast< variant_arena_block** >( header );
+
+      if( b == nullptr )
+         ::operator delete( header );
+      else
+         release( b );
+   }
+
+} // namespace fc
@@ -95,13 +95,24 @@ namespace fc
       return _key_value->size();
    }
 
+   std::shared_ptr< variant_object::entry_vector > variant_object::make_entries()
+   {
+      return std::allocate_shared< entry_vector >( detail::variant_allocator< entry_vector >() );
+   }
+
+   const std::shared_ptr< variant_object::entry_vector >& variant_object::empty_entries()
+   {
+      static const std::shared_ptr< entry_vector > empty = std::make_shared< entry_vector >();
+      return empty;
+   }
+
    variant_object::variant_object() 
-      :_key_value(std::make_shared<std::vector<entry>>() )
+      :_key_value( empty_entries() )
    {
    }
 
    variant_object::variant_object( string key, variant val )
-      : _key_value(std::make_shared<std::vector<entry>>())
+      : _key_value( make_entries() )
    {
        //_key_value->push_back(entry(fc::move(key), fc::move(val)));
        _key_value->emplace_back(entry(fc::move(key), fc::move(val)));
@@ -116,17 +127,19 @@ namespace fc
    variant_object::variant_object( variant_object&& obj)
    : _key_value( fc::move(obj._key_value) )
    {
-      obj._key_value = std::make_shared<std::vector<entry>>();
+      obj._key_value = empty_entries();
       assert( _key_value != nullptr );
    }
 
    variant_object::variant_object( const mutable_variant_object& obj )
-      : _key_value(std::make_shared<std::vector<entry>>(*obj._key_value))
+      : _key_value( std::allocate_shared< entry_vector >( detail::variant_allocator< entry_vector >(), *obj._key_value ) )
    {
    }
 
+   // A moved-from mutable_variant_object has no entries at all
    variant_object::variant_object( mutable_variant_object&& obj )
-   : _key_value(fc::move(obj._key_value))
+   : _key_value( obj._key_value ? std::allocate_shared< entry_vector >( detail::variant_allocator< entry_vector >(), fc::move( *obj._key_value ) )
+                                : empty_entries() )
    {
       assert( _key_value != nullptr );
    }
@@ -152,14 +165,21 @@ namespace fc
 
    variant_object& variant_object::operator=( mutable_variant_object&& obj )
    {
-      _key_value = fc::move(obj._key_value);
-      obj._key_value.reset( new std::vector<entry>() );
+      if( !obj._key_value )
+      {
+         _key_value = empty_entries();
+         return *this;
+      }
+
+      _key_value = std::allocate_shared< entry_vector >( detail::variant_allocator< entry_vector >(), fc::move( *obj._key_value ) );
+      obj._key_value->clear();
       return *this;
    }
 
    variant_object& variant_object::operator=( const mutable_variant_object& obj )
    {
-      *_key_value = *obj._key_value;
+      // The entries may be shared with other objects
+      _key_value = std::allocate_shared< entry_vector >( detail::variant_allocator< entry_vector >(), *obj._key_value );
       return *this;
    }
 
@@ -261,23 +281,23 @@ namespace fc
    }
 
    mutable_variant_object::mutable_variant_object() 
-      :_key_value(new std::vector<entry>)
+      :_key_value( detail::new_variant_node< variant_object::entry_vector >() )
    {
    }
 
    mutable_variant_object::mutable_variant_object( string key, variant val )
-      : _key_value(new std::vector<entry>())
+      : _key_value( detail::new_variant_node< variant_object::entry_vector >() )
    {
        _key_value->push_back(entry(fc::move(key), fc::move(val)));
    }
 
    mutable_variant_object::mutable_variant_object( const variant_object& obj )
-      : _key_value( new std::vector<entry>(*obj._key_value) )
+      : _key_value( detail::new_variant_node< variant_object::entry_vector >( *obj._key_value ) )
    {
    }
 
    mutable_variant_object::mutable_variant_object( const mutable_variant_object& obj )
-      : _key_value( new std::vector<entry>(*obj._key_value) )
+      : _key_value( detail::new_variant_node< variant_object::entry_vector >( *obj._key_value ) )
    {
    }
 
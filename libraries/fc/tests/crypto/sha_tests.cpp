@@ -8,7 +8,11 @@
 #include <fc/crypto/sha512.hpp>
 #include <fc/exception/exception.hpp>
 
+#include <openssl/sha.h>
+
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 // SHA test vectors taken from http://www.di-mgt.com.au/sha_testvectors.html
 static const std::string TEST1("abc");
@@ -157,6 +161,93 @@ BOOST_AUTO_TEST_CASE(sha256_test)
     BOOST_CHECK_EQUAL( "d61967f63c7dd183914a4ae452c9f6ad5d462ce3d277798075b107615c1a8a30", (std::string) fc::sha256::hash(fourth) );
 }
 
+BOOST_AUTO_TEST_CASE(sha256_hash_many_test)
+{
+    // Every length up to a few blocks, so messages of different block counts are hashed together
+    std::vector<std::string> messages;
+    for( uint32_t len = 0; len < 300; ++len )
+    {
+        std::string m( len, 0 );
+        for( uint32_t i = 0; i < len; ++i )
+            m[i] = char( len * 31 + i );
+        messages.push_back( m );
+    }
+    messages.push_back( TEST4 );
+    messages.push_back( TEST3 );
+
+    std::vector<const char*> data;
+    std::vector<uint32_t> sizes;
+    for( const auto& m : messages )
+    {
+        data.push_back( m.data() );
+        sizes.push_back( m.size() );
+    }
+
+    std::vector<fc::sha256> digests( messages.size() );
+    fc::sha256::hash_many( data.data(), sizes.data(), messages.size(), digests.data() );
+
+    for( size_t i = 0; i < messages.size(); ++i )
+        BOOST_CHECK_EQUAL( digests[i].str(), fc::sha256::hash( messages[i] ).str() );
+
+    fc::sha256::hash_many( data.data(), sizes.data(), 1, digests.data() );
+    BOOST_CHECK_EQUAL( digests[0].str(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" );
+    fc::sha256::hash_many( nullptr, nullptr, 0, nullptr );
+}
+
+BOOST_AUTO_TEST_CASE(sha256_hash_many_impl_test)
+{
+    std::vector<std::string> messages;
+    for( uint32_t len = 0; len < 400; ++len )
+    {
+        std::string m( len, 0 );
+        for( uint32_t i = 0; i < len; ++i )
+            m[i] = char( len * 17 + i * 3 );
+        messages.push_back( m );
+    }
+
+    std::vector<const char*> data;
+    std::vector<uint32_t> sizes;
+    std::vector<fc::sha256> expected( messages.size() );
+    for( size_t i = 0; i < messages.size(); ++i )
+    {
+        data.push_back( messages[i].data() );
+        sizes.push_back( messages[i].size() );
+        SHA256( (const unsigned char*)messages[i].data(), messages[i].size(), (unsigned char*)expected[i].data() );
+    }
+
+    const std::pair< fc::sha256::hash_many_impl, const char* > impls[] = {
+        { fc::sha256::hash_many_impl::openssl, "openssl" },
+        { fc::sha256::hash_many_impl::shani,   "shani" },
+        { fc::sha256::hash_many_impl::avx2,    "avx2" } };
+
+    for( const auto& impl : impls )
+    {
+        if( !fc::sha256::hash_many_supported( impl.first ) )
+        {
+            BOOST_TEST_MESSAGE( std::string( "Skipping unsupported implementation " ) + impl.second );
+            continue;
+        }
+
+        BOOST_TEST_MESSAGE( std::string( "Testing implementation " ) + impl.second );
+
+        // All lengths at once, then in batches that leave some lanes empty
+        for( size_t batch : { messages.size(), size_t( 1 ), size_t( 3 ), size_t( 7 ), size_t( 9 ) } )
+        {
+            std::vector<fc::sha256> digests( messages.size() );
+            for( size_t i = 0; i < messages.size(); i += batch )
+            {
+                size_t count = std::min( batch, messages.size() - i );
+                fc::sha256::hash_many( impl.first, data.data() + i, sizes.data() + i, count, digests.data() + i );
+            }
+
+            for( size_t i = 0; i < messages.size(); ++i )
+                BOOST_CHECK_EQUAL( digests[i].str(), expected[i].str() );
+        }
+
+        fc::sha256::hash_many( impl.first, nullptr, nullptr, 0, nullptr );
+    }
+}
+
 BOOST_AUTO_TEST_CASE(sha512_test)
 {
     init_5();
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/log/async_log_writer.hpp>
+#include <fc/log/file_appender.hpp>
+#include <fc/reflect/variant.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(fc)
+
+BOOST_AUTO_TEST_CASE(async_log_writer_test)
+{
+   const uint32_t threads = 4;
+   const uint32_t lines_per_thread = 10000;
+
+   std::mutex mutex;
+   std::vector< std::vector< uint32_t > > received( threads );
+   uint32_t flushes = 0;
+   std::atomic< uint32_t > failed_pushes( 0 );
+
+   {
+      fc::async_log_writer writer( 64, false,
+         [&]( const std::string& line, fc::log_level )
+         {
+            auto space = line.find( ' ' );
+            std::lock_guard< std::mutex > lock( mutex );
+            received[ std::stoul( line.substr( 0, space ) ) ].push_back( std::stoul( line.substr( space + 1 ) ) );
+         },
+         [&]() { ++flushes; } );
+
+      std::vector< std::thread > producers;
+      for( uint32_t t = 0; t < threads; ++t )
+      {
+         producers.emplace_back( [&writer, &failed_pushes, t, lines_per_thread]()
+         {
+            for( uint32_t i = 0; i < lines_per_thread; ++i )
+               if( !writer.push( std::to_string( t ) + " " + std::to_string( i ), fc::log_level::info ) )
+                  ++failed_pushes;
+         } );
+      }
+
+      for( auto& p : producers )
+         p.join();
+   }
+
+   // Waiting when full loses nothing and keeps the order of each producer
+   BOOST_REQUIRE_EQUAL( failed_pushes.load(), 0u );
+   for( uint32_t t = 0; t < threads; ++t )
+   {
+      BOOST_REQUIRE_EQUAL( received[t].size(), lines_per_thread );
+      for( uint32_t i = 0; i < lines_per_thread; ++i )
+         BOOST_REQUIRE_EQUAL( received[t][i], i );
+   }
+   BOOST_CHECK( flushes > 0 );
+   BOOST_CHECK( flushes < threads * lines_per_thread );
+}
+
+BOOST_AUTO_TEST_CASE(async_log_writer_drop_test)
+{
+   std::mutex blocked;
+   std::unique_lock< std::mutex > block_writer( blocked );
+   std::vector< std::string > lines;
+
+   fc::async_log_writer writer( 4, true,
+      [&]( const std::string& line, fc::log_level )
+      {
+         std::lock_guard< std::mutex > lock( blocked );
+         lines.push_back( line );
+      },
+      [](){} );
+
+   uint32_t pushed = 0;
+   for( uint32_t i = 0; i < 100; ++i )
+      pushed += writer.push( std::to_string( i ), fc::log_level::info ) ? 1 : 0;
+
+   BOOST_REQUIRE_EQUAL( pushed + writer.dropped_messages(), 100u );
+   BOOST_REQUIRE( writer.dropped_messages() > 0 );
+
+   block_writer.unlock();
+   for( ;; )
+   {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+      std::lock_guard< std::mutex > lock( blocked );
+      if( lines.size() == pushed + 1 )
+         break;
+   }
+
+   std::lock_guard< std::mutex > lock( blocked );
+   BOOST_REQUIRE_EQUAL( lines.back(), "Log buffer full, dropped " + std::to_string( writer.dropped_messages() ) + " log messages" );
+}
+
+BOOST_AUTO_TEST_CASE(async_file_appender_test)
+{
+   fc::temp_directory dir( fc::temp_directory_path() );
+
+   fc::file_appender::config cfg( dir.path() / "async.log" );
+   cfg.async = true;
+   cfg.async_drop_when_full = false;
+
+   {
+      fc::variant args( cfg );
+      fc::file_appender appender( args );
+      for( uint32_t i = 0; i < 1000; ++i )
+         appender.log( FC_LOG_MESSAGE( info, "message ${i}", ("i", i) ) );
+      BOOST_REQUIRE_EQUAL( appender.dropped_messages(), 0u );
+   }
+
+   std::string contents;
+   fc::read_file_contents( dir.path() / "async.log", contents );
+   BOOST_REQUIRE_EQUAL( std::count( contents.begin(), contents.end(), '\n' ), 1000 );
+   BOOST_REQUIRE( contents.find( "message 999" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -45,6 +45,51 @@ namespace graphene { namespace net {
   const core_message_type_enum check_firewall_reply_message::type            = core_message_type_enum::check_firewall_reply_message_type;
   const core_message_type_enum get_current_connections_request_message::type = core_message_type_enum::get_current_connections_request_message_type;
   const core_message_type_enum get_current_connections_reply_message::type   = core_message_type_enum::get_current_connections_reply_message_type;
+  const core_message_type_enum compact_block_message::type                   = core_message_type_enum::compact_block_message_type;
+  const core_message_type_enum fetch_compact_block_transactions_message::type = core_message_type_enum::fetch_compact_block_transactions_message_type;
+  const core_message_type_enum compact_block_transactions_message::type      = core_message_type_enum::compact_block_transactions_message_type;
+
+  compact_block_message make_compact_block_message( const block_message& block_message_to_compact, const item_hash_t& item_hash,
+                                                    const std::function<bool(const transaction_id_type&)>& is_known_transaction )
+  {
+    compact_block_message compact_block;
+    compact_block.item_hash = item_hash;
+    compact_block.header = block_message_to_compact.block;
+    compact_block.block_id = block_message_to_compact.block_id;
+
+    const auto& transactions = block_message_to_compact.block.transactions;
+    compact_block.short_transaction_ids.reserve( transactions.size() );
+    for( uint32_t i = 0; i < transactions.size(); ++i )
+    {
+      transaction_id_type transaction_id = transactions[i].id();
+      compact_block.short_transaction_ids.push_back( get_short_transaction_id( transaction_id ) );
+
+      if( !is_known_transaction( transaction_id ) )
+        compact_block.prefilled_transactions.push_back( prefilled_transaction{ i, transactions[i] } );
+    }
+
+    return compact_block;
+  }
+
+  fc::optional<block_message> reconstruct_compact_block( const compact_block_message& compact_block,
+                                                         std::vector<fc::optional<signed_transaction> >&& transactions )
+  {
+    block_message reconstructed_block;
+    static_cast<freezone::protocol::signed_block_header&>( reconstructed_block.block ) = compact_block.header;
+    reconstructed_block.block.transactions.reserve( transactions.size() );
+    for( fc::optional<signed_transaction>& transaction : transactions )
+    {
+      FC_ASSERT( transaction.valid(), "Compact block is missing a transaction" );
+      reconstructed_block.block.transactions.push_back( std::move( *transaction ) );
+    }
+    reconstructed_block.block_id = compact_block.block_id;
+
+    // a short id collision or a transaction with different signatures produces a different merkle root
+    if( reconstructed_block.block.calculate_merkle_root() != reconstructed_block.block.transaction_merkle_root )
+      return fc::optional<block_message>();
+
+    return reconstructed_block;
+  }
 
 } } // graphene::net
 
@@ -68,6 +68,20 @@
  */
 #define GRAPHENE_NET_MESSAGE_CACHE_DURATION_IN_BLOCKS        20
 
+/**
+ * Version of the compact block relay protocol announced in the hello message's
+ * user_data.  Peers that don't announce it are always sent full blocks.
+ */
+#define GRAPHENE_NET_COMPACT_BLOCKS_VERSION                  1
+
+/**
+ * Most compact blocks we keep per peer while waiting for their missing transactions,
+ * and how long we wait for the transactions before dropping the block.  The request
+ * for the block itself times out on its own and is rescheduled with another peer.
+ */
+#define GRAPHENE_NET_MAX_COMPACT_BLOCKS_PER_PEER             2
+#define GRAPHENE_NET_COMPACT_BLOCK_TIMEOUT_SECONDS           6
+
 /**
  * We prevent a peer from offering us a list of blocks which, if we fetched them
  * all, would result in a blockchain that extended into the future.
@@ -94,6 +108,20 @@
  */
 #define GRAPHENE_NET_MAX_ITEMS_PER_PEER_DURING_NORMAL_OPERATION  1
 
+/**
+ * The most transactions received from the network that will be passed to the
+ * client in one call.  Transactions that arrive while the client is busy are
+ * queued and handed over together.
+ */
+#define GRAPHENE_NET_MAX_TRANSACTIONS_PER_BATCH              1000
+
+/**
+ * How long new transaction inventory is held back so that transactions arriving
+ * in a burst are advertised to each peer in one message.  Inventory containing a
+ * block is advertised immediately.
+ */
+#define GRAPHENE_NET_INVENTORY_AGGREGATION_INTERVAL_MS       50
+
 /**
  * Instead of fetching all item IDs from a peer, then fetching all blocks
  * from a peer, we will interleave them.  Fetch at least this many block IDs,
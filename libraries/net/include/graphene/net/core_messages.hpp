@@ -35,8 +35,11 @@
 #include <fc/variant_object.hpp>
 #include <fc/exception/exception.hpp>
 #include <fc/io/enum_type.hpp>
+#include <fc/optional.hpp>
 
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace graphene { namespace net {
@@ -86,11 +89,27 @@ namespace graphene { namespace net {
     check_firewall_reply_message_type            = 5015,
     get_current_connections_request_message_type = 5016,
     get_current_connections_reply_message_type   = 5017,
+    compact_block_message_type                   = 5018,
+    fetch_compact_block_transactions_message_type = 5019,
+    compact_block_transactions_message_type      = 5020,
     core_message_type_last                       = 5099
   };
 
   const uint32_t core_protocol_version = GRAPHENE_NET_PROTOCOL_VERSION;
 
+  using freezone::protocol::signed_block_header;
+
+  /**
+   * Short transaction id used by compact blocks: the first 8 bytes of the transaction id.
+   * Collisions are harmless, a reconstructed block is checked against its merkle root.
+   */
+  inline uint64_t get_short_transaction_id( const transaction_id_type& id )
+  {
+    uint64_t short_id;
+    memcpy( &short_id, id.data(), sizeof( short_id ) );
+    return short_id;
+  }
+
    struct trx_message
    {
       static const core_message_type_enum type;
@@ -113,8 +132,71 @@ namespace graphene { namespace net {
       signed_block    block;
       block_id_type   block_id;
 
+      /// Set by node_delegate::prevalidate_block() and shared by every copy of the message, not serialized
+      std::shared_ptr< void > prevalidation;
    };
 
+  struct prefilled_transaction
+  {
+    uint32_t           index = 0;
+    signed_transaction trx;
+  };
+
+  /**
+   * Sent instead of a block_message in reply to a fetch_items_message to peers that
+   * announced compact block support in their hello user_data. The receiver rebuilds
+   * the block from transactions it has already seen as trx_messages and fetches the
+   * rest with a fetch_compact_block_transactions_message.
+   */
+  struct compact_block_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                          item_hash; // hash of the full block_message, the item the receiver requested
+    signed_block_header                  header;
+    block_id_type                        block_id;
+    std::vector<uint64_t>                short_transaction_ids;
+    std::vector<prefilled_transaction>   prefilled_transactions;
+
+    compact_block_message() {}
+  };
+
+  struct fetch_compact_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    block_id_type         block_id;
+    std::vector<uint32_t> transaction_indexes;
+
+    fetch_compact_block_transactions_message() {}
+    fetch_compact_block_transactions_message(const block_id_type& block_id, std::vector<uint32_t> transaction_indexes) :
+      block_id(block_id),
+      transaction_indexes(std::move(transaction_indexes))
+    {}
+  };
+
+  struct compact_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    block_id_type                        block_id;
+    std::vector<prefilled_transaction>   transactions;
+  };
+
+  /**
+   * Builds the compact form of a block.  Transactions for which is_known_transaction returns
+   * false are unlikely to be known by the peer and are sent along in full.
+   */
+  compact_block_message make_compact_block_message( const block_message& block_message_to_compact, const item_hash_t& item_hash,
+                                                    const std::function<bool(const transaction_id_type&)>& is_known_transaction );
+
+  /**
+   * Rebuilds the block_message a compact block was made from, given every one of its transactions.
+   * Returns an empty optional if the transactions don't match the block's merkle root.
+   */
+  fc::optional<block_message> reconstruct_compact_block( const compact_block_message& compact_block,
+                                                         std::vector<fc::optional<signed_transaction> >&& transactions );
+
   struct item_ids_inventory_message
   {
     static const core_message_type_enum type;
@@ -421,10 +503,17 @@ FC_REFLECT_ENUM( graphene::net::core_message_type_enum,
                  (check_firewall_reply_message_type)
                  (get_current_connections_request_message_type)
                  (get_current_connections_reply_message_type)
+                 (compact_block_message_type)
+                 (fetch_compact_block_transactions_message_type)
+                 (compact_block_transactions_message_type)
                  (core_message_type_last) )
 
 FC_REFLECT( graphene::net::trx_message, (trx) )
 FC_REFLECT( graphene::net::block_message, (block)(block_id) )
+FC_REFLECT( graphene::net::prefilled_transaction, (index)(trx) )
+FC_REFLECT( graphene::net::compact_block_message, (item_hash)(header)(block_id)(short_transaction_ids)(prefilled_transactions) )
+FC_REFLECT( graphene::net::fetch_compact_block_transactions_message, (block_id)(transaction_indexes) )
+FC_REFLECT( graphene::net::compact_block_transactions_message, (block_id)(transactions) )
 
 FC_REFLECT( graphene::net::item_id, (item_type)
                                (item_hash) )
@@ -84,6 +84,17 @@ namespace graphene { namespace net {
          virtual bool handle_block( const graphene::net::block_message& blk_msg, bool sync_mode,
                                     std::vector<fc::uint160_t>& contained_transaction_message_ids ) = 0;
 
+         /**
+          *  @brief Called when a sync block is received, before it is queued to be passed to handle_block.
+          *
+          *  Gives the client a chance to start validating the parts of the block that do not depend on
+          *  chain state while earlier blocks are still being handled. Must not block.
+          *
+          *  The client may keep its results in blk_msg.prevalidation, which is passed back to
+          *  handle_block with the message.
+          */
+         virtual void prevalidate_block( graphene::net::block_message& blk_msg ) {}
+
          /**
           *  @brief Called when a new transaction comes in from the network
           *
@@ -92,6 +103,36 @@ namespace graphene { namespace net {
           */
          virtual void handle_transaction( const graphene::net::trx_message& trx_msg ) = 0;
 
+         /**
+          *  @brief Called with transactions that have arrived from the network since the previous call
+          *
+          *  Lets the client validate many transactions at the cost of one.  By default each transaction
+          *  is passed to handle_transaction() in turn.
+          *
+          *  @returns one entry per transaction, empty if the transaction is valid and safe to broadcast
+          *           on, otherwise the error validating it
+          */
+         virtual std::vector< fc::oexception > handle_transactions( const std::vector< graphene::net::trx_message >& trx_msgs )
+         {
+            std::vector< fc::oexception > results( trx_msgs.size() );
+            for( size_t i = 0; i < trx_msgs.size(); ++i )
+            {
+               try
+               {
+                  handle_transaction( trx_msgs[i] );
+               }
+               catch( const fc::canceled_exception& )
+               {
+                  throw;
+               }
+               catch( const fc::exception& e )
+               {
+                  results[i] = e;
+               }
+            }
+            return results;
+         }
+
          /**
           *  @brief Called when a new message comes in from the network other than a
           *         block or a transaction.  Currently there are no other possible
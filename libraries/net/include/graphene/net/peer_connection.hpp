@@ -208,6 +208,7 @@ namespace graphene { namespace net
       fc::optional<std::string> platform;
       fc::optional<uint32_t> bitness;
       fc::optional<freezone::protocol::chain_id_type> chain_id;
+      bool supports_compact_blocks = false;
 
       // for inbound connections, these fields record what the peer sent us in
       // its hello message.  For outbound, they record what we sent the peer
@@ -259,6 +260,16 @@ namespace graphene { namespace net
       timestamped_items_set_type inventory_advertised_to_peer;
 
       item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+
+      /** a compact block received from this peer that is waiting for the transactions we couldn't find locally */
+      struct partial_compact_block
+      {
+        compact_block_message                            compact_block;
+        std::vector<fc::optional<signed_transaction> >   transactions;
+        bool                                             requested_all_transactions = false;
+        fc::time_point                                   received_time;
+      };
+      std::map<block_id_type, partial_compact_block> compact_blocks_being_reconstructed;
       /// @}
 
       // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
@@ -133,6 +133,7 @@ namespace graphene { namespace net {
 
       struct message_hash_index{};
       struct message_contents_hash_index{};
+      struct short_transaction_id_index{};
       struct block_clock_index{};
       struct message_info
       {
@@ -143,6 +144,7 @@ namespace graphene { namespace net {
         // for network performance stats
         message_propagation_data propagation_data;
         fc::uint160_t     message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is the transaction id, if it's a block, it's the block_id)
+        uint64_t          short_transaction_id; // used to rebuild compact blocks, zero for anything but transactions
 
         message_info( const message_hash_type& message_hash,
                       const message&           message_body,
@@ -153,7 +155,8 @@ namespace graphene { namespace net {
           message_body( message_body ),
           block_clock_when_received( block_clock_when_received ),
           propagation_data( propagation_data ),
-          message_contents_hash( message_contents_hash )
+          message_contents_hash( message_contents_hash ),
+          short_transaction_id( message_body.msg_type == trx_message_type ? get_short_transaction_id( message_contents_hash ) : 0 )
         {}
       };
       typedef boost::multi_index_container
@@ -162,6 +165,8 @@ namespace graphene { namespace net {
                                                   bmi::member<message_info, message_hash_type, &message_info::message_hash> >,
                              bmi::ordered_non_unique< bmi::tag<message_contents_hash_index>,
                                                       bmi::member<message_info, fc::uint160_t, &message_info::message_contents_hash> >,
+                             bmi::hashed_non_unique< bmi::tag<short_transaction_id_index>,
+                                                     bmi::member<message_info, uint64_t, &message_info::short_transaction_id> >,
                              bmi::ordered_non_unique< bmi::tag<block_clock_index>,
                                                       bmi::member<message_info, uint32_t, &message_info::block_clock_when_received> > >
         > message_cache_container;
@@ -179,6 +184,8 @@ namespace graphene { namespace net {
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
       message get_message( const message_hash_type& hash_of_message_to_lookup );
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
+      fc::optional<signed_transaction> find_transaction( uint64_t short_transaction_id ) const;
+      bool contains_transaction( const transaction_id_type& transaction_id ) const;
       size_t size() const { return _message_cache.size(); }
     };
 
@@ -223,6 +230,30 @@ namespace graphene { namespace net {
       FC_THROW_EXCEPTION(  fc::key_not_found_exception, "Requested message not in cache" );
     }
 
+    fc::optional<signed_transaction> blockchain_tied_message_cache::find_transaction( uint64_t short_transaction_id ) const
+    {
+      fc::optional<signed_transaction> result;
+      if( short_transaction_id == 0 )
+        return result;
+
+      // the same transaction may be cached more than once, but if two different transactions
+      // share a short id we can't tell which one the block contains, so treat it as missing
+      auto range = _message_cache.get<short_transaction_id_index>().equal_range( short_transaction_id );
+      for( auto iter = range.first; iter != range.second; ++iter )
+      {
+        if( result && fc::uint160_t( result->id() ) != iter->message_contents_hash )
+          return fc::optional<signed_transaction>();
+        if( !result )
+          result = iter->message_body.as<trx_message>().trx;
+      }
+      return result;
+    }
+
+    bool blockchain_tied_message_cache::contains_transaction( const transaction_id_type& transaction_id ) const
+    {
+      return _message_cache.get<message_contents_hash_index>().find( transaction_id ) != _message_cache.get<message_contents_hash_index>().end();
+    }
+
     // when requesting items from peers, we want to prioritize any blocks before
     // transactions, but otherwise request items in the order we heard about them
     struct prioritized_item_id
@@ -262,6 +293,7 @@ namespace graphene { namespace net {
                                    (handle_message) \
                                    (handle_block) \
                                    (handle_transaction) \
+                                   (handle_transactions) \
                                    (get_block_ids) \
                                    (get_item) \
                                    (get_blockchain_synopsis) \
@@ -357,7 +389,9 @@ namespace graphene { namespace net {
       bool has_item( const net::item_id& id ) override;
       void handle_message( const message& ) override;
       bool handle_block( const graphene::net::block_message& block_message, bool sync_mode, std::vector<fc::uint160_t>& contained_transaction_message_ids ) override;
+      void prevalidate_block( graphene::net::block_message& block_message ) override;
       void handle_transaction( const graphene::net::trx_message& transaction_message ) override;
+      std::vector< fc::oexception > handle_transactions( const std::vector< graphene::net::trx_message >& transaction_messages ) override;
       std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                              uint32_t& remaining_item_count,
                                              uint32_t limit = 2000) override;
@@ -444,9 +478,24 @@ namespace graphene { namespace net {
       peer_connection::timestamped_items_set_type _recently_failed_items; /// list of transactions we've recently pushed and had rejected by the delegate
       // @}
 
+      /// used by the task that passes transactions to the delegate
+      // @{
+      struct received_transaction
+      {
+        message                         message_received;
+        message_hash_type               message_hash;
+        message_propagation_data        propagation_data;
+        fc::optional<fc::ip::endpoint>  originating_endpoint;
+      };
+      std::list<trx_message>          _received_transactions; /// transactions we've received but not yet passed to the delegate
+      std::list<received_transaction> _received_transaction_info; /// matching entries for _received_transactions
+      fc::future<void>                _process_received_transactions_done;
+      // @}
+
       /// used by the task that advertises inventory during normal operation
       // @{
       fc::promise<void>::ptr        _retrigger_advertise_inventory_loop_promise;
+      fc::promise<void>::ptr        _end_inventory_aggregation_promise; /// set while transaction inventory is being held back, cut short by a block
       fc::future<void>              _advertise_inventory_loop_done;
       std::unordered_set<item_id>   _new_inventory; /// list of items we have received but not yet advertised to our peers
       // @}
@@ -557,7 +606,7 @@ namespace graphene { namespace net {
       void trigger_fetch_items_loop();
 
       void advertise_inventory_loop();
-      void trigger_advertise_inventory_loop();
+      void trigger_advertise_inventory_loop(bool advertise_now = false);
 
       void terminate_inactive_connections_loop();
 
@@ -637,6 +686,17 @@ namespace graphene { namespace net {
       void on_get_current_connections_reply_message(peer_connection* originating_peer,
                                                     const get_current_connections_reply_message& get_current_connections_reply_message_received);
 
+      void on_compact_block_message(peer_connection* originating_peer,
+                                    const compact_block_message& compact_block_message_received);
+
+      void on_fetch_compact_block_transactions_message(peer_connection* originating_peer,
+                                                       const fetch_compact_block_transactions_message& fetch_compact_block_transactions_message_received);
+
+      void on_compact_block_transactions_message(peer_connection* originating_peer,
+                                                 const compact_block_transactions_message& compact_block_transactions_message_received);
+
+      void try_to_complete_compact_block(peer_connection* originating_peer, const block_id_type& block_id);
+
       void on_connection_closed(peer_connection* originating_peer) override;
 
       void send_sync_block_to_node_delegate(const graphene::net::block_message& block_message_to_send);
@@ -647,6 +707,8 @@ namespace graphene { namespace net {
       void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
 
       void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
+      void process_received_transactions();
+      void trigger_process_received_transactions();
 
       void start_synchronizing();
       void start_synchronizing_with_peer(const peer_connection_ptr& peer);
@@ -1261,6 +1323,22 @@ namespace graphene { namespace net {
     {
       while (!_advertise_inventory_loop_done.canceled())
       {
+        // give transactions arriving in a burst a chance to be advertised together.  A block arriving
+        // in the meantime ends the wait through trigger_advertise_inventory_loop, so it is never held back
+        if (std::none_of(_new_inventory.begin(), _new_inventory.end(),
+                         [](const item_id& item) { return item.item_type == block_message_type; }))
+        {
+          _end_inventory_aggregation_promise = fc::promise<void>::ptr(new fc::promise<void>("graphene::net::end_inventory_aggregation"));
+          try
+          {
+            _end_inventory_aggregation_promise->wait(fc::milliseconds(GRAPHENE_NET_INVENTORY_AGGREGATION_INTERVAL_MS));
+          }
+          catch (const fc::timeout_exception&)
+          {
+          }
+          _end_inventory_aggregation_promise.reset();
+        }
+
         dlog("beginning an iteration of advertise inventory");
         // swap inventory into local variable, clearing the node's copy
         std::unordered_set<item_id> inventory_to_advertise;
@@ -1324,11 +1402,13 @@ namespace graphene { namespace net {
       } // while(!canceled)
     }
 
-    void node_impl::trigger_advertise_inventory_loop()
+    void node_impl::trigger_advertise_inventory_loop(bool advertise_now /* = false */)
     {
       VERIFY_CORRECT_THREAD();
       if( _retrigger_advertise_inventory_loop_promise )
         _retrigger_advertise_inventory_loop_promise->set_value();
+      if( advertise_now && _end_inventory_aggregation_promise && !_end_inventory_aggregation_promise->ready() )
+        _end_inventory_aggregation_promise->set_value();
     }
 
     void node_impl::terminate_inactive_connections_loop()
@@ -1391,8 +1471,21 @@ namespace graphene { namespace net {
         fc::time_point active_disconnect_threshold = fc::time_point::now() - fc::seconds(active_disconnect_timeout);
         fc::time_point active_send_keepalive_threshold = fc::time_point::now() - fc::seconds(active_send_keepalive_timeout);
         fc::time_point active_ignored_request_threshold = fc::time_point::now() - active_ignored_request_timeout;
+        fc::time_point compact_block_threshold = fc::time_point::now() - fc::seconds(GRAPHENE_NET_COMPACT_BLOCK_TIMEOUT_SECONDS);
         for( const peer_connection_ptr& active_peer : _active_connections )
         {
+          for (auto iter = active_peer->compact_blocks_being_reconstructed.begin(); iter != active_peer->compact_blocks_being_reconstructed.end();)
+          {
+            if (iter->second.received_time < compact_block_threshold)
+            {
+              dlog("dropping compact block ${id} from peer ${peer}, its transactions never arrived",
+                   ("id", iter->first)("peer", active_peer->get_remote_endpoint()));
+              iter = active_peer->compact_blocks_being_reconstructed.erase(iter);
+            }
+            else
+              ++iter;
+          }
+
           if( active_peer->connection_initiation_time < active_disconnect_threshold &&
               active_peer->get_last_message_received_time() < active_disconnect_threshold )
           {
@@ -1848,6 +1941,15 @@ namespace graphene { namespace net {
       case core_message_type_enum::get_current_connections_reply_message_type:
         on_get_current_connections_reply_message(originating_peer, received_message.as<get_current_connections_reply_message>());
         break;
+      case core_message_type_enum::compact_block_message_type:
+        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+        break;
+      case core_message_type_enum::fetch_compact_block_transactions_message_type:
+        on_fetch_compact_block_transactions_message(originating_peer, received_message.as<fetch_compact_block_transactions_message>());
+        break;
+      case core_message_type_enum::compact_block_transactions_message_type:
+        on_compact_block_transactions_message(originating_peer, received_message.as<compact_block_transactions_message>());
+        break;
 
       default:
         // ignore any message in between core_message_type_first and _last that we don't handle above
@@ -1892,6 +1994,7 @@ namespace graphene { namespace net {
         user_data["last_known_fork_block_number"] = _hard_fork_block_numbers.back();
 
       user_data["chain_id"] = _delegate->get_chain_id();
+      user_data["compact_blocks"] = GRAPHENE_NET_COMPACT_BLOCKS_VERSION;
 
       return user_data;
     }
@@ -1917,6 +2020,8 @@ namespace graphene { namespace net {
         originating_peer->last_known_fork_block_number = user_data["last_known_fork_block_number"].as<uint32_t>();
       if (user_data.contains("chain_id"))
         originating_peer->chain_id = user_data["chain_id"].as<freezone::protocol::chain_id_type>();
+      if (user_data.contains("compact_blocks"))
+        originating_peer->supports_compact_blocks = user_data["compact_blocks"].as<uint32_t>() >= GRAPHENE_NET_COMPACT_BLOCKS_VERSION;
     }
 
     void node_impl::on_hello_message( peer_connection* originating_peer, const hello_message& hello_message_received )
@@ -2809,9 +2914,21 @@ namespace graphene { namespace net {
           dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                ("endpoint", originating_peer->get_remote_endpoint())
                ("id", requested_message.id()));
-          reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
+          {
             last_block_message_sent = requested_message;
+            // a block still in our message cache was just relayed, so the peer has most likely
+            // seen its transactions already.  Only send the ids and let it fetch what it lacks
+            if (originating_peer->supports_compact_blocks && requested_message.msg_type == block_message_type)
+            {
+              // transactions we never relayed (e.g. ones pushed by our own client) are unlikely to be
+              // known by the peer, so they are sent along right away instead of waiting for a round trip
+              reply_messages.push_back(make_compact_block_message(requested_message.as<graphene::net::block_message>(), requested_message.id(),
+                                                                  [this](const transaction_id_type& id) { return _message_cache.contains_transaction(id); }));
+              continue;
+            }
+          }
+          reply_messages.push_back(requested_message);
           continue;
         }
         catch (fc::key_not_found_exception&)
@@ -2857,6 +2974,198 @@ namespace graphene { namespace net {
       }
     }
 
+    void node_impl::on_compact_block_message(peer_connection* originating_peer,
+                                             const compact_block_message& compact_block_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      dlog("received compact block ${id} with ${count} transactions from peer ${endpoint}",
+           ("id", compact_block_message_received.block_id)
+           ("count", compact_block_message_received.short_transaction_ids.size())
+           ("endpoint", originating_peer->get_remote_endpoint()));
+
+      // compact blocks are only sent in reply to our own requests for a block
+      if (originating_peer->items_requested_from_peer.find(item_id(block_message_type, compact_block_message_received.item_hash)) == originating_peer->items_requested_from_peer.end() &&
+          originating_peer->sync_items_requested_from_peer.find(compact_block_message_received.block_id) == originating_peer->sync_items_requested_from_peer.end())
+      {
+        disconnect_from_peer(originating_peer, "You sent me a compact block I didn't ask for");
+        return;
+      }
+
+      auto& blocks_being_reconstructed = originating_peer->compact_blocks_being_reconstructed;
+      if (blocks_being_reconstructed.find(compact_block_message_received.block_id) == blocks_being_reconstructed.end())
+      {
+        while (blocks_being_reconstructed.size() >= GRAPHENE_NET_MAX_COMPACT_BLOCKS_PER_PEER)
+        {
+          // give up on the oldest one, its block request times out and is fetched from another peer
+          auto oldest = std::min_element(blocks_being_reconstructed.begin(), blocks_being_reconstructed.end(),
+                                         [](const std::pair<const block_id_type, peer_connection::partial_compact_block>& a,
+                                            const std::pair<const block_id_type, peer_connection::partial_compact_block>& b) {
+                                           return a.second.received_time < b.second.received_time;
+                                         });
+          blocks_being_reconstructed.erase(oldest);
+        }
+      }
+
+      peer_connection::partial_compact_block partial_block;
+      partial_block.compact_block = compact_block_message_received;
+      partial_block.received_time = fc::time_point::now();
+      partial_block.transactions.resize(compact_block_message_received.short_transaction_ids.size());
+
+      for (const prefilled_transaction& prefilled : compact_block_message_received.prefilled_transactions)
+      {
+        if (prefilled.index >= partial_block.transactions.size())
+        {
+          disconnect_from_peer(originating_peer, "You sent me a compact block with an invalid prefilled transaction index");
+          return;
+        }
+        partial_block.transactions[prefilled.index] = prefilled.trx;
+      }
+
+      for (uint32_t i = 0; i < partial_block.transactions.size(); ++i)
+        if (!partial_block.transactions[i])
+          partial_block.transactions[i] = _message_cache.find_transaction(compact_block_message_received.short_transaction_ids[i]);
+
+      blocks_being_reconstructed[compact_block_message_received.block_id] = std::move(partial_block);
+      try_to_complete_compact_block(originating_peer, compact_block_message_received.block_id);
+    }
+
+    void node_impl::try_to_complete_compact_block(peer_connection* originating_peer, const block_id_type& block_id)
+    {
+      auto partial_block_iter = originating_peer->compact_blocks_being_reconstructed.find(block_id);
+      if (partial_block_iter == originating_peer->compact_blocks_being_reconstructed.end())
+        return;
+
+      peer_connection::partial_compact_block& partial_block = partial_block_iter->second;
+
+      std::vector<uint32_t> missing_transaction_indexes;
+      for (uint32_t i = 0; i < partial_block.transactions.size(); ++i)
+        if (!partial_block.transactions[i])
+          missing_transaction_indexes.push_back(i);
+
+      if (!missing_transaction_indexes.empty())
+      {
+        dlog("missing ${count} transactions of compact block ${id}, requesting them from peer ${endpoint}",
+             ("count", missing_transaction_indexes.size())("id", block_id)
+             ("endpoint", originating_peer->get_remote_endpoint()));
+        originating_peer->send_message(fetch_compact_block_transactions_message(block_id, std::move(missing_transaction_indexes)));
+        return;
+      }
+
+      fc::optional<graphene::net::block_message> reconstructed_block =
+        reconstruct_compact_block(partial_block.compact_block, std::move(partial_block.transactions));
+
+      // on a short id collision or a transaction with different signatures, fall back to asking
+      // the peer for every transaction of the block
+      if (!reconstructed_block)
+      {
+        if (partial_block.requested_all_transactions)
+        {
+          originating_peer->compact_blocks_being_reconstructed.erase(partial_block_iter);
+          disconnect_from_peer(originating_peer, "You sent me a compact block whose transactions don't match its merkle root");
+          return;
+        }
+
+        wlog("compact block ${id} from peer ${endpoint} did not reconstruct, requesting all transactions",
+             ("id", block_id)("endpoint", originating_peer->get_remote_endpoint()));
+        std::vector<uint32_t> all_transaction_indexes(partial_block.transactions.size());
+        for (uint32_t i = 0; i < all_transaction_indexes.size(); ++i)
+        {
+          all_transaction_indexes[i] = i;
+          partial_block.transactions[i].reset();
+        }
+        partial_block.requested_all_transactions = true;
+        originating_peer->send_message(fetch_compact_block_transactions_message(block_id, std::move(all_transaction_indexes)));
+        return;
+      }
+
+      originating_peer->compact_blocks_being_reconstructed.erase(partial_block_iter);
+
+      // the block is now byte for byte the block_message the peer offered us, so it hashes to the
+      // item id we requested and can take the regular block path
+      message block_message_to_process(*reconstructed_block);
+      process_block_message(originating_peer, block_message_to_process, block_message_to_process.id());
+    }
+
+    void node_impl::on_fetch_compact_block_transactions_message(peer_connection* originating_peer,
+                                                                const fetch_compact_block_transactions_message& fetch_compact_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const block_id_type& block_id = fetch_compact_block_transactions_message_received.block_id;
+
+      compact_block_transactions_message reply;
+      reply.block_id = block_id;
+
+      try
+      {
+        message block = _delegate->get_item(item_id(block_message_type, block_id));
+        const auto& transactions = block.as<graphene::net::block_message>().block.transactions;
+
+        for (uint32_t index : fetch_compact_block_transactions_message_received.transaction_indexes)
+        {
+          if (index >= transactions.size())
+          {
+            disconnect_from_peer(originating_peer, "You requested a transaction index that is not in the compact block");
+            return;
+          }
+          reply.transactions.push_back(prefilled_transaction{index, transactions[index]});
+        }
+      }
+      catch (fc::key_not_found_exception&)
+      {
+        // we no longer have the block (e.g. it was on a fork we switched away from)
+        dlog("peer ${endpoint} requested transactions of compact block ${id} we don't have",
+             ("endpoint", originating_peer->get_remote_endpoint())("id", block_id));
+      }
+
+      originating_peer->send_message(reply);
+    }
+
+    void node_impl::on_compact_block_transactions_message(peer_connection* originating_peer,
+                                                          const compact_block_transactions_message& compact_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const block_id_type& block_id = compact_block_transactions_message_received.block_id;
+
+      auto partial_block_iter = originating_peer->compact_blocks_being_reconstructed.find(block_id);
+      if (partial_block_iter == originating_peer->compact_blocks_being_reconstructed.end())
+      {
+        dlog("received transactions for compact block ${id} we aren't reconstructing", ("id", block_id));
+        return;
+      }
+
+      if (compact_block_transactions_message_received.transactions.empty())
+      {
+        // the peer can't provide the block anymore.  Our request for the block will time out and
+        // be rescheduled with another peer when this one is dropped
+        originating_peer->compact_blocks_being_reconstructed.erase(partial_block_iter);
+        return;
+      }
+
+      auto& transactions = partial_block_iter->second.transactions;
+      for (const prefilled_transaction& transaction : compact_block_transactions_message_received.transactions)
+      {
+        if (transaction.index >= transactions.size())
+        {
+          originating_peer->compact_blocks_being_reconstructed.erase(partial_block_iter);
+          disconnect_from_peer(originating_peer, "You sent me a transaction index that is not in the compact block");
+          return;
+        }
+        transactions[transaction.index] = transaction.trx;
+      }
+
+      for (const fc::optional<signed_transaction>& transaction : transactions)
+      {
+        if (!transaction)
+        {
+          originating_peer->compact_blocks_being_reconstructed.erase(partial_block_iter);
+          disconnect_from_peer(originating_peer, "You did not send all the transactions of the compact block I requested");
+          return;
+        }
+      }
+
+      try_to_complete_compact_block(originating_peer, block_id);
+    }
+
     void node_impl::on_item_not_available_message( peer_connection* originating_peer, const item_not_available_message& item_not_available_message_received )
     {
       VERIFY_CORRECT_THREAD();
@@ -3437,6 +3746,10 @@ namespace graphene { namespace net {
       // add it to the front of _received_sync_items, then process _received_sync_items to try to
       // pass as many messages as possible to the client.
       _new_received_sync_items.push_front( block_message_to_process );
+
+      // let the client start on the state independent checks while it works through the blocks ahead of this one
+      _delegate->prevalidate_block( _new_received_sync_items.front() );
+
       trigger_process_backlog_of_sync_blocks();
     }
 
@@ -3974,9 +4287,13 @@ namespace graphene { namespace net {
         {
           if (message_to_process.msg_type == trx_message_type)
           {
-            trx_message transaction_message_to_process = message_to_process.as<trx_message>();
-            dlog("passing message containing transaction ${trx} to client", ("trx", transaction_message_to_process.trx.id()));
-            _delegate->handle_transaction(transaction_message_to_process);
+            // transactions are passed to the client in batches, and broadcast once it has accepted them
+            _received_transactions.push_back(message_to_process.as<trx_message>());
+            _received_transaction_info.push_back(received_transaction{message_to_process, message_hash,
+                                                                      message_propagation_data{message_receive_time, fc::time_point(), originating_peer->node_id},
+                                                                      originating_peer->get_remote_endpoint()});
+            trigger_process_received_transactions();
+            return;
           }
           else
             _delegate->handle_message( message_to_process );
@@ -4000,6 +4317,68 @@ namespace graphene { namespace net {
       }
     }
 
+    void node_impl::process_received_transactions()
+    {
+      VERIFY_CORRECT_THREAD();
+      // let any other transactions that have already arrived be queued so they're handled in the same batch
+      fc::yield();
+
+      while (!_received_transactions.empty())
+      {
+        std::vector<trx_message> transactions;
+        std::vector<received_transaction> transaction_info;
+        while (!_received_transactions.empty() && transactions.size() < GRAPHENE_NET_MAX_TRANSACTIONS_PER_BATCH)
+        {
+          transactions.push_back(std::move(_received_transactions.front()));
+          transaction_info.push_back(std::move(_received_transaction_info.front()));
+          _received_transactions.pop_front();
+          _received_transaction_info.pop_front();
+        }
+
+        dlog("passing ${count} transaction(s) to client", ("count", transactions.size()));
+        std::vector<fc::oexception> results;
+        try
+        {
+          results = _delegate->handle_transactions(transactions);
+          FC_ASSERT(results.size() == transactions.size(), "client returned ${r} results for ${t} transactions",
+                    ("r", results.size())("t", transactions.size()));
+        }
+        catch ( const fc::canceled_exception& )
+        {
+          throw;
+        }
+        catch ( const fc::exception& e )
+        {
+          results.assign(transactions.size(), e);
+        }
+        fc::time_point message_validated_time = fc::time_point::now();
+
+        for (size_t i = 0; i < transactions.size(); ++i)
+        {
+          received_transaction& info = transaction_info[i];
+          if (results[i])
+          {
+            wlog( "client rejected message sent by peer ${peer}, ${e}", ("peer", info.originating_endpoint)("e", *results[i]) );
+            // record it so we don't try to fetch this item again
+            _recently_failed_items.insert(peer_connection::timestamped_item_id(item_id(trx_message_type, info.message_hash), fc::time_point::now()));
+          }
+          else
+          {
+            // if the delegate validated the message, broadcast it to our other peers
+            info.propagation_data.validated_time = message_validated_time;
+            broadcast(info.message_received, info.propagation_data);
+          }
+        }
+      }
+    }
+
+    void node_impl::trigger_process_received_transactions()
+    {
+      if (!_node_is_shutting_down &&
+          (!_process_received_transactions_done.valid() || _process_received_transactions_done.ready()))
+        _process_received_transactions_done = async_task([=](){ process_received_transactions(); }, "process_received_transactions");
+    }
+
     void node_impl::start_synchronizing_with_peer( const peer_connection_ptr& peer )
     {
       VERIFY_CORRECT_THREAD();
@@ -4101,6 +4480,24 @@ namespace graphene { namespace net {
         wlog( "Exception thrown while terminating P2P connect loop, ignoring" );
       }
 
+      try
+      {
+        _process_received_transactions_done.cancel_and_wait("node_impl::close()");
+        dlog("Process received transactions task terminated");
+      }
+      catch ( const fc::canceled_exception& )
+      {
+        dlog("Process received transactions task terminated");
+      }
+      catch ( const fc::exception& e )
+      {
+        wlog( "Exception thrown while terminating Process received transactions task, ignoring: ${e}", ("e", e) );
+      }
+      catch (...)
+      {
+        wlog( "Exception thrown while terminating Process received transactions task, ignoring" );
+      }
+
       try
       {
         _process_backlog_of_sync_blocks_done.cancel_and_wait("node_impl::close()");
@@ -4196,7 +4593,7 @@ namespace graphene { namespace net {
       {
         _advertise_inventory_loop_done.cancel("node_impl::close()");
         // cancel() is currently broken, so we need to wake up the task to allow it to finish
-        trigger_advertise_inventory_loop();
+        trigger_advertise_inventory_loop(true);
         _advertise_inventory_loop_done.wait();
         dlog("Advertise inventory loop terminated");
       }
@@ -5061,7 +5458,7 @@ namespace graphene { namespace net {
 
       _message_cache.cache_message( item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents );
       _new_inventory.insert( item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast ) );
-      trigger_advertise_inventory_loop();
+      trigger_advertise_inventory_loop(item_to_broadcast.msg_type == block_message_type);
     }
 
     void node_impl::broadcast( const message& item_to_broadcast )
@@ -5610,11 +6007,21 @@ namespace graphene { namespace net {
       INVOKE_AND_COLLECT_STATISTICS(handle_block, block_message, sync_mode, contained_transaction_message_ids);
     }
 
+    void statistics_gathering_node_delegate_wrapper::prevalidate_block( graphene::net::block_message& block_message )
+    {
+      _node_delegate->prevalidate_block( block_message );
+    }
+
     void statistics_gathering_node_delegate_wrapper::handle_transaction( const graphene::net::trx_message& transaction_message )
     {
       INVOKE_AND_COLLECT_STATISTICS(handle_transaction, transaction_message);
     }
 
+    std::vector< fc::oexception > statistics_gathering_node_delegate_wrapper::handle_transactions( const std::vector< graphene::net::trx_message >& transaction_messages )
+    {
+      INVOKE_AND_COLLECT_STATISTICS(handle_transactions, transaction_messages);
+    }
+
     std::vector<item_hash_t> statistics_gathering_node_delegate_wrapper::get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                                                                        uint32_t& remaining_item_count,
                                                                                        uint32_t limit /* = 2000 */)
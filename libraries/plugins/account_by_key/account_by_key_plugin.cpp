@@ -28,8 +28,8 @@ class account_by_key_plugin_impl
       flat_set< public_key_type >   cached_keys;
       database&                     _db;
       account_by_key_plugin&        _self;
-      boost::signals2::connection   _pre_apply_operation_conn;
-      boost::signals2::connection   _post_apply_operation_conn;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
 };
 
 struct pre_operation_visitor
@@ -264,8 +264,14 @@ void account_by_key_plugin::plugin_initialize( const boost::program_options::var
       ilog( "Initializing account_by_key plugin" );
       chain::database& db = appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db();
 
-      my->_pre_apply_operation_conn = db.add_pre_apply_operation_handler( [&]( const operation_notification& note ){ my->on_pre_apply_operation( note ); }, *this, 0 );
-      my->_post_apply_operation_conn = db.add_post_apply_operation_handler( [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
+      my->_pre_apply_operation_conn = db.subscribe_pre_apply_operation<
+         account_create_operation, account_create_with_delegation_operation, account_update_operation,
+         account_update2_operation, recover_account_operation, pow_operation, pow2_operation >(
+         [&]( const operation_notification& note ){ my->on_pre_apply_operation( note ); }, *this, 0 );
+      my->_post_apply_operation_conn = db.subscribe_post_apply_operation<
+         account_create_operation, account_create_with_delegation_operation, account_update_operation,
+         account_update2_operation, recover_account_operation, pow_operation, pow2_operation, hardfork_operation >(
+         [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
 
       freezone_ADD_PLUGIN_INDEX(db, key_lookup_index);
    }
@@ -34,6 +34,18 @@ namespace detail
 {
    typedef std::function< void( const broadcast_transaction_synchronous_return& ) > confirmation_callback;
 
+   discussion_list to_discussion_list( const tags::discussion_query_result& r )
+   {
+      discussion_list result;
+      result.discussions.reserve( r.discussions.size() );
+
+      for( const auto& d : r.discussions )
+         result.discussions.push_back( discussion( d ) );
+
+      result.fields = r.fields;
+      return result;
+   }
+
    class condenser_api_impl
    {
       public:
@@ -1386,16 +1398,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_post_discussions_by_payout(
-         args[0].as< tags::get_post_discussions_by_payout_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_post_discussions_by_payout( args[0].as< tags::get_post_discussions_by_payout_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_comment_discussions_by_payout )
@@ -1403,16 +1406,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_comment_discussions_by_payout(
-         args[0].as< tags::get_comment_discussions_by_payout_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_comment_discussions_by_payout( args[0].as< tags::get_comment_discussions_by_payout_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_trending )
@@ -1420,16 +1414,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_trending(
-         args[0].as< tags::get_discussions_by_trending_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_trending( args[0].as< tags::get_discussions_by_trending_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_created )
@@ -1437,16 +1422,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_created(
-         args[0].as< tags::get_discussions_by_created_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_created( args[0].as< tags::get_discussions_by_created_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_active )
@@ -1454,16 +1430,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_active(
-         args[0].as< tags::get_discussions_by_active_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_active( args[0].as< tags::get_discussions_by_active_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_cashout )
@@ -1471,16 +1438,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_cashout(
-         args[0].as< tags::get_discussions_by_cashout_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_cashout( args[0].as< tags::get_discussions_by_cashout_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_votes )
@@ -1488,16 +1446,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_votes(
-         args[0].as< tags::get_discussions_by_votes_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_votes( args[0].as< tags::get_discussions_by_votes_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_children )
@@ -1505,16 +1454,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_children(
-         args[0].as< tags::get_discussions_by_children_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_children( args[0].as< tags::get_discussions_by_children_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_hot )
@@ -1522,16 +1462,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_hot(
-         args[0].as< tags::get_discussions_by_hot_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_hot( args[0].as< tags::get_discussions_by_hot_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_feed )
@@ -1539,16 +1470,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_feed(
-         args[0].as< tags::get_discussions_by_feed_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_feed( args[0].as< tags::get_discussions_by_feed_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_blog )
@@ -1556,16 +1478,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_blog(
-         args[0].as< tags::get_discussions_by_blog_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_blog( args[0].as< tags::get_discussions_by_blog_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_comments )
@@ -1573,16 +1486,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_comments(
-         args[0].as< tags::get_discussions_by_comments_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_comments( args[0].as< tags::get_discussions_by_comments_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_discussions_by_promoted )
@@ -1590,16 +1494,7 @@ namespace detail
       CHECK_ARG_SIZE( 1 )
       FC_ASSERT( _tags_api, "tags_api_plugin not enabled." );
 
-      auto discussions = _tags_api->get_discussions_by_promoted(
-         args[0].as< tags::get_discussions_by_promoted_args >() ).discussions;
-      vector< discussion > result;
-
-      for( auto& d : discussions )
-      {
-         result.push_back( discussion( d ) );
-      }
-
-      return result;
+      return to_discussion_list( _tags_api->get_discussions_by_promoted( args[0].as< tags::get_discussions_by_promoted_args >() ) );
    }
 
    DEFINE_API_IMPL( condenser_api_impl, get_replies_by_last_update )
@@ -2347,4 +2242,20 @@ DEFINE_READ_APIS( condenser_api,
    (get_SST_balances)
 )
 
+void to_variant( const discussion_list& l, fc::variant& v )
+{
+   if( !l.fields.valid() )
+   {
+      fc::to_variant( l.discussions, v );
+      return;
+   }
+
+   vector< fc::variant > discussions( l.discussions.size() );
+
+   for( size_t i = 0; i < l.discussions.size(); ++i )
+      tags::selected_members_to_variant( l.discussions[i], *l.fields, discussions[i] );
+
+   v = std::move( discussions );
+}
+
 } } } // freezone::plugins::condenser_api
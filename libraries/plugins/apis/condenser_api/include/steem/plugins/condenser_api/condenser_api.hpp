@@ -764,6 +764,18 @@ struct discussion : public api_comment_object
    optional< time_point_sec >    first_reblogged_on;
 };
 
+/**
+ * The discussions of a tags::discussion_query, serialized as an array. Only the members named by
+ * the query's fields are serialized.
+ */
+struct discussion_list
+{
+   vector< discussion >        discussions;
+   optional< set< string > >   fields;
+};
+
+void to_variant( const discussion_list& l, fc::variant& v );
+
 struct tag_index
 {
    vector< tags::tag_name_type > trending; /// pending payouts
@@ -1037,19 +1049,19 @@ DEFINE_API_ARGS( get_account_votes,                      vector< variant >,   ve
 DEFINE_API_ARGS( get_content,                            vector< variant >,   discussion )
 DEFINE_API_ARGS( get_content_replies,                    vector< variant >,   vector< discussion > )
 DEFINE_API_ARGS( get_tags_used_by_author,                vector< variant >,   vector< tags::tag_count_object > )
-DEFINE_API_ARGS( get_post_discussions_by_payout,         vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_comment_discussions_by_payout,      vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_trending,            vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_created,             vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_active,              vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_cashout,             vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_votes,               vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_children,            vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_hot,                 vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_feed,                vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_blog,                vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_comments,            vector< variant >,   vector< discussion > )
-DEFINE_API_ARGS( get_discussions_by_promoted,            vector< variant >,   vector< discussion > )
+DEFINE_API_ARGS( get_post_discussions_by_payout,         vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_comment_discussions_by_payout,      vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_trending,            vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_created,             vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_active,              vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_cashout,             vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_votes,               vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_children,            vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_hot,                 vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_feed,                vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_blog,                vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_comments,            vector< variant >,   discussion_list )
+DEFINE_API_ARGS( get_discussions_by_promoted,            vector< variant >,   discussion_list )
 DEFINE_API_ARGS( get_replies_by_last_update,             vector< variant >,   vector< discussion > )
 DEFINE_API_ARGS( get_discussions_by_author_before_date,  vector< variant >,   vector< discussion > )
 DEFINE_API_ARGS( get_account_history,                    vector< variant >,   get_account_history_return_type )
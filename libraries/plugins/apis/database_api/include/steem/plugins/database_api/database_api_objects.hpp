@@ -32,7 +32,8 @@ typedef reward_fund_object                     api_reward_fund_object;
 
 struct api_comment_object
 {
-   api_comment_object( const comment_object& o, const database& db ):
+   /// Content (title, body and json_metadata) is only read when include_content is set
+   api_comment_object( const comment_object& o, const database& db, bool include_content = true ):
       id( o.id ),
       category( to_string( o.category ) ),
       parent_author( o.parent_author ),
@@ -76,10 +77,13 @@ struct api_comment_object
          root_permlink = to_string( root->permlink );
       }
 #ifndef IS_LOW_MEM
-      const auto& con = db.get< chain::comment_content_object, chain::by_comment >( o.id );
-      title = to_string( con.title );
-      body = to_string( con.body );
-      json_metadata = to_string( con.json_metadata );
+      if( include_content )
+      {
+         const auto& con = db.get< chain::comment_content_object, chain::by_comment >( o.id );
+         title = to_string( con.title );
+         body = db.get_comment_body( con );
+         json_metadata = to_string( con.json_metadata );
+      }
 #endif
    }
 
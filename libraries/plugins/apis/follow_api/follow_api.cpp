@@ -15,10 +15,23 @@ inline void set_what( vector< follow::follow_type >& what, uint16_t bitmask )
       what.push_back( follow::ignore );
 }
 
+inline void fill_feed_entry( feed_entry& entry, const chain::comment_object& comment, const chain::database& )
+{
+   entry.author = comment.author;
+   entry.permlink = chain::to_string( comment.permlink );
+}
+
+inline void fill_feed_entry( comment_feed_entry& entry, const chain::comment_object& comment, const chain::database& db )
+{
+   entry.comment = database_api::api_comment_object( comment, db );
+}
+
 class follow_api_impl
 {
    public:
-      follow_api_impl() : _db( appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db() ) {}
+      follow_api_impl() :
+         _db( appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db() ),
+         _follow( appbase::app().get_plugin< freezone::plugins::follow::follow_plugin >() ) {}
 
       DECLARE_API_IMPL(
          (get_followers)
@@ -33,9 +46,42 @@ class follow_api_impl
          (get_blog_authors)
       )
 
+      template< typename Entry >
+      void get_pulled_feed( const account_name_type& account, uint32_t start_entry_id, uint32_t limit, vector< Entry >& feed );
+
       chain::database& _db;
+      follow::follow_plugin& _follow;
 };
 
+template< typename Entry >
+void follow_api_impl::get_pulled_feed( const account_name_type& account, uint32_t start_entry_id, uint32_t limit, vector< Entry >& feed )
+{
+   auto pulled = _follow.get_pulled_feed( account );
+   const auto& entries = pulled->entries;
+
+   // Entry ids count down from the newest entry of the computed feed
+   size_t i = 0;
+   if( start_entry_id != 0 && entries.size() && start_entry_id < entries.front().entry_id )
+      i = entries.front().entry_id - start_entry_id;
+
+   for( ; i < entries.size() && feed.size() < limit; ++i )
+   {
+      const auto& pulled_entry = entries[ i ];
+      const auto& comment = _db.get( pulled_entry.comment );
+      Entry entry;
+      fill_feed_entry( entry, comment, _db );
+      entry.entry_id = pulled_entry.entry_id;
+
+      if( pulled_entry.first_reblogged_by != account_name_type() )
+      {
+         entry.reblog_by = pulled_entry.reblogged_by;
+         entry.reblog_on = pulled_entry.first_reblogged_on;
+      }
+
+      feed.push_back( entry );
+   }
+}
+
 DEFINE_API_IMPL( follow_api_impl, get_followers )
 {
    FC_ASSERT( args.limit <= 1000 );
@@ -110,6 +156,12 @@ DEFINE_API_IMPL( follow_api_impl, get_feed_entries )
    get_feed_entries_return result;
    result.feed.reserve( args.limit );
 
+   if( _follow.pull_feeds )
+   {
+      get_pulled_feed( args.account, args.start_entry_id, args.limit, result.feed );
+      return result;
+   }
+
    const auto& feed_idx = _db.get_index< follow::feed_index >().indices().get< follow::by_feed >();
    auto itr = feed_idx.lower_bound( boost::make_tuple( args.account, entry_id ) );
 
@@ -147,6 +199,12 @@ DEFINE_API_IMPL( follow_api_impl, get_feed )
    get_feed_return result;
    result.feed.reserve( args.limit );
 
+   if( _follow.pull_feeds )
+   {
+      get_pulled_feed( args.account, args.start_entry_id, args.limit, result.feed );
+      return result;
+   }
+
    const auto& feed_idx = _db.get_index< follow::feed_index >().indices().get< follow::by_feed >();
    auto itr = feed_idx.lower_bound( boost::make_tuple( args.account, entry_id ) );
 
@@ -8,7 +8,9 @@
 
 #include <fc/optional.hpp>
 #include <fc/variant.hpp>
+#include <fc/variant_object.hpp>
 #include <fc/vector.hpp>
+#include <fc/reflect/reflect.hpp>
 
 namespace freezone { namespace plugins { namespace tags {
 
@@ -51,8 +53,8 @@ struct vote_state
 
 struct discussion : public database_api::api_comment_object
 {
-   discussion( const freezone::chain::comment_object& o, const freezone::chain::database& db ) :
-      database_api::api_comment_object( o, db ) {}
+   discussion( const freezone::chain::comment_object& o, const freezone::chain::database& db, bool include_content = true ) :
+      database_api::api_comment_object( o, db, include_content ) {}
 
    discussion(){}
 
@@ -123,13 +125,68 @@ struct discussion_query
    optional< string >   start_permlink;
    optional< string >   parent_author;
    optional< string >   parent_permlink;
+
+   /**
+    * The names of the discussion members to return. Only the data these members need is looked up,
+    * and only these members are serialized. All members are returned when not set.
+    */
+   optional< set< string > > fields;
 };
 
 struct discussion_query_result
 {
    vector< discussion > discussions;
+
+   /// The discussion_query::fields of the query, not serialized
+   optional< set< string > > fields;
 };
 
+/// Leaves out the members of each discussion that are not in fields
+void to_variant( const discussion_query_result& r, fc::variant& v );
+
+namespace detail {
+
+template< typename T >
+class selected_members_visitor
+{
+   public:
+      selected_members_visitor( fc::mutable_variant_object& mvo, const T& v, const set< string >& f )
+      :vo(mvo),val(v),fields(f){}
+
+      template< typename Member, class Class, Member (Class::*member) >
+      void operator()( const char* name )const
+      {
+         if( fields.find( name ) != fields.end() )
+            add( name, val.*member );
+      }
+
+   private:
+      template< typename M >
+      void add( const char* name, const optional< M >& v )const
+      {
+         if( v.valid() )
+            vo( name, *v );
+      }
+
+      template< typename M >
+      void add( const char* name, const M& v )const { vo( name, v ); }
+
+      fc::mutable_variant_object& vo;
+      const T& val;
+      const set< string >& fields;
+};
+
+} // detail
+
+/// Converts only the reflected members of o that are named in fields, without building the others
+template< typename T >
+void selected_members_to_variant( const T& o, const set< string >& fields, fc::variant& v )
+{
+   fc::mutable_variant_object mvo;
+   fc::reflector< T >::visit( detail::selected_members_visitor< T >( mvo, o, fields ) );
+   v = std::move( mvo );
+}
+
 typedef get_discussion_args      get_content_replies_args;
 typedef discussion_query_result  get_content_replies_return;
 
@@ -201,7 +258,8 @@ struct get_active_votes_return
 class tags_api
 {
    public:
-      tags_api();
+      /// Votes of up to active_votes_cache_size comments are cached, see get_active_votes
+      tags_api( uint32_t active_votes_cache_size = 0 );
       ~tags_api();
 
    DECLARE_API(
@@ -229,9 +287,13 @@ class tags_api
 
    void set_pending_payout( discussion& d );
 
+   /// The number of requests for the votes of a comment that were answered from the cache
+   uint64_t active_votes_cache_hits()const;
+
    private:
       friend class tags_api_plugin;
       void api_startup();
+      void api_shutdown();
 
       std::unique_ptr< detail::tags_api_impl > my;
 };
@@ -266,7 +328,7 @@ FC_REFLECT( freezone::plugins::tags::get_discussion_args,
             (author)(permlink) )
 
 FC_REFLECT( freezone::plugins::tags::discussion_query,
-            (tag)(limit)(filter_tags)(select_authors)(select_tags)(truncate_body)(start_author)(start_permlink)(parent_author)(parent_permlink) )
+            (tag)(limit)(filter_tags)(select_authors)(select_tags)(truncate_body)(start_author)(start_permlink)(parent_author)(parent_permlink)(fields) )
 
 FC_REFLECT( freezone::plugins::tags::discussion_query_result,
             (discussions) )
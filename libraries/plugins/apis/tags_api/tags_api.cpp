@@ -3,19 +3,301 @@
 #include <freezone/plugins/tags/tags_plugin.hpp>
 #include <freezone/plugins/follow_api/follow_api_plugin.hpp>
 #include <freezone/plugins/follow_api/follow_api.hpp>
+#include <freezone/plugins/follow/follow_plugin.hpp>
 
 #include <freezone/chain/freezone_object_types.hpp>
 #include <freezone/chain/util/reward.hpp>
 #include <freezone/chain/util/uint256.hpp>
+#include <freezone/chain/util/signal.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
 
 namespace freezone { namespace plugins { namespace tags {
 
 namespace detail {
 
+/**
+ * The members of a discussion requested by discussion_query::fields. Data is only looked up for the
+ * requested members: the comment content, the votes, the payout and the url each need extra lookups.
+ */
+struct discussion_fields
+{
+   discussion_fields() {}
+   discussion_fields( const optional< set< string > >& f ) : all( !f.valid() )
+   {
+      if( f.valid() )
+         fields = *f;
+   }
+
+   bool has( const char* field )const { return all || fields.find( field ) != fields.end(); }
+
+   bool content()const
+   {
+      return has( "title" ) || has( "body" ) || has( "json_metadata" ) || has( "body_length" );
+   }
+
+   bool payout()const
+   {
+      return has( "pending_payout_value" ) || has( "total_pending_payout_value" ) || has( "promoted" )
+         || has( "author_reputation" ) || has( "cashout_time" );
+   }
+
+   bool url()const { return has( "url" ) || has( "root_title" ); }
+
+   bool        all = true;
+   set< string > fields;
+};
+
+/// Large bodies are not returned by the discussion APIs
+inline void prune_body( discussion& d )
+{
+   if( d.body.size() > 1024*128 )
+      d.body = "body pruned due to size";
+   if( d.parent_author.size() > 0 && d.body.size() > 1024*16 )
+      d.body = "comment pruned due to size";
+}
+
+/**
+ * The state of a comment that changes with every vote, recorded with cached active votes. A cached
+ * entry whose stamp does not match its comment was left stale by votes that were undone.
+ */
+struct active_votes_stamp
+{
+   active_votes_stamp() {}
+   active_votes_stamp( const chain::comment_object& c ) :
+      active( c.active ),
+      abs_rshares( c.abs_rshares ),
+      total_vote_weight( c.total_vote_weight ),
+      net_votes( c.net_votes ) {}
+
+   bool operator == ( const active_votes_stamp& o )const
+   {
+      return active == o.active && abs_rshares == o.abs_rshares && total_vote_weight == o.total_vote_weight && net_votes == o.net_votes;
+   }
+
+   bool operator != ( const active_votes_stamp& o )const { return !( *this == o ); }
+
+   time_point_sec    active;
+   share_type        abs_rshares;
+   uint64_t          total_vote_weight = 0;
+   int32_t           net_votes = 0;
+};
+
+struct active_votes
+{
+   active_votes_stamp                                 stamp;
+   std::map< chain::account_id_type, vote_state >    votes; ///< by voter, in the order of the vote index
+};
+
+/**
+ * The active votes of recently requested comments, so that the votes of popular posts are not resolved
+ * voter by voter on every request. Votes are updated in place as they are applied, and an entry is dropped
+ * when its comment is paid out or deleted, or when its stamp shows it was left stale by undone votes.
+ *
+ * The reputations of the voters are cached alongside. The follow plugin reports the accounts whose
+ * reputation a vote changed. Those changed by pending transactions are dropped again once the next block
+ * is applied, in case the transactions were discarded, and all are dropped when a block does not extend
+ * the previous one.
+ */
+class active_votes_cache
+{
+   public:
+      /// Maximum number of cached comments. 0 disables caching.
+      void set_capacity( size_t comments )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         _capacity = comments;
+         _lru.clear();
+         _entries.clear();
+         _reputations.clear();
+      }
+
+      /// Copies the cached votes of the comment when they match its stamp
+      bool get( chain::comment_id_type comment, const active_votes_stamp& stamp, vector< vote_state >& result )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         auto itr = _entries.find( comment );
+         if( itr == _entries.end() || itr->second.first.stamp != stamp )
+            return false;
+
+         _lru.splice( _lru.begin(), _lru, itr->second.second );
+         ++_hits;
+
+         result.clear();
+         result.reserve( itr->second.first.votes.size() );
+         for( const auto& vote : itr->second.first.votes )
+            result.push_back( vote.second );
+
+         return true;
+      }
+
+      uint64_t hits()
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         return _hits;
+      }
+
+      void insert( chain::comment_id_type comment, active_votes&& votes )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         if( _capacity == 0 )
+            return;
+
+         auto itr = _entries.find( comment );
+         if( itr != _entries.end() )
+         {
+            itr->second.first = std::move( votes );
+            _lru.splice( _lru.begin(), _lru, itr->second.second );
+            return;
+         }
+
+         _lru.push_front( comment );
+         _entries.emplace( comment, std::make_pair( std::move( votes ), _lru.begin() ) );
+
+         while( _entries.size() > _capacity )
+         {
+            _entries.erase( _lru.back() );
+            _lru.pop_back();
+         }
+      }
+
+      void erase( chain::comment_id_type comment )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         auto itr = _entries.find( comment );
+         if( itr != _entries.end() )
+            erase( itr );
+      }
+
+      /// Drops the entry of the comment unless it matches the stamp of the comment
+      void erase_stale( chain::comment_id_type comment, const active_votes_stamp& stamp )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         auto itr = _entries.find( comment );
+         if( itr != _entries.end() && itr->second.first.stamp != stamp )
+            erase( itr );
+      }
+
+      /// Sets the vote of the voter, or removes it when not set, in the entry of the comment
+      void update_vote( chain::comment_id_type comment, const active_votes_stamp& stamp, chain::account_id_type voter, const optional< vote_state >& vote )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         auto itr = _entries.find( comment );
+         if( itr == _entries.end() )
+            return;
+
+         auto& votes = itr->second.first;
+         votes.stamp = stamp;
+
+         if( vote.valid() )
+            votes.votes[ voter ] = *vote;
+         else
+            votes.votes.erase( voter );
+      }
+
+      /// Sets the cached reputations of the voters, and returns the positions of those not cached
+      vector< size_t > get_reputations( vector< vote_state >& votes )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         vector< size_t > missing;
+
+         for( size_t i = 0; i < votes.size(); ++i )
+         {
+            auto itr = _reputations.find( votes[i].voter );
+            if( itr != _reputations.end() )
+               votes[i].reputation = itr->second;
+            else
+               missing.push_back( i );
+         }
+
+         return missing;
+      }
+
+      void set_reputation( const account_name_type& account, share_type reputation )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         if( _capacity == 0 )
+            return;
+
+         // Reputations are not tracked per comment, they are all dropped once they outgrow the comments
+         if( _reputations.size() >= _capacity * max_reputations_per_comment )
+            _reputations.clear();
+
+         _reputations[ account ] = reputation;
+      }
+
+      void invalidate_reputation( const account_name_type& account )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+         _changed_reputations.insert( account );
+         _reputations.erase( account );
+      }
+
+      /// Called once a block has been applied
+      void on_block( const block_id_type& previous, const block_id_type& id )
+      {
+         std::lock_guard< std::mutex > guard( _mutex );
+
+         if( previous != _head_block_id )
+         {
+            _reputations.clear();
+         }
+         else
+         {
+            for( const auto& account : _changed_reputations )
+               _reputations.erase( account );
+         }
+
+         _changed_reputations.clear();
+         _head_block_id = id;
+      }
+
+   private:
+      typedef std::list< chain::comment_id_type > lru_list;
+      typedef std::map< chain::comment_id_type, std::pair< active_votes, lru_list::iterator > > entry_map;
+
+      static const size_t max_reputations_per_comment = 100;
+
+      void erase( entry_map::iterator itr )
+      {
+         _lru.erase( itr->second.second );
+         _entries.erase( itr );
+      }
+
+      size_t                                          _capacity = 0;
+      uint64_t                                        _hits = 0;
+      lru_list                                        _lru;
+      entry_map                                       _entries;
+      std::map< account_name_type, share_type >       _reputations;
+      std::set< account_name_type >                   _changed_reputations;
+      block_id_type                                   _head_block_id;
+      std::mutex                                      _mutex;
+};
+
 class tags_api_impl
 {
    public:
-      tags_api_impl() : _db( appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db() ) {}
+      tags_api_impl( uint32_t active_votes_cache_size ) : _db( appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db() )
+      {
+         _active_votes.set_capacity( active_votes_cache_size );
+
+         if( active_votes_cache_size )
+         {
+            const auto& plugin = appbase::app().get_plugin< tags_api_plugin >();
+            _pre_apply_operation_conn = _db.subscribe_pre_apply_operation< vote_operation, vote2_operation, delete_comment_operation >(
+               [&]( const operation_notification& note ){ on_pre_apply_operation( note ); }, plugin, 0 );
+            _post_apply_operation_conn = _db.subscribe_post_apply_operation< vote_operation, vote2_operation,
+               comment_payout_update_operation, comment_reward_operation >(
+               [&]( const operation_notification& note ){ on_post_apply_operation( note ); }, plugin, 0 );
+            _post_apply_block_conn = _db.add_post_apply_block_handler( [&]( const block_notification& note )
+            {
+               _active_votes.on_block( note.block.previous, note.block_id );
+            }, plugin, 0 );
+         }
+      }
 
       DECLARE_API_IMPL(
          (get_trending_tags)
@@ -42,7 +324,16 @@ class tags_api_impl
 
       void set_pending_payout( discussion& d );
       void set_url( discussion& d );
-      discussion lookup_discussion( chain::comment_id_type, uint32_t truncate_body = 0 );
+
+      vote_state make_vote_state( const chain::comment_vote_object& cv, const account_name_type& voter );
+      vector< vote_state > get_active_votes( const chain::comment_object& comment );
+      void invalidate_active_votes( const account_name_type& author, const string& permlink );
+      void invalidate_stale_active_votes( const account_name_type& author, const string& permlink );
+      void update_active_vote( const account_name_type& voter, const account_name_type& author, const string& permlink );
+      uint64_t active_votes_cache_hits();
+      void on_pre_apply_operation( const operation_notification& note );
+      void on_post_apply_operation( const operation_notification& note );
+      discussion lookup_discussion( chain::comment_id_type, uint32_t truncate_body = 0, const discussion_fields& fields = discussion_fields() );
 
       static bool filter_default( const database_api::api_comment_object& c ) { return false; }
       static bool exit_default( const database_api::api_comment_object& c )   { return false; }
@@ -60,10 +351,26 @@ class tags_api_impl
                                                bool ignore_parent = false
                                                );
 
+      /// Like get_discussions(), for the rank indices, which only hold discussions that are listed
+      template<typename Index, typename StartItr>
+      discussion_query_result get_ranked_discussions( const discussion_query& q,
+                                                      const string& tag,
+                                                      chain::comment_id_type parent,
+                                                      const Index& ridx, StartItr ridx_itr,
+                                                      uint32_t truncate_body = 0 );
+
       chain::comment_id_type get_parent( const discussion_query& q );
 
+      discussion_query_result get_pulled_discussions_by_feed( const discussion_query& q, const follow::pulled_feed_ptr& feed,
+                                                              const string& start_author, const string& start_permlink );
+
       chain::database& _db;
       std::shared_ptr< freezone::plugins::follow::follow_api > _follow_api;
+      active_votes_cache _active_votes;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
+      boost::signals2::connection   _post_apply_block_conn;
+      boost::signals2::connection   _reputation_conn;
 };
 
 DEFINE_API_IMPL( tags_api_impl, get_trending_tags )
@@ -174,10 +481,10 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_trending )
    auto tag = fc::to_lower( args.tag );
    auto parent = get_parent( args );
 
-   const auto& tidx = _db.get_index< tags::tag_index, tags::by_parent_trending >();
-   auto tidx_itr = tidx.lower_bound( boost::make_tuple( tag, parent, std::numeric_limits< double >::max() )  );
+   const auto& ridx = _db.get_index< tags::tag_rank_index, tags::by_parent_trending >();
+   auto ridx_itr = ridx.lower_bound( boost::make_tuple( tag, parent, std::numeric_limits< int64_t >::max() )  );
 
-   return get_discussions( args, tag, parent, tidx, tidx_itr, args.truncate_body, []( const database_api::api_comment_object& c ) { return c.net_rshares <= 0; } );
+   return get_ranked_discussions( args, tag, parent, ridx, ridx_itr, args.truncate_body );
 }
 
 DEFINE_API_IMPL( tags_api_impl, get_discussions_by_created )
@@ -248,10 +555,10 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_hot )
    auto tag = fc::to_lower( args.tag );
    auto parent = get_parent( args );
 
-   const auto& tidx = _db.get_index< tags::tag_index, tags::by_parent_hot >();
-   auto tidx_itr = tidx.lower_bound( boost::make_tuple( tag, parent, std::numeric_limits< double >::max() )  );
+   const auto& ridx = _db.get_index< tags::tag_rank_index, tags::by_parent_hot >();
+   auto ridx_itr = ridx.lower_bound( boost::make_tuple( tag, parent, std::numeric_limits< int64_t >::max() )  );
 
-   return get_discussions( args, tag, parent, tidx, tidx_itr, args.truncate_body, []( const database_api::api_comment_object& c ) { return c.net_rshares <= 0; } );
+   return get_ranked_discussions( args, tag, parent, ridx, ridx_itr, args.truncate_body );
 }
 
 DEFINE_API_IMPL( tags_api_impl, get_discussions_by_feed )
@@ -263,6 +570,10 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_feed )
 
    const auto& account = _db.get_account( args.tag );
 
+   auto* follow_plugin = appbase::app().find_plugin< follow::follow_plugin >();
+   if( follow_plugin != nullptr && follow_plugin->pull_feeds )
+      return get_pulled_discussions_by_feed( args, follow_plugin->get_pulled_feed( account.name ), start_author, start_permlink );
+
    const auto& c_idx = _db.get_index< follow::feed_index, follow::by_comment >();
    const auto& f_idx = _db.get_index< follow::feed_index, follow::by_feed >();
    auto feed_itr = f_idx.lower_bound( account.name );
@@ -276,6 +587,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_feed )
 
    get_discussions_by_feed_return result;
    result.discussions.reserve( args.limit );
+   result.fields = args.fields;
 
    while( result.discussions.size() < args.limit && feed_itr != f_idx.end() )
    {
@@ -283,7 +595,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_feed )
          break;
       try
       {
-         result.discussions.push_back( lookup_discussion( feed_itr->comment ) );
+         result.discussions.push_back( lookup_discussion( feed_itr->comment, 0, discussion_fields( args.fields ) ) );
          if( feed_itr->first_reblogged_by != account_name_type() )
          {
             result.discussions.back().reblogged_by = vector<account_name_type>( feed_itr->reblogged_by.begin(), feed_itr->reblogged_by.end() );
@@ -301,6 +613,44 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_feed )
    return result;
 }
 
+discussion_query_result tags_api_impl::get_pulled_discussions_by_feed( const discussion_query& q, const follow::pulled_feed_ptr& feed,
+                                                                      const string& start_author, const string& start_permlink )
+{
+   const auto& entries = feed->entries;
+   auto feed_itr = entries.begin();
+
+   if( start_author.size() || start_permlink.size() )
+   {
+      auto start_pos = feed->positions.find( _db.get_comment( start_author, start_permlink ).id );
+      FC_ASSERT( start_pos != feed->positions.end(), "Comment is not in account's feed" );
+      feed_itr = entries.begin() + start_pos->second;
+   }
+
+   discussion_query_result result;
+   result.discussions.reserve( q.limit );
+   result.fields = q.fields;
+
+   for( ; result.discussions.size() < q.limit && feed_itr != entries.end(); ++feed_itr )
+   {
+      try
+      {
+         result.discussions.push_back( lookup_discussion( feed_itr->comment, 0, discussion_fields( q.fields ) ) );
+         if( feed_itr->first_reblogged_by != account_name_type() )
+         {
+            result.discussions.back().reblogged_by = feed_itr->reblogged_by;
+            result.discussions.back().first_reblogged_by = feed_itr->first_reblogged_by;
+            result.discussions.back().first_reblogged_on = feed_itr->first_reblogged_on;
+         }
+      }
+      catch ( const fc::exception& e )
+      {
+         edump((e.to_detail_string()));
+      }
+   }
+
+   return result;
+}
+
 DEFINE_API_IMPL( tags_api_impl, get_discussions_by_blog )
 {
    args.validate();
@@ -325,6 +675,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_blog )
 
    get_discussions_by_blog_return result;
    result.discussions.reserve( args.limit );
+   result.fields = args.fields;
 
    while( result.discussions.size() < args.limit && blog_itr != b_idx.end() )
    {
@@ -354,7 +705,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_blog )
             }
          }
 
-         result.discussions.push_back( lookup_discussion( blog_itr->comment, args.truncate_body ) );
+         result.discussions.push_back( lookup_discussion( blog_itr->comment, args.truncate_body, discussion_fields( args.fields ) ) );
          if( blog_itr->reblogged_on > time_point_sec() )
          {
             result.discussions.back().first_reblogged_on = blog_itr->reblogged_on;
@@ -391,6 +742,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_comments )
    }
 
    result.discussions.reserve( args.limit );
+   result.fields = args.fields;
 
    while( result.discussions.size() < args.limit && comment_itr != t_idx.end() )
    {
@@ -400,7 +752,7 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_comments )
       {
          try
          {
-            result.discussions.push_back( lookup_discussion( comment_itr->id ) );
+            result.discussions.push_back( lookup_discussion( comment_itr->id, 0, discussion_fields( args.fields ) ) );
          }
          catch( const fc::exception& e )
          {
@@ -507,33 +859,155 @@ DEFINE_API_IMPL( tags_api_impl, get_discussions_by_author_before_date )
 DEFINE_API_IMPL( tags_api_impl, get_active_votes )
 {
    get_active_votes_return result;
-   const auto& comment = _db.get_comment( args.author, args.permlink );
-   const auto& idx = _db.get_index< chain::comment_vote_index, chain::by_comment_symbol_voter >();
-   chain::comment_id_type cid(comment.id);
-   auto itr = idx.lower_bound( boost::make_tuple( cid, freezone_SYMBOL ) );
-   while( itr != idx.end() && itr->comment == cid && itr->symbol == freezone_SYMBOL )
-   {
-      const auto& vo = _db.get( itr->voter );
-      vote_state vstate;
-      vstate.voter = vo.name;
-      vstate.weight = itr->weight;
-      vstate.rshares = itr->rshares;
-      vstate.percent = itr->vote_percent;
-      vstate.time = itr->last_update;
+   result.votes = get_active_votes( _db.get_comment( args.author, args.permlink ) );
+   return result;
+}
 
-      if( _follow_api )
+vote_state tags_api_impl::make_vote_state( const chain::comment_vote_object& cv, const account_name_type& voter )
+{
+   vote_state vstate;
+   vstate.voter = voter;
+   vstate.weight = cv.weight;
+   vstate.rshares = cv.rshares;
+   vstate.percent = cv.vote_percent;
+   vstate.time = cv.last_update;
+   return vstate;
+}
+
+vector< vote_state > tags_api_impl::get_active_votes( const chain::comment_object& comment )
+{
+   active_votes_stamp stamp( comment );
+   vector< vote_state > result;
+
+   if( !_active_votes.get( comment.id, stamp, result ) )
+   {
+      active_votes votes;
+      votes.stamp = stamp;
+
+      const auto& idx = _db.get_index< chain::comment_vote_index, chain::by_comment_symbol_voter >();
+      chain::comment_id_type cid(comment.id);
+      auto itr = idx.lower_bound( boost::make_tuple( cid, freezone_SYMBOL ) );
+      while( itr != idx.end() && itr->comment == cid && itr->symbol == freezone_SYMBOL )
       {
-         auto reps = _follow_api->get_account_reputations( follow::get_account_reputations_args( { vo.name, 1 } ) ).reputations;
-         if( reps.size() )
-            vstate.reputation = reps[0].reputation;
+         result.push_back( make_vote_state( *itr, _db.get( itr->voter ).name ) );
+         votes.votes.emplace_hint( votes.votes.end(), itr->voter, result.back() );
+         ++itr;
       }
 
-      result.votes.push_back( vstate );
-      ++itr;
+      _active_votes.insert( comment.id, std::move( votes ) );
+   }
+
+   if( _follow_api )
+   {
+      for( size_t i : _active_votes.get_reputations( result ) )
+      {
+         auto reps = _follow_api->get_account_reputations( follow::get_account_reputations_args( { result[i].voter, 1 } ) ).reputations;
+         if( reps.size() )
+            result[i].reputation = reps[0].reputation;
+
+         _active_votes.set_reputation( result[i].voter, result[i].reputation );
+      }
    }
+
    return result;
 }
 
+void tags_api_impl::invalidate_active_votes( const account_name_type& author, const string& permlink )
+{
+   const auto* comment = _db.find_comment( author, permlink.c_str(), permlink.size() );
+   if( comment != nullptr )
+      _active_votes.erase( comment->id );
+}
+
+void tags_api_impl::invalidate_stale_active_votes( const account_name_type& author, const string& permlink )
+{
+   const auto* comment = _db.find_comment( author, permlink.c_str(), permlink.size() );
+   if( comment != nullptr )
+      _active_votes.erase_stale( comment->id, active_votes_stamp( *comment ) );
+}
+
+void tags_api_impl::update_active_vote( const account_name_type& voter, const account_name_type& author, const string& permlink )
+{
+   const auto* comment = _db.find_comment( author, permlink.c_str(), permlink.size() );
+   if( comment == nullptr )
+      return;
+
+   const auto& voter_account = _db.get_account( voter );
+   const auto& idx = _db.get_index< chain::comment_vote_index, chain::by_comment_voter_symbol >();
+   auto itr = idx.find( boost::make_tuple( comment->id, voter_account.id, freezone_SYMBOL ) );
+
+   optional< vote_state > vote;
+   if( itr != idx.end() )
+      vote = make_vote_state( *itr, voter );
+
+   _active_votes.update_vote( comment->id, active_votes_stamp( *comment ), voter_account.id, vote );
+}
+
+uint64_t tags_api_impl::active_votes_cache_hits()
+{
+   return _active_votes.hits();
+}
+
+struct active_votes_pre_apply_visitor
+{
+   active_votes_pre_apply_visitor( tags_api_impl& my ) : _my( my ) {}
+   typedef void result_type;
+
+   tags_api_impl& _my;
+
+   /// Updating an entry in place requires it to match the comment before the vote
+   void operator()( const vote_operation& op )const  { _my.invalidate_stale_active_votes( op.author, op.permlink ); }
+   void operator()( const vote2_operation& op )const { _my.invalidate_stale_active_votes( op.author, op.permlink ); }
+
+   void operator()( const delete_comment_operation& op )const { _my.invalidate_active_votes( op.author, op.permlink ); }
+
+   template< typename Op >
+   void operator()( Op&& )const {} /// ignore all other ops
+};
+
+struct active_votes_post_apply_visitor
+{
+   active_votes_post_apply_visitor( tags_api_impl& my ) : _my( my ) {}
+   typedef void result_type;
+
+   tags_api_impl& _my;
+
+   void operator()( const vote_operation& op )const  { _my.update_active_vote( op.voter, op.author, op.permlink ); }
+   void operator()( const vote2_operation& op )const { _my.update_active_vote( op.voter, op.author, op.permlink ); }
+
+   void operator()( const comment_payout_update_operation& op )const { _my.invalidate_active_votes( op.author, op.permlink ); }
+   void operator()( const comment_reward_operation& op )const        { _my.invalidate_active_votes( op.author, op.permlink ); }
+
+   template< typename Op >
+   void operator()( Op&& )const {} /// ignore all other ops
+};
+
+void tags_api_impl::on_pre_apply_operation( const operation_notification& note )
+{
+   try
+   {
+      /// plugins shouldn't ever throw
+      note.op.visit( active_votes_pre_apply_visitor( *this ) );
+   }
+   catch ( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+   }
+}
+
+void tags_api_impl::on_post_apply_operation( const operation_notification& note )
+{
+   try
+   {
+      /// plugins shouldn't ever throw
+      note.op.visit( active_votes_post_apply_visitor( *this ) );
+   }
+   catch ( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+   }
+}
+
 void tags_api_impl::set_pending_payout( discussion& d )
 {
    const auto& cidx = _db.get_index< tags::tag_index, tags::by_comment>();
@@ -585,29 +1059,36 @@ void tags_api_impl::set_pending_payout( discussion& d )
    if( d.parent_author != freezone_ROOT_POST_PARENT )
       d.cashout_time = _db.calculate_discussion_payout_time( _db.get< chain::comment_object >( d.id ) );
 
-   if( d.body.size() > 1024*128 )
-      d.body = "body pruned due to size";
-   if( d.parent_author.size() > 0 && d.body.size() > 1024*16 )
-      d.body = "comment pruned due to size";
+   prune_body( d );
 
    set_url( d );
 }
 
 void tags_api_impl::set_url( discussion& d )
 {
-   const database_api::api_comment_object root( _db.get_comment( d.root_author, d.root_permlink ), _db );
-   d.url = "/" + root.category + "/@" + root.author + "/" + root.permlink;
-   d.root_title = root.title;
+   const auto& root = _db.get_comment( d.root_author, d.root_permlink );
+   d.url = "/" + chain::to_string( root.category ) + "/@" + string( root.author ) + "/" + chain::to_string( root.permlink );
+#ifndef IS_LOW_MEM
+   d.root_title = chain::to_string( _db.get< chain::comment_content_object, chain::by_comment >( root.id ).title );
+#endif
    if( root.id != d.id )
       d.url += "#@" + d.author + "/" + d.permlink;
 }
 
-discussion tags_api_impl::lookup_discussion( chain::comment_id_type id, uint32_t truncate_body )
+discussion tags_api_impl::lookup_discussion( chain::comment_id_type id, uint32_t truncate_body, const discussion_fields& fields )
 {
-   discussion d( _db.get( id ), _db );
-   set_url( d );
-   set_pending_payout( d );
-   d.active_votes = get_active_votes( get_active_votes_args( { d.author, d.permlink } ) ).votes;
+   discussion d( _db.get( id ), _db, fields.content() );
+
+   // set_pending_payout() also sets the url
+   if( fields.payout() )
+      set_pending_payout( d );
+   else if( fields.url() )
+      set_url( d );
+
+   if( fields.has( "active_votes" ) )
+      d.active_votes = get_active_votes( _db.get( id ) );
+
+   prune_body( d );
    d.body_length = d.body.size();
    if( truncate_body )
    {
@@ -616,6 +1097,14 @@ discussion tags_api_impl::lookup_discussion( chain::comment_id_type id, uint32_t
       if( !fc::is_utf8( d.body ) )
          d.body = fc::prune_invalid_utf8( d.body );
    }
+
+   if( !fields.all )
+   {
+      if( !fields.has( "title" ) )           d.title.clear();
+      if( !fields.has( "body" ) )            d.body.clear();
+      if( !fields.has( "json_metadata" ) )   d.json_metadata.clear();
+   }
+
    return d;
 }
 
@@ -632,6 +1121,7 @@ discussion_query_result tags_api_impl::get_discussions( const discussion_query&
                                                         )
 {
    discussion_query_result result;
+   result.fields = query.fields;
 
    const auto& cidx = _db.get_index< tags::tag_index, tags::by_comment >();
    chain::comment_id_type start;
@@ -651,6 +1141,7 @@ discussion_query_result tags_api_impl::get_discussions( const discussion_query&
       }
    }
 
+   discussion_fields fields( query.fields );
    uint32_t count = query.limit;
    uint64_t itr_count = 0;
    uint64_t filter_count = 0;
@@ -670,7 +1161,7 @@ discussion_query_result tags_api_impl::get_discussions( const discussion_query&
          break;
       try
       {
-         result.discussions.push_back( lookup_discussion( tidx_itr->comment, truncate_body ) );
+         result.discussions.push_back( lookup_discussion( tidx_itr->comment, truncate_body, fields ) );
          result.discussions.back().promoted = asset(tidx_itr->promoted_balance, SBD_SYMBOL );
 
          if( filter( result.discussions.back() ) )
@@ -696,6 +1187,53 @@ discussion_query_result tags_api_impl::get_discussions( const discussion_query&
    return result;
 }
 
+template<typename Index, typename StartItr>
+discussion_query_result tags_api_impl::get_ranked_discussions( const discussion_query& query,
+                                                               const string& tag,
+                                                               chain::comment_id_type parent,
+                                                               const Index& ridx, StartItr ridx_itr,
+                                                               uint32_t truncate_body )
+{
+   discussion_query_result result;
+   result.discussions.reserve( query.limit );
+   result.fields = query.fields;
+
+   if( query.start_author && query.start_permlink )
+   {
+      auto start = _db.get_comment( *query.start_author, *query.start_permlink ).id;
+      const auto& cidx = _db.get_index< tags::tag_index, tags::by_comment >();
+      auto itr = cidx.find( start );
+      while( itr != cidx.end() && itr->comment == start && itr->tag != tag )
+         ++itr;
+
+      FC_ASSERT( itr != cidx.end() && itr->comment == start, "Comment is not in tag ${t}", ("t", tag) );
+
+      // Only discussions with a positive net_rshares are ranked
+      const auto* rank = _db.find< tags::tag_rank_object, tags::by_tag_id >( itr->id );
+      FC_ASSERT( rank != nullptr && rank->parent == parent, "Comment is not ranked in tag ${t}", ("t", tag) );
+      ridx_itr = ridx.iterator_to( *rank );
+   }
+
+   discussion_fields fields( query.fields );
+   for( ; result.discussions.size() < query.limit && ridx_itr != ridx.end(); ++ridx_itr )
+   {
+      if( ridx_itr->tag != tag || ridx_itr->parent != parent )
+         break;
+
+      try
+      {
+         result.discussions.push_back( lookup_discussion( ridx_itr->comment, truncate_body, fields ) );
+         result.discussions.back().promoted = asset( _db.get( ridx_itr->tag_id ).promoted_balance, SBD_SYMBOL );
+      }
+      catch ( const fc::exception& e )
+      {
+         edump((e.to_detail_string()));
+      }
+   }
+
+   return result;
+}
+
 chain::comment_id_type tags_api_impl::get_parent( const discussion_query& query )
 {
    chain::comment_id_type parent;
@@ -707,7 +1245,7 @@ chain::comment_id_type tags_api_impl::get_parent( const discussion_query& query
 
 } // detail
 
-tags_api::tags_api(): my( new detail::tags_api_impl() )
+tags_api::tags_api( uint32_t active_votes_cache_size ): my( new detail::tags_api_impl( active_votes_cache_size ) )
 {
    JSON_RPC_REGISTER_API( freezone_TAGS_API_PLUGIN_NAME );
 }
@@ -742,12 +1280,46 @@ void tags_api::set_pending_payout( discussion& d )
    my->set_pending_payout( d );
 }
 
+uint64_t tags_api::active_votes_cache_hits()const
+{
+   return my->active_votes_cache_hits();
+}
+
 void tags_api::api_startup()
 {
    auto follow_api_plugin = appbase::app().find_plugin< freezone::plugins::follow::follow_api_plugin >();
 
    if( follow_api_plugin != nullptr )
+   {
       my->_follow_api = follow_api_plugin->api;
+
+      my->_reputation_conn = appbase::app().get_plugin< freezone::plugins::follow::follow_plugin >().reputation_updated.connect(
+         [&]( const account_name_type& account ){ my->_active_votes.invalidate_reputation( account ); } );
+   }
+}
+
+void tags_api::api_shutdown()
+{
+   chain::util::disconnect_signal( my->_pre_apply_operation_conn );
+   chain::util::disconnect_signal( my->_post_apply_operation_conn );
+   chain::util::disconnect_signal( my->_post_apply_block_conn );
+   chain::util::disconnect_signal( my->_reputation_conn );
+}
+
+void to_variant( const discussion_query_result& r, fc::variant& v )
+{
+   if( !r.fields.valid() )
+   {
+      v = fc::mutable_variant_object( "discussions", r.discussions );
+      return;
+   }
+
+   vector< fc::variant > discussions( r.discussions.size() );
+
+   for( size_t i = 0; i < r.discussions.size(); ++i )
+      selected_members_to_variant( r.discussions[i], *r.fields, discussions[i] );
+
+   v = fc::mutable_variant_object( "discussions", std::move( discussions ) );
 }
 
 } } } // freezone::plugins::tags
@@ -7,14 +7,19 @@ namespace freezone { namespace plugins { namespace tags {
 tags_api_plugin::tags_api_plugin() {}
 tags_api_plugin::~tags_api_plugin() {}
 
-void tags_api_plugin::set_program_options( options_description& cli, options_description& cfg ) {}
+void tags_api_plugin::set_program_options( options_description& cli, options_description& cfg )
+{
+   cfg.add_options()
+      ("tags-api-active-votes-cache-size", boost::program_options::value< uint32_t >()->default_value( 10000 ), "Number of comments whose active votes are cached. 0 disables the cache." )
+      ;
+}
 
 void tags_api_plugin::plugin_initialize( const variables_map& options )
 {
-   api = std::make_shared< tags_api >();
+   api = std::make_shared< tags_api >( options.at( "tags-api-active-votes-cache-size" ).as< uint32_t >() );
 }
 
 void tags_api_plugin::plugin_startup() { api->api_startup(); }
-void tags_api_plugin::plugin_shutdown() {}
+void tags_api_plugin::plugin_shutdown() { api->api_shutdown(); }
 
 } } } // freezone::plugins::tags
@@ -1,5 +1,6 @@
 #include <freezone/chain/freezone_fwd.hpp>
 
+#include <freezone/chain/block_prevalidation.hpp>
 #include <freezone/chain/database_exceptions.hpp>
 #include <freezone/chain/transaction_object.hpp>
 
@@ -21,17 +22,21 @@
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/thread/future.hpp>
 #include <boost/lockfree/queue.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <thread>
 #include <memory>
 #include <iostream>
 #include <future>
+#include <map>
+#include <mutex>
 
 namespace freezone { namespace plugins { namespace chain {
 
 using namespace freezone;
 using fc::flat_map;
 using freezone::chain::block_id_type;
+using freezone::chain::prevalidated_block;
 namespace asio = boost::asio;
 
 #define NUM_THREADS 1
@@ -51,13 +56,25 @@ struct generate_block_request
    signed_block block;
 };
 
-typedef fc::static_variant< const signed_block*, const signed_transaction*, generate_block_request* > write_request_ptr;
+struct transaction_batch
+{
+   transaction_batch( const std::vector< signed_transaction >& t ) :
+      trxs( t ),
+      results( t.size() ) {}
+
+   const std::vector< signed_transaction >&        trxs;
+   std::vector< fc::optional< fc::exception > >    results;
+   size_t                                          next = 0; ///< first transaction not pushed yet
+};
+
+typedef fc::static_variant< const signed_block*, const signed_transaction*, generate_block_request*, transaction_batch* > write_request_ptr;
 typedef fc::static_variant< boost::promise< void >*, fc::future< void >* > promise_ptr;
 
 struct write_context
 {
    write_request_ptr             req_ptr;
    uint32_t                      skip = 0;
+   const prevalidated_block*     prevalidated = nullptr;
    bool                          success = true;
    fc::optional< fc::exception > except;
    promise_ptr                   prom_ptr;
@@ -69,15 +86,22 @@ class chain_plugin_impl
 {
    public:
       chain_plugin_impl() : write_queue( 64 ) {}
-      ~chain_plugin_impl() { stop_write_processing(); }
+      ~chain_plugin_impl() { stop_write_processing(); stop_prevalidation(); }
 
       void start_write_processing();
       void stop_write_processing();
+      void start_prevalidation();
+      void stop_prevalidation();
       void write_default_database_config( bfs::path& p );
 
       void post_block( const block_notification& note );
 
       uint64_t                         shared_memory_size = 0;
+      bool                             comment_body_store = false;
+      bool                             compact_comment_body_store = false;
+      uint64_t                         comment_body_cache_size = 0;
+      uint32_t                         comment_payout_threads = 0;
+      uint32_t                         signature_recovery_threads = 1;
       uint16_t                         shared_file_full_threshold = 0;
       uint16_t                         shared_file_scale_rate = 0;
       int16_t                          sps_remove_threshold = -1;
@@ -108,6 +132,11 @@ class chain_plugin_impl
       boost::lockfree::queue< write_context* > write_queue;
       int16_t                          write_lock_hold_time = 500;
 
+      uint32_t                         prevalidation_threads = 0;
+      boost::thread_group              prevalidation_pool;
+      asio::io_service                 prevalidation_ios;
+      std::unique_ptr< asio::io_service::work > prevalidation_work;
+
       flat_map< string, fc::variant_object > plugin_state_opts;
       bfs::path                        database_cfg;
 
@@ -124,8 +153,11 @@ struct write_request_visitor
 
    database* db;
    uint32_t  skip = 0;
+   const prevalidated_block* prevalidated = nullptr;
    fc::optional< fc::exception >* except;
    std::shared_ptr< abstract_block_producer > block_generator;
+   fc::time_point lock_deadline = fc::time_point::maximum(); ///< when a batch should give the write lock back to readers
+   bool           deferred = false;                          ///< set when a batch stopped early and must be resumed
 
    typedef bool result_type;
 
@@ -136,7 +168,7 @@ struct write_request_visitor
       try
       {
          STATSD_START_TIMER( "chain", "write_time", "push_block", 1.0f )
-         result = db->push_block( *block, skip );
+         result = db->push_block( *block, skip, prevalidated );
          STATSD_STOP_TIMER( "chain", "write_time", "push_block" )
       }
       catch( fc::exception& e )
@@ -177,6 +209,38 @@ struct write_request_visitor
       return result;
    }
 
+   bool operator()( transaction_batch* batch )
+   {
+      STATSD_START_TIMER( "chain", "write_time", "push_transactions", 1.0f )
+      size_t first = batch->next;
+      for( size_t& i = batch->next; i < batch->trxs.size(); ++i )
+      {
+         // always make progress, but don't keep readers waiting longer than a single request would
+         if( i > first && fc::time_point::now() > lock_deadline )
+         {
+            deferred = true;
+            break;
+         }
+
+         try
+         {
+            db->push_transaction( batch->trxs[i] );
+         }
+         catch( fc::exception& e )
+         {
+            batch->results[i] = e;
+         }
+         catch( ... )
+         {
+            batch->results[i] = fc::unhandled_exception( FC_LOG_MESSAGE( warn, "Unexpected exception while pushing transaction." ),
+                                                         std::current_exception() );
+         }
+      }
+      STATSD_STOP_TIMER( "chain", "write_time", "push_transactions" )
+
+      return true;
+   }
+
    bool operator()( generate_block_request* req )
    {
       bool result = false;
@@ -229,7 +293,7 @@ void chain_plugin_impl::start_write_processing()
    write_processor_thread = std::make_shared< std::thread >( [&]()
    {
       bool is_syncing = true;
-      write_context* cxt;
+      write_context* cxt = nullptr;
       fc::time_point_sec start = fc::time_point::now();
       write_request_visitor req_visitor;
       req_visitor.db = &db;
@@ -261,7 +325,8 @@ void chain_plugin_impl::start_write_processing()
          if( !is_syncing )
             start = fc::time_point::now();
 
-         if( write_queue.pop( cxt ) )
+         // a transaction batch that gave the lock back is resumed before anything else in the queue
+         if( cxt != nullptr || write_queue.pop( cxt ) )
          {
             db.with_write_lock( [&]()
             {
@@ -269,8 +334,16 @@ void chain_plugin_impl::start_write_processing()
                while( running )
                {
                   req_visitor.skip = cxt->skip;
+                  req_visitor.prevalidated = cxt->prevalidated;
                   req_visitor.except = &(cxt->except);
+                  req_visitor.lock_deadline = !is_syncing && write_lock_hold_time >= 0 ?
+                     start + fc::milliseconds( write_lock_hold_time ) : fc::time_point::maximum();
+                  req_visitor.deferred = false;
                   cxt->success = cxt->req_ptr.visit( req_visitor );
+
+                  if( req_visitor.deferred )
+                     break;
+
                   cxt->prom_ptr.visit( prom_visitor );
 
                   if( is_syncing && start - db.head_block_time() < fc::minutes(1) )
@@ -281,11 +354,13 @@ void chain_plugin_impl::start_write_processing()
 
                   if( !is_syncing && write_lock_hold_time >= 0 && fc::time_point::now() - start > fc::milliseconds( write_lock_hold_time ) )
                   {
+                     cxt = nullptr;
                      break;
                   }
 
                   if( !write_queue.pop( cxt ) )
                   {
+                     cxt = nullptr;
                      break;
                   }
                }
@@ -308,6 +383,27 @@ void chain_plugin_impl::stop_write_processing()
    write_processor_thread.reset();
 }
 
+void chain_plugin_impl::start_prevalidation()
+{
+   if( prevalidation_threads == 0 )
+      return;
+
+   prevalidation_work.reset( new asio::io_service::work( prevalidation_ios ) );
+
+   for( uint32_t i = 0; i < prevalidation_threads; ++i )
+      prevalidation_pool.create_thread( boost::bind( &asio::io_service::run, &prevalidation_ios ) );
+}
+
+void chain_plugin_impl::stop_prevalidation()
+{
+   if( !prevalidation_work )
+      return;
+
+   prevalidation_work.reset();
+   prevalidation_ios.stop();
+   prevalidation_pool.join_all();
+}
+
 void chain_plugin_impl::write_default_database_config( bfs::path &p )
 {
    ilog( "writing database configuration: ${p}", ("p", p.string()) );
@@ -351,6 +447,15 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("checkpoint,c", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
          ("flush-state-interval", bpo::value<uint32_t>(),
             "flush shared memory changes to disk every N blocks")
+         ("comment-body-store", bpo::value<bool>()->default_value(false),
+            "Store new comment bodies in an append only file next to the shared memory file instead of in shared memory. Cannot be combined with to-state, state files do not include these bodies.")
+         ("comment-body-cache-size", bpo::value<string>()->default_value("256M"), "Size of the in memory cache of recently read comment bodies kept outside of shared memory.")
+         ("comment-payout-threads", bpo::value<uint32_t>()->default_value(2),
+            "Number of threads computing the rewards of comments paid out in a block before they are applied in order. 0 computes them on the write thread.")
+         ("signature-recovery-threads", bpo::value<uint32_t>()->default_value(2),
+            "Number of threads recovering the signature keys of the transactions in a block, all signatures of the block being recovered together.")
+         ("sync-prevalidation-threads", bpo::value<uint32_t>()->default_value(2),
+            "Number of threads performing state independent block checks (merkle root, signatures, size) ahead of the write thread while syncing. 0 disables prevalidation.")
          ("from-state", bpo::value<string>()->default_value(""), "Load from state, then replay subsequent blocks")
          ("to-state", bpo::value<string>()->default_value(""), "File to save state to on shutdown")
          ("state-format", bpo::value<string>()->default_value("binary"), "State file save format (binary|json)")
@@ -369,6 +474,7 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("dump-memory-details", bpo::bool_switch()->default_value(false), "Dump database objects memory usage info. Use set-benchmark-interval to set dump interval.")
          ("check-locks", bpo::bool_switch()->default_value(false), "Check correctness of chainbase locking")
          ("validate-database-invariants", bpo::bool_switch()->default_value(false), "Validate all supply invariants check out")
+         ("compact-comment-body-store", bpo::bool_switch()->default_value(false), "Rewrite the comment body store on startup, dropping the bodies replaced by edits or deleted")
 #ifdef ENABLE_MIRA
          ("database-cfg", bpo::value<bfs::path>()->default_value("database.cfg"), "The database configuration file location")
          ("memory-replay,m", bpo::bool_switch()->default_value(false), "Replay with state in memory instead of on disk")
@@ -393,6 +499,11 @@ void chain_plugin::plugin_initialize(const variables_map& options)
    }
 
    my->shared_memory_size = fc::parse_size( options.at( "shared-file-size" ).as< string >() );
+   my->comment_body_store = options.at( "comment-body-store" ).as< bool >();
+   my->compact_comment_body_store = options.at( "compact-comment-body-store" ).as< bool >();
+   my->comment_body_cache_size = fc::parse_size( options.at( "comment-body-cache-size" ).as< string >() );
+   my->comment_payout_threads = options.at( "comment-payout-threads" ).as< uint32_t >();
+   my->signature_recovery_threads = options.at( "signature-recovery-threads" ).as< uint32_t >();
 
    if( options.count( "shared-file-full-threshold" ) )
       my->shared_file_full_threshold = options.at( "shared-file-full-threshold" ).as< uint16_t >();
@@ -420,6 +531,11 @@ void chain_plugin::plugin_initialize(const variables_map& options)
    else
       my->flush_interval = 10000;
 
+   my->prevalidation_threads = options.at( "sync-prevalidation-threads" ).as< uint32_t >();
+
+   FC_ASSERT( !( my->comment_body_store && my->to_state != "" ),
+      "to-state cannot be used with comment-body-store, comment bodies kept outside of shared memory are not written to state files" );
+
    if( options.at( "state-format" ).as<string>() == "binary" )
    {
       my->state_format.is_binary = true;
@@ -571,8 +687,13 @@ void chain_plugin::plugin_startup()
    db_open_args.database_cfg = database_config;
    db_open_args.replay_in_memory = my->replay_in_memory;
    db_open_args.replay_memory_indices = my->replay_memory_indices;
+   db_open_args.comment_body_store = my->comment_body_store;
+   db_open_args.compact_comment_body_store = my->compact_comment_body_store;
+   db_open_args.comment_body_cache_size = my->comment_body_cache_size;
+   db_open_args.comment_payout_threads = my->comment_payout_threads;
+   db_open_args.signature_recovery_threads = my->signature_recovery_threads;
 
-   auto benchmark_lambda = [&dumper, &get_indexes_memory_details, dump_memory_details] ( uint32_t current_block_number,
+   auto benchmark_lambda = [&dumper, &get_indexes_memory_details, dump_memory_details, &db = my->db] ( uint32_t current_block_number,
       const chainbase::database::abstract_index_cntr_t& abstract_index_cntr )
    {
       if( current_block_number == 0 ) // initial call
@@ -595,14 +716,24 @@ void chain_plugin::plugin_startup()
          return;
       }
 
+      const auto& arena_stats = db.get_block_arena().get_statistics();
+      freezone::utilities::benchmark_dumper::allocation_counters arena;
+      arena.allocations = arena_stats.allocations;
+      arena.bytes = arena_stats.bytes;
+      arena.peak_block_bytes = arena_stats.peak_block_bytes;
+      arena.chunk_allocations = arena_stats.chunk_allocations;
+
       const freezone::utilities::benchmark_dumper::measurement& measure =
-         dumper.measure(current_block_number, get_indexes_memory_details);
-      ilog( "Performance report at block ${n}. Elapsed time: ${rt} ms (real), ${ct} ms (cpu). Memory usage: ${cm} (current), ${pm} (peak) kilobytes.",
+         dumper.measure(current_block_number, get_indexes_memory_details, arena);
+      ilog( "Performance report at block ${n}. Elapsed time: ${rt} ms (real), ${ct} ms (cpu). Memory usage: ${cm} (current), ${pm} (peak) kilobytes. Block arena: ${aa} allocations, ${ab} bytes, ${ap} peak bytes per block.",
          ("n", current_block_number)
          ("rt", measure.real_ms)
          ("ct", measure.cpu_ms)
          ("cm", measure.current_mem)
-         ("pm", measure.peak_mem) );
+         ("pm", measure.peak_mem)
+         ("aa", measure.arena_allocations)
+         ("ab", measure.arena_bytes)
+         ("ap", measure.arena_peak_block_bytes) );
    };
 
    if(my->replay || (my->from_state != ""))
@@ -674,11 +805,13 @@ void chain_plugin::plugin_startup()
    }
 
    my->start_write_processing();
+   my->start_prevalidation();
 }
 
 void chain_plugin::plugin_shutdown()
 {
    ilog("closing chain database");
+   my->stop_prevalidation();
    my->stop_write_processing();
 
    if( my->to_state != "" )
@@ -714,7 +847,8 @@ flat_map< string, fc::variant_object >& chain_plugin::get_state_options() const
    return my->plugin_state_opts;
 }
 
-bool chain_plugin::accept_block( const freezone::chain::signed_block& block, bool currently_syncing, uint32_t skip )
+bool chain_plugin::accept_block( const freezone::chain::signed_block& block, bool currently_syncing, uint32_t skip,
+   const prevalidation_future& prevalidation )
 {
    if (currently_syncing && block.block_num() % 10000 == 0) {
       ilog("Syncing Blockchain --- Got block: #${n} time: ${t} producer: ${p}",
@@ -731,6 +865,17 @@ bool chain_plugin::accept_block( const freezone::chain::signed_block& block, boo
    cxt.skip = skip;
    cxt.prom_ptr = &prom;
 
+   // The results were computed from this block, the id only guards against a future passed with the wrong block
+   if( prevalidation.valid() && my->prevalidation_work )
+   {
+      try
+      {
+         if( prevalidation.get().block_id == block.id() )
+            cxt.prevalidated = &prevalidation.get();
+      }
+      catch( ... ) {}
+   }
+
    my->write_queue.push( &cxt );
 
    prom.get_future().get();
@@ -740,6 +885,25 @@ bool chain_plugin::accept_block( const freezone::chain::signed_block& block, boo
    return cxt.success;
 }
 
+chain_plugin::prevalidation_future chain_plugin::prevalidate_block( const freezone::chain::signed_block& block, uint32_t skip )
+{
+   if( !my->prevalidation_work )
+      return prevalidation_future();
+
+   auto task = std::make_shared< std::packaged_task< prevalidated_block() > >(
+      [block, skip, chain_id = my->db.get_chain_id(), impl = my.get(),
+       helpers = std::max< uint32_t >( my->signature_recovery_threads, 1 ) - 1]()
+      {
+         // Signatures are recovered with the help of the other prevalidation threads
+         auto post = [impl]( std::function< void() > task ) { impl->prevalidation_ios.post( std::move( task ) ); };
+         return freezone::chain::prevalidate_block( block, chain_id, !( skip & database::skip_transaction_signatures ), post, helpers );
+      } );
+
+   auto result = task->get_future().share();
+   my->prevalidation_ios.post( [task]() { (*task)(); } );
+   return result;
+}
+
 void chain_plugin::accept_transaction( const freezone::chain::signed_transaction& trx )
 {
    boost::promise< void > prom;
@@ -756,6 +920,24 @@ void chain_plugin::accept_transaction( const freezone::chain::signed_transaction
    return;
 }
 
+std::vector< fc::optional< fc::exception > > chain_plugin::accept_transactions( const std::vector< freezone::chain::signed_transaction >& trxs )
+{
+   transaction_batch batch( trxs );
+
+   boost::promise< void > prom;
+   write_context cxt;
+   cxt.req_ptr = &batch;
+   cxt.prom_ptr = &prom;
+
+   my->write_queue.push( &cxt );
+
+   prom.get_future().get();
+
+   if( cxt.except ) throw *(cxt.except);
+
+   return std::move( batch.results );
+}
+
 freezone::chain::signed_block chain_plugin::generate_block(
    const fc::time_point_sec when,
    const account_name_type& witness_owner,
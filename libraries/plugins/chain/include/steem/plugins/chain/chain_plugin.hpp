@@ -2,10 +2,13 @@
 #include <freezone/chain/freezone_fwd.hpp>
 #include <appbase/application.hpp>
 #include <freezone/chain/database.hpp>
+#include <freezone/chain/block_prevalidation.hpp>
 #include <freezone/plugins/chain/abstract_block_producer.hpp>
 
 #include <boost/signals2.hpp>
 
+#include <future>
+
 #define freezone_CHAIN_PLUGIN_NAME "chain"
 
 namespace freezone { namespace plugins { namespace chain {
@@ -38,8 +41,32 @@ public:
    void report_state_options( const string& plugin_name, const fc::variant_object& opts );
    flat_map< string, fc::variant_object >& get_state_options() const;
 
-   bool accept_block( const freezone::chain::signed_block& block, bool currently_syncing, uint32_t skip );
+   typedef std::shared_future< freezone::chain::prevalidated_block > prevalidation_future;
+
+   /**
+    * When valid, prevalidation must have been returned by prevalidate_block() for this block or a copy
+    * of it. Its results are then used instead of repeating the state independent checks.
+    */
+   bool accept_block( const freezone::chain::signed_block& block, bool currently_syncing, uint32_t skip,
+      const prevalidation_future& prevalidation = prevalidation_future() );
+
+   /**
+    * Queue the state independent checks of a block that is expected to be passed to accept_block()
+    * shortly, so they run on the prevalidation thread pool while the write thread is busy with
+    * earlier blocks. The skip flags should match those the block will be accepted with.
+    *
+    * The caller keeps the returned future with the block and passes it to accept_block(). The future
+    * is not valid when prevalidation is disabled.
+    */
+   prevalidation_future prevalidate_block( const freezone::chain::signed_block& block, uint32_t skip );
    void accept_transaction( const freezone::chain::signed_transaction& trx );
+
+   /**
+    * Push several transactions in a single write request. The transactions are pushed in order
+    * and independently; the result for each is empty on success or holds the exception that
+    * rejected it.
+    */
+   std::vector< fc::optional< fc::exception > > accept_transactions( const std::vector< freezone::chain::signed_transaction >& trxs );
    freezone::chain::signed_block generate_block(
       const fc::time_point_sec when,
       const account_name_type& witness_owner,
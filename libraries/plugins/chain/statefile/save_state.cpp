@@ -349,6 +349,9 @@ void sink_impl::write( const std::string& s )
 
 write_state_result write_state( const database& db, const std::string& state_filename, const state_format_info& state_format )
 {
+   FC_ASSERT( !db.has_comment_body_store_bodies(),
+      "Cannot write a state file while comment bodies are kept in the comment body store, they would not be included. Replay with comment-body-store disabled first." );
+
    std::ofstream out( state_filename, std::ios::binary );
    //
    // We have three layers:
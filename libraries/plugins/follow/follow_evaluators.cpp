@@ -52,6 +52,9 @@ void follow_evaluator::do_apply( const follow_operation& o )
 
       bool was_followed = false;
 
+      if( _plugin->pull_feeds )
+         _plugin->get_pulled_feed_cache().invalidate_feed( o.follower );
+
       if( itr == idx.end() )
       {
          _db.create< follow_object >( [&]( follow_object& obj )
@@ -151,6 +154,9 @@ void reblog_evaluator::do_apply( const reblog_operation& o )
          b.blog_feed_id = next_blog_id;
       });
 
+      if( _plugin->pull_feeds )
+         _plugin->get_pulled_feed_cache().invalidate_blog( o.account );
+
       const auto& stats_idx = _db.get_index< blog_author_stats_index,by_blogger_guest_count>();
       auto stats_itr = stats_idx.lower_bound( boost::make_tuple( o.account, c.author ) );
       if( stats_itr != stats_idx.end() && stats_itr->blogger == o.account && stats_itr->guest == c.author ) {
@@ -175,7 +181,7 @@ void reblog_evaluator::do_apply( const reblog_operation& o )
 
       performance_data pd;
 
-      if( _db.head_block_time() >= _plugin->start_feeds )
+      if( !_plugin->pull_feeds && _db.head_block_time() >= _plugin->start_feeds )
       {
          while( itr != idx.end() && itr->following == o.account )
          {
@@ -31,7 +31,8 @@ class follow_plugin_impl
    public:
       follow_plugin_impl( follow_plugin& _plugin ) :
          _db( appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db() ),
-         _self( _plugin ) {}
+         _self( _plugin ),
+         _pulled_feeds( _db ) {}
       ~follow_plugin_impl() {}
 
       void pre_operation( const operation_notification& op_obj );
@@ -39,8 +40,10 @@ class follow_plugin_impl
 
       chain::database&              _db;
       follow_plugin&                _self;
-      boost::signals2::connection   _pre_apply_operation_conn;
-      boost::signals2::connection   _post_apply_operation_conn;
+      pulled_feed_cache             _pulled_feeds;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
+      boost::signals2::connection   _post_apply_block_conn;
 };
 
 struct pre_operation_visitor
@@ -138,6 +141,8 @@ struct pre_operation_visitor
          {
             const auto& old_blog = *blog_itr;
             ++blog_itr;
+            if( _plugin._self.pull_feeds )
+               _plugin._pulled_feeds.invalidate_blog( old_blog.account );
             db.remove( old_blog );
          }
       }
@@ -259,7 +264,7 @@ struct post_operation_visitor
 
          performance_data pd;
 
-         if( db.head_block_time() >= _plugin._self.start_feeds )
+         if( !_plugin._self.pull_feeds && db.head_block_time() >= _plugin._self.start_feeds )
          {
             while( itr != idx.end() && itr->following == op.author )
             {
@@ -312,6 +317,9 @@ struct post_operation_visitor
                b.blog_feed_id = next_id;
             });
          }
+
+         if( _plugin._self.pull_feeds )
+            _plugin._pulled_feeds.invalidate_blog( op.author );
       }
       FC_LOG_AND_RETHROW()
    }
@@ -319,11 +327,13 @@ struct post_operation_visitor
    void operator()( const vote_operation& op )const
    {
       post_update_reputation( op );
+      _plugin._self.reputation_updated( op.author );
    }
 
    void operator()( const vote2_operation& op )const
    {
       post_update_reputation( op );
+      _plugin._self.reputation_updated( op.author );
    }
 };
 
@@ -365,6 +375,8 @@ void follow_plugin::set_program_options(
    cfg.add_options()
       ("follow-max-feed-size", boost::program_options::value< uint32_t >()->default_value( 500 ), "Set the maximum size of cached feed for an account" )
       ("follow-start-feeds", boost::program_options::value< uint32_t >()->default_value( 0 ), "Block time (in epoch seconds) when to start calculating feeds" )
+      ("follow-pull-feeds", boost::program_options::value< bool >()->default_value( false ), "Compute feeds from the blogs of followed accounts when they are queried instead of writing every post to the feed of each follower" )
+      ("follow-feed-cache-size", boost::program_options::value< uint32_t >()->default_value( 1000 ), "Number of accounts whose computed feed is cached when follow-pull-feeds is enabled" )
       ;
 }
 
@@ -386,8 +398,9 @@ void follow_plugin::plugin_initialize( const boost::program_options::variables_m
       // Add the registry to the database so the database can delegate custom ops to the plugin
       my->_db.register_custom_operation_interpreter( _custom_operation_interpreter );
 
-      my->_pre_apply_operation_conn = my->_db.add_pre_apply_operation_handler( [&]( const operation_notification& note ){ my->pre_operation( note ); }, *this, 0 );
-      my->_post_apply_operation_conn = my->_db.add_post_apply_operation_handler( [&]( const operation_notification& note ){ my->post_operation( note ); }, *this, 0 );
+      my->_pre_apply_operation_conn = my->_db.subscribe_pre_apply_operation< vote_operation, vote2_operation, delete_comment_operation >( [&]( const operation_notification& note ){ my->pre_operation( note ); }, *this, 0 );
+      my->_post_apply_operation_conn = my->_db.subscribe_post_apply_operation< custom_json_operation, comment_operation,
+         vote_operation, vote2_operation >( [&]( const operation_notification& note ){ my->post_operation( note ); }, *this, 0 );
       freezone_ADD_PLUGIN_INDEX(my->_db, follow_index);
       freezone_ADD_PLUGIN_INDEX(my->_db, feed_index);
       freezone_ADD_PLUGIN_INDEX(my->_db, blog_index);
@@ -410,6 +423,23 @@ void follow_plugin::plugin_initialize( const boost::program_options::variables_m
          state_opts[ "follow-start-feeds" ] = start_feeds;
       }
 
+      if( options.count( "follow-pull-feeds" ) )
+      {
+         pull_feeds = options[ "follow-pull-feeds" ].as< bool >();
+         state_opts[ "follow-pull-feeds" ] = pull_feeds;
+      }
+
+      if( pull_feeds )
+      {
+         if( options.count( "follow-feed-cache-size" ) )
+            my->_pulled_feeds.set_capacity( options[ "follow-feed-cache-size" ].as< uint32_t >() );
+
+         my->_post_apply_block_conn = my->_db.add_post_apply_block_handler( [&]( const block_notification& note )
+         {
+            my->_pulled_feeds.on_block( note.block.previous, note.block_id );
+         }, *this, 0 );
+      }
+
       appbase::app().get_plugin< chain::chain_plugin >().report_state_options( name(), state_opts );
    }
    FC_CAPTURE_AND_RETHROW()
@@ -417,10 +447,22 @@ void follow_plugin::plugin_initialize( const boost::program_options::variables_m
 
 void follow_plugin::plugin_startup() {}
 
+pulled_feed_ptr follow_plugin::get_pulled_feed( const account_name_type& account )const
+{
+   FC_ASSERT( pull_feeds, "Node is not computing feeds on demand" );
+   return my->_pulled_feeds.get_feed( account, max_feed_size );
+}
+
+pulled_feed_cache& follow_plugin::get_pulled_feed_cache()
+{
+   return my->_pulled_feeds;
+}
+
 void follow_plugin::plugin_shutdown()
 {
    chain::util::disconnect_signal( my->_pre_apply_operation_conn );
    chain::util::disconnect_signal( my->_post_apply_operation_conn );
+   chain::util::disconnect_signal( my->_post_apply_block_conn );
 }
 
 } } } // freezone::plugins::follow
@@ -1,11 +1,14 @@
 #pragma once
 #include <freezone/chain/freezone_fwd.hpp>
 #include <freezone/plugins/follow/follow_operations.hpp>
+#include <freezone/plugins/follow/pull_feed.hpp>
 
 #include <freezone/plugins/chain/chain_plugin.hpp>
 
 #include <freezone/chain/generic_custom_operation_interpreter.hpp>
 
+#include <fc/signals.hpp>
+
 
 #define freezone_FOLLOW_PLUGIN_NAME "follow"
 
@@ -37,6 +40,19 @@ class follow_plugin : public appbase::plugin< follow_plugin >
       uint32_t max_feed_size = 500;
       fc::time_point_sec start_feeds;
 
+      /// Compute feeds from the blogs of followed accounts when queried instead of storing them
+      bool pull_feeds = false;
+
+      /// Only valid when pull_feeds is set
+      pulled_feed_ptr get_pulled_feed( const account_name_type& account )const;
+
+      /// Cached pulled feeds, to be invalidated when blogs or follows change
+      pulled_feed_cache& get_pulled_feed_cache();
+
+      /// Emitted with the author of each applied vote, whose reputation it may have changed. Votes of
+      /// pending transactions are included, and their changes are undone without notice.
+      fc::signal< void( const account_name_type& ) > reputation_updated;
+
       std::shared_ptr< generic_custom_operation_interpreter< follow_plugin_operation > > _custom_operation_interpreter;
 
    private:
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <freezone/chain/database.hpp>
+#include <freezone/chain/freezone_object_types.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace freezone { namespace plugins { namespace follow {
+
+using freezone::chain::database;
+using freezone::chain::comment_id_type;
+using freezone::protocol::account_name_type;
+using freezone::protocol::block_id_type;
+
+struct pulled_feed_entry
+{
+   comment_id_type                  comment;
+   std::vector< account_name_type > reblogged_by; ///< oldest first
+   account_name_type                first_reblogged_by;
+   fc::time_point_sec               first_reblogged_on;
+   uint32_t                         entry_id = 0;
+};
+
+struct pulled_feed
+{
+   std::vector< pulled_feed_entry >       entries;    ///< newest first
+   std::map< comment_id_type, size_t >    positions;  ///< position of the entry of each comment in entries
+};
+
+typedef std::shared_ptr< const pulled_feed > pulled_feed_ptr;
+
+/**
+ * When the follow plugin runs with pull feeds, posts and reblogs are not copied into the feed of every
+ * follower. Instead the feed of an account is computed when it is queried by merging the blogs of the
+ * accounts it follows, newest first, and kept in a small per account cache.
+ *
+ * A cached feed is dropped when an entry is added to or removed from one of the blogs it was merged
+ * from, or when the accounts it follows change. Changes made by pending transactions are dropped again
+ * once the next block is applied, in case those transactions were discarded, and every feed is dropped
+ * when a block does not extend the previous one.
+ *
+ * Entry ids count up from the oldest entry of the computed feed so that they can be paginated like the
+ * stored feed, but they are only stable for as long as a feed is cached.
+ */
+class pulled_feed_cache
+{
+   public:
+      pulled_feed_cache( const database& db ) : _db( db ) {}
+
+      /// Maximum number of accounts with a cached feed. 0 disables caching.
+      void set_capacity( size_t accounts );
+
+      /// The feed of the account, newest first, holding at most max_size entries
+      pulled_feed_ptr get_feed( const account_name_type& account, uint32_t max_size );
+
+      /// An entry was added to or removed from the blog of the account
+      void invalidate_blog( const account_name_type& blog );
+
+      /// The account followed or unfollowed a blog
+      void invalidate_feed( const account_name_type& account );
+
+      /// Called once a block has been applied
+      void on_block( const block_id_type& previous, const block_id_type& id );
+
+      void clear();
+
+   private:
+      pulled_feed_ptr build_feed( const account_name_type& account, uint32_t max_size, std::vector< account_name_type >& blogs )const;
+
+      struct cached_feed
+      {
+         uint32_t                                        max_size = 0;
+         pulled_feed_ptr                                 feed;
+         std::vector< account_name_type >                blogs;
+         std::list< account_name_type >::iterator        lru_itr;
+      };
+
+      typedef std::map< account_name_type, cached_feed > feed_map;
+
+      void erase_feed( feed_map::iterator itr );
+      void erase_blog_dependents( const account_name_type& blog );
+      void clear_feeds();
+
+      const database&                                    _db;
+      size_t                                             _capacity = 0;
+      std::list< account_name_type >                     _lru;
+      feed_map                                           _feeds;
+      /// Accounts with a cached feed merged from the blog of each account
+      std::map< account_name_type, std::set< account_name_type > > _blog_dependents;
+      std::set< account_name_type >                      _changed_blogs;
+      std::set< account_name_type >                      _changed_feeds;
+      block_id_type                                      _head_block_id;
+      std::mutex                                         _mutex;
+};
+
+} } } // freezone::plugins::follow
@@ -0,0 +1,248 @@
+#include <freezone/plugins/follow/pull_feed.hpp>
+#include <freezone/plugins/follow/follow_objects.hpp>
+
+#include <freezone/chain/comment_object.hpp>
+
+#include <algorithm>
+
+namespace freezone { namespace plugins { namespace follow {
+
+void pulled_feed_cache::set_capacity( size_t accounts )
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   _capacity = accounts;
+   clear_feeds();
+}
+
+void pulled_feed_cache::clear()
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   clear_feeds();
+}
+
+void pulled_feed_cache::clear_feeds()
+{
+   _lru.clear();
+   _feeds.clear();
+   _blog_dependents.clear();
+}
+
+void pulled_feed_cache::erase_feed( feed_map::iterator itr )
+{
+   for( const auto& blog : itr->second.blogs )
+   {
+      auto dep_itr = _blog_dependents.find( blog );
+      if( dep_itr == _blog_dependents.end() )
+         continue;
+
+      dep_itr->second.erase( itr->first );
+      if( dep_itr->second.empty() )
+         _blog_dependents.erase( dep_itr );
+   }
+
+   _lru.erase( itr->second.lru_itr );
+   _feeds.erase( itr );
+}
+
+void pulled_feed_cache::erase_blog_dependents( const account_name_type& blog )
+{
+   auto dep_itr = _blog_dependents.find( blog );
+   if( dep_itr == _blog_dependents.end() )
+      return;
+
+   // erase_feed() updates the dependents of the blog, so they are copied first
+   auto dependents = dep_itr->second;
+   for( const auto& account : dependents )
+   {
+      auto itr = _feeds.find( account );
+      if( itr != _feeds.end() )
+         erase_feed( itr );
+   }
+}
+
+void pulled_feed_cache::invalidate_blog( const account_name_type& blog )
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   _changed_blogs.insert( blog );
+   erase_blog_dependents( blog );
+}
+
+void pulled_feed_cache::invalidate_feed( const account_name_type& account )
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   _changed_feeds.insert( account );
+
+   auto itr = _feeds.find( account );
+   if( itr != _feeds.end() )
+      erase_feed( itr );
+}
+
+void pulled_feed_cache::on_block( const block_id_type& previous, const block_id_type& id )
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+
+   if( previous != _head_block_id )
+   {
+      clear_feeds();
+   }
+   else
+   {
+      // Feeds built while pending transactions were applied may include changes that did not make it into the block
+      for( const auto& blog : _changed_blogs )
+         erase_blog_dependents( blog );
+
+      for( const auto& account : _changed_feeds )
+      {
+         auto itr = _feeds.find( account );
+         if( itr != _feeds.end() )
+            erase_feed( itr );
+      }
+   }
+
+   _changed_blogs.clear();
+   _changed_feeds.clear();
+   _head_block_id = id;
+}
+
+pulled_feed_ptr pulled_feed_cache::get_feed( const account_name_type& account, uint32_t max_size )
+{
+   block_id_type head_block_id = _db.head_block_id();
+
+   {
+      std::lock_guard< std::mutex > guard( _mutex );
+
+      // Blocks were popped and no new one has been applied yet, cached feeds may reference undone blog entries
+      if( head_block_id != _head_block_id )
+         clear_feeds();
+
+      auto itr = _feeds.find( account );
+
+      if( itr != _feeds.end() )
+      {
+         if( itr->second.max_size == max_size )
+         {
+            _lru.splice( _lru.begin(), _lru, itr->second.lru_itr );
+            return itr->second.feed;
+         }
+
+         erase_feed( itr );
+      }
+   }
+
+   // Feeds are built outside of the lock so that API threads building different feeds do not wait on each other.
+   // Callers hold the database read lock, so no block is applied and no cached feed is invalidated meanwhile.
+   std::vector< account_name_type > blogs;
+   auto feed = build_feed( account, max_size, blogs );
+
+   std::lock_guard< std::mutex > guard( _mutex );
+
+   // Before the first block applied after startup, or once blocks have been popped and until the next one is
+   // applied, the cache does not follow the head block and feeds are not kept
+   if( _capacity == 0 || head_block_id != _head_block_id || _feeds.find( account ) != _feeds.end() )
+      return feed;
+
+   _lru.push_front( account );
+   auto& cached = _feeds[ account ];
+   cached.max_size = max_size;
+   cached.feed = feed;
+   cached.blogs = std::move( blogs );
+   cached.lru_itr = _lru.begin();
+
+   for( const auto& blog : cached.blogs )
+      _blog_dependents[ blog ].insert( account );
+
+   while( _feeds.size() > _capacity )
+      erase_feed( _feeds.find( _lru.back() ) );
+
+   return feed;
+}
+
+pulled_feed_ptr pulled_feed_cache::build_feed( const account_name_type& account, uint32_t max_size, std::vector< account_name_type >& blogs )const
+{
+   const auto& follow_idx = _db.get_index< follow_index, by_follower_following >();
+   const auto& blog_idx = _db.get_index< blog_index, by_blog >();
+   typedef decltype( blog_idx.begin() ) blog_iterator;
+
+   struct blog_stream
+   {
+      fc::time_point_sec   time;
+      account_name_type    blog;
+      blog_iterator        itr;
+   };
+
+   // Posts are added to a blog when they are created, reblogs when they are reblogged
+   auto entry_time = [&]( const blog_object& b ) -> fc::time_point_sec
+   {
+      if( b.reblogged_on != fc::time_point_sec() )
+         return b.reblogged_on;
+
+      const auto* comment = _db.find< comment_object >( b.comment );
+      return comment != nullptr ? comment->created : fc::time_point_sec();
+   };
+
+   auto newer = []( const blog_stream& a, const blog_stream& b )
+   {
+      return std::tie( a.time, a.blog ) < std::tie( b.time, b.blog );
+   };
+
+   std::vector< blog_stream > streams;
+
+   for( auto itr = follow_idx.lower_bound( account ); itr != follow_idx.end() && itr->follower == account; ++itr )
+   {
+      if( !( itr->what & ( 1 << blog ) ) )
+         continue;
+
+      blogs.push_back( itr->following );
+      auto blog_itr = blog_idx.lower_bound( itr->following );
+      if( blog_itr != blog_idx.end() && blog_itr->account == itr->following )
+         streams.push_back( blog_stream{ entry_time( *blog_itr ), itr->following, blog_itr } );
+   }
+
+   std::make_heap( streams.begin(), streams.end(), newer );
+
+   auto feed = std::make_shared< pulled_feed >();
+   auto& entries = feed->entries;
+   auto& positions = feed->positions;
+
+   while( streams.size() && entries.size() < max_size )
+   {
+      std::pop_heap( streams.begin(), streams.end(), newer );
+      auto& stream = streams.back();
+      const auto& b = *stream.itr;
+
+      auto pos = positions.find( b.comment );
+      if( pos == positions.end() )
+      {
+         pos = positions.emplace( b.comment, entries.size() ).first;
+         entries.emplace_back();
+         entries.back().comment = b.comment;
+      }
+
+      // Streams are merged newest first, so each reblog seen is older than the ones before it
+      if( b.reblogged_on != fc::time_point_sec() )
+      {
+         auto& entry = entries[ pos->second ];
+         entry.reblogged_by.insert( entry.reblogged_by.begin(), b.account );
+         entry.first_reblogged_by = b.account;
+         entry.first_reblogged_on = b.reblogged_on;
+      }
+
+      ++stream.itr;
+      if( stream.itr != blog_idx.end() && stream.itr->account == stream.blog )
+      {
+         stream.time = entry_time( *stream.itr );
+         std::push_heap( streams.begin(), streams.end(), newer );
+      }
+      else
+      {
+         streams.pop_back();
+      }
+   }
+
+   for( size_t i = 0; i < entries.size(); ++i )
+      entries[ i ].entry_id = entries.size() - 1 - i;
+
+   return feed;
+}
+
+} } } // freezone::plugins::follow
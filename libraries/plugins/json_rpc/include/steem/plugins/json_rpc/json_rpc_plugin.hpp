@@ -102,6 +102,7 @@ class json_rpc_plugin : public appbase::plugin< json_rpc_plugin >
 
       void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig );
       string call( const string& body );
+      string call( const fc::variant& message );
 
    private:
       std::unique_ptr< detail::json_rpc_plugin_impl > my;
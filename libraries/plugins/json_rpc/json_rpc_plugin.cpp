@@ -4,14 +4,19 @@
 #include <freezone/plugins/statsd/utility.hpp>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/circular_buffer.hpp>
+#include <boost/scope_exit.hpp>
 
 #include <fc/log/logger_config.hpp>
 #include <fc/exception/exception.hpp>
 #include <fc/macros.hpp>
 #include <fc/io/fstream.hpp>
+#include <fc/variant_arena.hpp>
 
 #include <chainbase/chainbase.hpp>
 
+#include <mutex>
+
 #define ENABLE_JSON_RPC_LOG
 
 namespace freezone { namespace plugins { namespace json_rpc {
@@ -49,6 +54,182 @@ namespace detail
 
    typedef api_method_signature  get_signature_return;
 
+   /**
+    * Histogram with power of two buckets. Bucket i counts values in
+    * [2^(i-1), 2^i), so percentiles are accurate to a factor of two.
+    */
+   class log2_histogram
+   {
+      public:
+         static const uint32_t bucket_count = 48;
+
+         void add( uint64_t value )
+         {
+            uint32_t bucket = value ? 64 - __builtin_clzll( value ) : 0;
+            ++_buckets[ std::min( bucket, bucket_count - 1 ) ];
+            ++_count;
+            _max = std::max( _max, value );
+         }
+
+         /// Returns the upper bound of the bucket containing the given percentile, capped at the maximum seen value
+         uint64_t percentile( uint32_t pct )const
+         {
+            if( _count == 0 )
+               return 0;
+
+            uint64_t target = ( _count * pct + 99 ) / 100;
+            uint64_t seen = 0;
+
+            for( uint32_t i = 0; i < bucket_count; ++i )
+            {
+               seen += _buckets[ i ];
+               if( seen >= target )
+                  return std::min( i ? ( uint64_t( 1 ) << i ) - 1 : 0, _max );
+            }
+
+            return _max;
+         }
+
+         uint64_t max()const { return _max; }
+
+      private:
+         uint64_t _buckets[ bucket_count ] = {};
+         uint64_t _count = 0;
+         uint64_t _max = 0;
+   };
+
+   struct call_distribution
+   {
+      uint64_t p50 = 0;
+      uint64_t p99 = 0;
+      uint64_t max = 0;
+   };
+
+   struct method_call_stats
+   {
+      string            method;
+      uint64_t          count = 0;
+      uint64_t          errors = 0;
+      call_distribution execution_us;
+      call_distribution lock_wait_us;
+      call_distribution response_bytes;
+   };
+
+   struct slow_call
+   {
+      fc::time_point_sec   timestamp;
+      string               method;
+      bool                 error = false;
+      uint64_t             execution_us = 0;
+      uint64_t             lock_wait_us = 0;
+      uint64_t             response_bytes = 0;
+   };
+
+   typedef void_type                   get_call_stats_args;
+   typedef vector< method_call_stats > get_call_stats_return;
+
+   typedef void_type                   get_slow_calls_args;
+   typedef vector< slow_call >         get_slow_calls_return;
+
+   /**
+    * Timing of a single call, filled in while the call is dispatched and
+    * recorded once the response has been serialized.
+    */
+   struct call_info
+   {
+      string            method;
+      fc::microseconds  execution;
+      fc::microseconds  lock_wait;
+   };
+
+   class call_stats_recorder
+   {
+      public:
+         void configure( fc::microseconds slow_threshold, uint32_t slow_log_size )
+         {
+            _slow_threshold = slow_threshold;
+            _slow_calls.set_capacity( slow_log_size );
+         }
+
+         void record( const call_info& info, bool error, uint64_t response_size )
+         {
+            // Execution time excludes the time spent waiting for the database lock
+            uint64_t execution_us = std::max< int64_t >( ( info.execution - info.lock_wait ).count(), 0 );
+            uint64_t lock_wait_us = info.lock_wait.count();
+
+            std::lock_guard< std::mutex > guard( _mutex );
+            auto& stats = _stats[ info.method ];
+            ++stats.count;
+            if( error ) ++stats.errors;
+            stats.execution.add( execution_us );
+            stats.lock_wait.add( lock_wait_us );
+            stats.response_size.add( response_size );
+
+            if( _slow_calls.capacity() && info.execution >= _slow_threshold )
+            {
+               slow_call call;
+               call.timestamp = fc::time_point::now();
+               call.method = info.method;
+               call.error = error;
+               call.execution_us = execution_us;
+               call.lock_wait_us = lock_wait_us;
+               call.response_bytes = response_size;
+               _slow_calls.push_back( std::move( call ) );
+            }
+         }
+
+         get_call_stats_return get_stats()const
+         {
+            get_call_stats_return result;
+            std::lock_guard< std::mutex > guard( _mutex );
+            result.reserve( _stats.size() );
+
+            for( const auto& entry : _stats )
+            {
+               method_call_stats s;
+               s.method = entry.first;
+               s.count = entry.second.count;
+               s.errors = entry.second.errors;
+               s.execution_us = to_distribution( entry.second.execution );
+               s.lock_wait_us = to_distribution( entry.second.lock_wait );
+               s.response_bytes = to_distribution( entry.second.response_size );
+               result.push_back( std::move( s ) );
+            }
+
+            return result;
+         }
+
+         get_slow_calls_return get_slow_calls()const
+         {
+            std::lock_guard< std::mutex > guard( _mutex );
+            return get_slow_calls_return( _slow_calls.begin(), _slow_calls.end() );
+         }
+
+      private:
+         struct histograms
+         {
+            uint64_t       count = 0;
+            uint64_t       errors = 0;
+            log2_histogram execution;
+            log2_histogram lock_wait;
+            log2_histogram response_size;
+         };
+
+         static call_distribution to_distribution( const log2_histogram& h )
+         {
+            call_distribution d;
+            d.p50 = h.percentile( 50 );
+            d.p99 = h.percentile( 99 );
+            d.max = h.max();
+            return d;
+         }
+
+         mutable std::mutex                     _mutex;
+         map< string, histograms >              _stats;
+         boost::circular_buffer< slow_call >    _slow_calls;
+         fc::microseconds                       _slow_threshold;
+   };
+
    class json_rpc_logger
    {
    public:
@@ -138,10 +319,11 @@ namespace detail
          api_method* find_api_method( std::string api, std::string method );
          api_method* process_params( string method, const fc::variant_object& request, fc::variant& func_args, string* method_name );
          void rpc_id( const fc::variant_object& request, json_rpc_response& response );
-         void rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response );
-         json_rpc_response rpc( const fc::variant& message );
+         void rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response, call_info& info );
+         json_rpc_response rpc( const fc::variant& message, call_info& info );
+         string rpc_to_string( const fc::variant& message );
 
-         void initialize();
+         void initialize( bool enable_call_stats_api );
 
          void log(const fc::variant_object& request, json_rpc_response& response)
          {
@@ -153,10 +335,16 @@ namespace detail
             (get_methods)
             (get_signature) )
 
+         // Registered only when json-rpc-call-stats-api is set
+         get_call_stats_return get_call_stats( const get_call_stats_args& args, bool lock = false );
+         get_slow_calls_return get_slow_calls( const get_slow_calls_args& args, bool lock = false );
+
          map< string, api_description >                     _registered_apis;
          vector< string >                                   _methods;
          map< string, map< string, api_method_signature > > _method_sigs;
          std::unique_ptr< json_rpc_logger >                 _logger;
+         call_stats_recorder                                _call_stats;
+         bool                                               _call_stats_enabled = false;
    };
 
    json_rpc_plugin_impl::json_rpc_plugin_impl() {}
@@ -172,9 +360,19 @@ namespace detail
       _methods.push_back( canonical_name.str() );
    }
 
-   void json_rpc_plugin_impl::initialize()
+   void json_rpc_plugin_impl::initialize( bool enable_call_stats_api )
    {
       JSON_RPC_REGISTER_API( "jsonrpc" );
+
+      _call_stats_enabled = enable_call_stats_api;
+      if( _call_stats_enabled )
+      {
+         register_api_method_visitor vtor( "jsonrpc" );
+         vtor( *this, "get_call_stats", &json_rpc_plugin_impl::get_call_stats,
+            static_cast< get_call_stats_args* >( nullptr ), static_cast< get_call_stats_return* >( nullptr ) );
+         vtor( *this, "get_slow_calls", &json_rpc_plugin_impl::get_slow_calls,
+            static_cast< get_slow_calls_args* >( nullptr ), static_cast< get_slow_calls_return* >( nullptr ) );
+      }
    }
 
    get_methods_return json_rpc_plugin_impl::get_methods( const get_methods_args& args, bool lock )
@@ -199,6 +397,18 @@ namespace detail
       return method_itr->second;
    }
 
+   get_call_stats_return json_rpc_plugin_impl::get_call_stats( const get_call_stats_args& args, bool lock )
+   {
+      FC_UNUSED( lock )
+      return _call_stats.get_stats();
+   }
+
+   get_slow_calls_return json_rpc_plugin_impl::get_slow_calls( const get_slow_calls_args& args, bool lock )
+   {
+      FC_UNUSED( lock )
+      return _call_stats.get_slow_calls();
+   }
+
    api_method* json_rpc_plugin_impl::find_api_method( std::string api, std::string method )
    {
       STATSD_START_TIMER( "jsonrpc", "overhead", "find_api_method", 1.0f );
@@ -274,7 +484,7 @@ namespace detail
       }
    }
 
-   void json_rpc_plugin_impl::rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response )
+   void json_rpc_plugin_impl::rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response, call_info& info )
    {
       STATSD_START_TIMER( "jsonrpc", "overhead", "rpc_jsonrpc", 1.0f );
       if( request.contains( "jsonrpc" ) && request[ "jsonrpc" ].is_string() && request[ "jsonrpc" ].as_string() == "2.0" )
@@ -306,6 +516,15 @@ namespace detail
                      if( call )
                      {
                         STATSD_START_TIMER( "jsonrpc", "api", method_name, 1.0f );
+                        info.method = method_name;
+                        chainbase::database::thread_lock_wait_micros() = 0;
+                        auto start = fc::time_point::now();
+                        BOOST_SCOPE_EXIT( &info, &start )
+                        {
+                           info.execution = fc::time_point::now() - start;
+                           info.lock_wait = fc::microseconds( chainbase::database::thread_lock_wait_micros() );
+                        } BOOST_SCOPE_EXIT_END
+
                         response.result = (*call)( func_args );
                      }
                   }
@@ -341,7 +560,7 @@ namespace detail
    log(request, response);
    }
 
-   json_rpc_response json_rpc_plugin_impl::rpc( const fc::variant& message )
+   json_rpc_response json_rpc_plugin_impl::rpc( const fc::variant& message, call_info& info )
    {
       json_rpc_response response;
 
@@ -359,7 +578,7 @@ namespace detail
          try
          {
             if( !response.error.valid() )
-               rpc_jsonrpc( request, response );
+               rpc_jsonrpc( request, response, info );
          }
          catch( fc::exception& e )
          {
@@ -397,6 +616,19 @@ namespace detail
 
       return response;
    }
+
+   string json_rpc_plugin_impl::rpc_to_string( const fc::variant& message )
+   {
+      call_info info;
+      auto response = rpc( message, info );
+      auto result = fc::json::to_string( response );
+
+      if( info.method.size() )
+         if( _call_stats_enabled )
+            _call_stats.record( info, response.error.valid(), result.size() );
+
+      return result;
+   }
 }
 
 using detail::json_rpc_error;
@@ -410,12 +642,19 @@ void json_rpc_plugin::set_program_options( options_description& , options_descri
 {
    cfg.add_options()
       ("log-json-rpc", bpo::value< string >(), "json-rpc log directory name.")
+      ("json-rpc-call-stats-api", bpo::bool_switch()->default_value( false ), "Record per method call statistics and expose them through jsonrpc.get_call_stats and jsonrpc.get_slow_calls. Intended for node operators, do not enable on public endpoints.")
+      ("json-rpc-slow-call-threshold", bpo::value< uint32_t >()->default_value( 1000 ), "Calls taking at least this many milliseconds are kept in the slow call log.")
+      ("json-rpc-slow-call-log-size", bpo::value< uint32_t >()->default_value( 100 ), "Number of most recent slow calls retrievable through jsonrpc.get_slow_calls. 0 disables the slow call log.")
       ;
 }
 
 void json_rpc_plugin::plugin_initialize( const variables_map& options )
 {
-   my->initialize();
+   my->initialize( options.at( "json-rpc-call-stats-api" ).as< bool >() );
+
+   my->_call_stats.configure(
+      fc::milliseconds( options.at( "json-rpc-slow-call-threshold" ).as< uint32_t >() ),
+      options.at( "json-rpc-slow-call-log-size" ).as< uint32_t >() );
 
    if( options.count( "log-json-rpc" ) )
    {
@@ -445,23 +684,50 @@ void json_rpc_plugin::add_api_method( const string& api_name, const string& meth
 string json_rpc_plugin::call( const string& message )
 {
    STATSD_START_TIMER( "jsonrpc", "overhead", "call", 1.0f );
+   // The request, the results and the response are all discarded once the response is serialized
+   fc::variant_arena arena;
    try
    {
-      fc::variant v = fc::json::from_string( message );
+      return call( fc::json::from_string( message ) );
+   }
+   catch( fc::exception& e )
+   {
+      json_rpc_response response;
+      response.error = json_rpc_error( JSON_RPC_SERVER_ERROR, e.to_string(), fc::variant( *(e.dynamic_copy_exception()) ) );
+      return fc::json::to_string( response );
+   }
+   catch( ... )
+   {
+      json_rpc_response response;
+      response.error = json_rpc_error( JSON_RPC_SERVER_ERROR, "Unknown exception", fc::variant(
+         fc::unhandled_exception( FC_LOG_MESSAGE( warn, "Unknown Exception" ), std::current_exception() ).to_detail_string() ) );
+      return fc::json::to_string( response );
+   }
+}
 
+string json_rpc_plugin::call( const fc::variant& v )
+{
+   fc::variant_arena arena;
+   try
+   {
       if( v.is_array() )
       {
-         vector< fc::variant > messages = v.as< vector< fc::variant > >();
-         vector< json_rpc_response > responses;
+         const auto& messages = v.get_array();
 
          if( messages.size() )
          {
-            responses.reserve( messages.size() );
+            // Responses are serialized one by one so their sizes can be recorded per call
+            string result = "[";
 
-            for( auto& m : messages )
-               responses.push_back( my->rpc( m ) );
+            for( auto itr = messages.begin(); itr != messages.end(); ++itr )
+            {
+               if( itr != messages.begin() )
+                  result += ',';
+               result += my->rpc_to_string( *itr );
+            }
 
-            return fc::json::to_string( responses );
+            result += ']';
+            return result;
          }
          else
          {
@@ -473,7 +739,7 @@ string json_rpc_plugin::call( const string& message )
       }
       else
       {
-         return fc::json::to_string( my->rpc( v ) );
+         return my->rpc_to_string( v );
       }
    }
    catch( fc::exception& e )
@@ -489,7 +755,6 @@ string json_rpc_plugin::call( const string& message )
          fc::unhandled_exception( FC_LOG_MESSAGE( warn, "Unknown Exception" ), std::current_exception() ).to_detail_string() ) );
       return fc::json::to_string( response );
    }
-
 }
 
 } } } // freezone::plugins::json_rpc
@@ -498,3 +763,7 @@ FC_REFLECT( freezone::plugins::json_rpc::detail::json_rpc_error, (code)(message)
 FC_REFLECT( freezone::plugins::json_rpc::detail::json_rpc_response, (jsonrpc)(result)(error)(id) )
 
 FC_REFLECT( freezone::plugins::json_rpc::detail::get_signature_args, (method) )
+
+FC_REFLECT( freezone::plugins::json_rpc::detail::call_distribution, (p50)(p99)(max) )
+FC_REFLECT( freezone::plugins::json_rpc::detail::method_call_stats, (method)(count)(errors)(execution_us)(lock_wait_us)(response_bytes) )
+FC_REFLECT( freezone::plugins::json_rpc::detail::slow_call, (timestamp)(method)(error)(execution_us)(lock_wait_us)(response_bytes) )
@@ -33,7 +33,7 @@ class market_history_plugin_impl
       chain::database&     _db;
       vector<uint32_t>              _tracked_buckets = vector<uint32_t>  { 15, 60, 300, 3600, 21600 };
       int32_t                       _maximum_history_track_time = 604800;
-      boost::signals2::connection   _post_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
 };
 
 void market_history_plugin_impl::on_post_apply_operation( const operation_notification& o )
@@ -170,7 +170,7 @@ void market_history_plugin::plugin_initialize( const boost::program_options::var
       ilog( "market_history: plugin_initialize() begin" );
       my = std::make_unique< detail::market_history_plugin_impl >();
 
-      my->_post_apply_operation_conn = my->_db.add_post_apply_operation_handler( [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
+      my->_post_apply_operation_conn = my->_db.subscribe_post_apply_operation< fill_order_operation >( [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
       freezone_ADD_PLUGIN_INDEX(my->_db, bucket_index);
       freezone_ADD_PLUGIN_INDEX(my->_db, order_history_index);
 
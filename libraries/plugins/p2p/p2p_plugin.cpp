@@ -91,7 +91,9 @@ public:
    // node_delegate interface
    virtual bool has_item( const graphene::net::item_id& ) override;
    virtual bool handle_block( const graphene::net::block_message&, bool, std::vector<fc::uint160_t>& ) override;
+   virtual void prevalidate_block( graphene::net::block_message& ) override;
    virtual void handle_transaction( const graphene::net::trx_message& ) override;
+   virtual std::vector< fc::oexception > handle_transactions( const std::vector< graphene::net::trx_message >& ) override;
    virtual void handle_message( const graphene::net::message& ) override;
    virtual std::vector< graphene::net::item_hash_t > get_block_ids( const std::vector< graphene::net::item_hash_t >&, uint32_t&, uint32_t ) override;
    virtual graphene::net::message get_item( const graphene::net::item_id& ) override;
@@ -105,6 +107,11 @@ public:
    virtual uint32_t estimate_last_known_fork_from_git_revision_timestamp( uint32_t ) const override;
    virtual void error_encountered( const std::string& message, const fc::oexception& error ) override;
 
+   uint32_t get_block_skip_flags() const
+   {
+      return ( block_producer | force_validate ) ? chain::database::skip_nothing : chain::database::skip_transaction_signatures;
+   }
+
    fc::optional<fc::ip::endpoint> endpoint;
    vector<fc::ip::endpoint> seeds;
    string user_agent;
@@ -170,6 +177,16 @@ bool p2p_plugin_impl::has_item( const graphene::net::item_id& id )
    });
 }
 
+void p2p_plugin_impl::prevalidate_block( graphene::net::block_message& blk_msg )
+{
+   if( running.load() )
+   {
+      auto prevalidation = chain.prevalidate_block( blk_msg.block, get_block_skip_flags() );
+      if( prevalidation.valid() )
+         blk_msg.prevalidation = std::make_shared< plugins::chain::chain_plugin::prevalidation_future >( std::move( prevalidation ) );
+   }
+}
+
 bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg, bool sync_mode, std::vector<fc::uint160_t>& )
 { try {
    if( running.load() )
@@ -199,7 +216,11 @@ bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg,
          // you can help the network code out by throwing a block_older_than_undo_history exception.
          // when the net code sees that, it will stop trying to push blocks from that chain, but
          // leave that peer connected so that they can get sync blocks from us
-         bool result = chain.accept_block( blk_msg.block, sync_mode, ( block_producer | force_validate ) ? chain::database::skip_nothing : chain::database::skip_transaction_signatures );
+         plugins::chain::chain_plugin::prevalidation_future prevalidation;
+         if( blk_msg.prevalidation )
+            prevalidation = *std::static_pointer_cast< plugins::chain::chain_plugin::prevalidation_future >( blk_msg.prevalidation );
+
+         bool result = chain.accept_block( blk_msg.block, sync_mode, get_block_skip_flags(), prevalidation );
 
          if( !sync_mode )
          {
@@ -267,6 +288,33 @@ void p2p_plugin_impl::handle_transaction( const graphene::net::trx_message& trx_
    }
 }
 
+std::vector< fc::oexception > p2p_plugin_impl::handle_transactions( const std::vector< graphene::net::trx_message >& trx_msgs )
+{
+   if(running.load())
+   {
+      try
+      {
+         shutdown_helper helper(*this, activeHandleTx, handleTxFinished);
+
+         std::vector< chain::signed_transaction > trxs;
+         trxs.reserve( trx_msgs.size() );
+         for( const auto& trx_msg : trx_msgs )
+            trxs.push_back( trx_msg.trx );
+
+         return chain.accept_transactions( trxs );
+
+      } FC_CAPTURE_AND_RETHROW( (trx_msgs.size()) )
+   }
+   else
+   {
+      ilog("Transactions ignored due to started p2p_plugin shutdown");
+      if(handleTxFinished.second.valid() == false)
+         handleTxFinished.first.set_value();
+
+      FC_THROW("Preventing further processing of ignored transactions...");
+   }
+}
+
 void p2p_plugin_impl::handle_message( const graphene::net::message& message_to_process )
 {
    // not a transaction, not a block
@@ -37,8 +37,8 @@ class reputation_plugin_impl
 
       chain::database&              _db;
       reputation_plugin&            _self;
-      boost::signals2::connection   _pre_apply_operation_conn;
-      boost::signals2::connection   _post_apply_operation_conn;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
 };
 
 struct pre_operation_visitor
@@ -225,8 +225,8 @@ void reputation_plugin::plugin_initialize( const boost::program_options::variabl
 
       my = std::make_unique< detail::reputation_plugin_impl >( *this );
 
-      my->_pre_apply_operation_conn = my->_db.add_pre_apply_operation_handler( [&]( const operation_notification& note ){ my->pre_operation( note ); }, *this, 0 );
-      my->_post_apply_operation_conn = my->_db.add_post_apply_operation_handler( [&]( const operation_notification& note ){ my->post_operation( note ); }, *this, 0 );
+      my->_pre_apply_operation_conn = my->_db.subscribe_pre_apply_operation< vote_operation, vote2_operation >( [&]( const operation_notification& note ){ my->pre_operation( note ); }, *this, 0 );
+      my->_post_apply_operation_conn = my->_db.subscribe_post_apply_operation< vote_operation, vote2_operation >( [&]( const operation_notification& note ){ my->post_operation( note ); }, *this, 0 );
       freezone_ADD_PLUGIN_INDEX(my->_db, reputation_index);
    }
    FC_CAPTURE_AND_RETHROW()
@@ -42,7 +42,8 @@ enum
    tag_object_type              = ( freezone_TAG_SPACE_ID << 8 ),
    tag_stats_object_type        = ( freezone_TAG_SPACE_ID << 8 ) + 1,
    peer_stats_object_type       = ( freezone_TAG_SPACE_ID << 8 ) + 2,
-   author_tag_stats_object_type = ( freezone_TAG_SPACE_ID << 8 ) + 3
+   author_tag_stats_object_type = ( freezone_TAG_SPACE_ID << 8 ) + 3,
+   tag_rank_object_type         = ( freezone_TAG_SPACE_ID << 8 ) + 4
 };
 
 namespace detail { class tags_plugin_impl; }
@@ -79,8 +80,6 @@ class tag_object : public object< tag_object_type, tag_object >
       int64_t           net_rshares = 0;
       int32_t           net_votes   = 0;
       int32_t           children    = 0;
-      double            hot         = 0;
-      double            trending    = 0;
       share_type        promoted_balance = 0;
 
       account_id_type   author;
@@ -98,9 +97,7 @@ struct by_parent_created;
 struct by_parent_active;
 struct by_parent_promoted;
 struct by_parent_net_votes; /// all top level posts by direct votes
-struct by_parent_trending;
 struct by_parent_children; /// all top level posts with the most discussion (replies at all levels)
-struct by_parent_hot;
 struct by_author_comment;
 struct by_reward_fund_net_rshares;
 struct by_comment;
@@ -171,24 +168,6 @@ typedef multi_index_container<
             >,
             composite_key_compare< std::less<tag_name_type>, std::less<comment_id_type>, std::greater< int32_t >, std::less< tag_id_type > >
       >,
-      ordered_unique< tag< by_parent_hot >,
-            composite_key< tag_object,
-               member< tag_object, tag_name_type, &tag_object::tag >,
-               member< tag_object, comment_id_type, &tag_object::parent >,
-               member< tag_object, double, &tag_object::hot >,
-               member< tag_object, tag_id_type, &tag_object::id >
-            >,
-            composite_key_compare< std::less<tag_name_type>, std::less<comment_id_type>, std::greater< double >, std::less< tag_id_type > >
-      >,
-      ordered_unique< tag< by_parent_trending >,
-            composite_key< tag_object,
-               member< tag_object, tag_name_type, &tag_object::tag >,
-               member< tag_object, comment_id_type, &tag_object::parent >,
-               member< tag_object, double, &tag_object::trending >,
-               member< tag_object, tag_id_type, &tag_object::id >
-            >,
-            composite_key_compare< std::less<tag_name_type>, std::less<comment_id_type>, std::greater< double >, std::less< tag_id_type > >
-      >,
       ordered_unique< tag< by_cashout >,
             composite_key< tag_object,
                member< tag_object, tag_name_type, &tag_object::tag >,
@@ -210,6 +189,70 @@ typedef multi_index_container<
    allocator< tag_object >
 > tag_index;
 
+/**
+ *  Hot and trending rank the discussions in a tag by their score and their age. Both are kept in a
+ *  separate index that only holds discussions with a positive score, which are the only ones hot and
+ *  trending pages list.
+ *
+ *  A rank is expressed in seconds: the creation time of the discussion plus the time its score is
+ *  worth, see calculate_rank(). The score is bucketed, so most votes do not change the rank and do
+ *  not touch this index. Because the key is fixed at creation time plus a score term, ranks never
+ *  have to be rewritten as discussions age.
+ */
+class tag_rank_object : public object< tag_rank_object_type, tag_rank_object >
+{
+   public:
+      template< typename Constructor, typename Allocator >
+      tag_rank_object( Constructor&& c, allocator< Allocator > a )
+      {
+         c( *this );
+      }
+
+      tag_rank_object() {}
+
+      id_type           id;
+
+      tag_name_type     tag;
+      comment_id_type   parent;
+      comment_id_type   comment;
+      tag_id_type       tag_id;
+      int64_t           hot      = 0;
+      int64_t           trending = 0;
+};
+
+typedef oid< tag_rank_object > tag_rank_id_type;
+
+struct by_tag_id;
+struct by_parent_hot;
+struct by_parent_trending;
+
+typedef multi_index_container<
+   tag_rank_object,
+   indexed_by<
+      ordered_unique< tag< by_id >, member< tag_rank_object, tag_rank_id_type, &tag_rank_object::id > >,
+      ordered_unique< tag< by_tag_id >, member< tag_rank_object, tag_id_type, &tag_rank_object::tag_id > >,
+      ordered_unique< tag< by_parent_hot >,
+            composite_key< tag_rank_object,
+               member< tag_rank_object, tag_name_type, &tag_rank_object::tag >,
+               member< tag_rank_object, comment_id_type, &tag_rank_object::parent >,
+               member< tag_rank_object, int64_t, &tag_rank_object::hot >,
+               member< tag_rank_object, tag_rank_id_type, &tag_rank_object::id >
+            >,
+            composite_key_compare< std::less<tag_name_type>, std::less<comment_id_type>, std::greater< int64_t >, std::less< tag_rank_id_type > >
+      >,
+      ordered_unique< tag< by_parent_trending >,
+            composite_key< tag_rank_object,
+               member< tag_rank_object, tag_name_type, &tag_rank_object::tag >,
+               member< tag_rank_object, comment_id_type, &tag_rank_object::parent >,
+               member< tag_rank_object, int64_t, &tag_rank_object::trending >,
+               member< tag_rank_object, tag_rank_id_type, &tag_rank_object::id >
+            >,
+            composite_key_compare< std::less<tag_name_type>, std::less<comment_id_type>, std::greater< int64_t >, std::less< tag_rank_id_type > >
+      >
+   >,
+   allocator< tag_rank_object >
+> tag_rank_index;
+
 /**
  *  The purpose of this index is to quickly identify how popular various tags by maintaining variou sums over
  *  all posts under a particular tag
@@ -385,9 +428,13 @@ class tag_api : public std::enable_shared_from_this<tag_api> {
 } } } //freezone::plugins::tags
 
 FC_REFLECT( freezone::plugins::tags::tag_object,
-   (id)(tag)(created)(active)(cashout)(net_rshares)(net_votes)(hot)(trending)(promoted_balance)(children)(author)(parent)(comment) )
+   (id)(tag)(created)(active)(cashout)(net_rshares)(net_votes)(promoted_balance)(children)(author)(parent)(comment) )
 CHAINBASE_SET_INDEX_TYPE( freezone::plugins::tags::tag_object, freezone::plugins::tags::tag_index )
 
+FC_REFLECT( freezone::plugins::tags::tag_rank_object,
+   (id)(tag)(parent)(comment)(tag_id)(hot)(trending) )
+CHAINBASE_SET_INDEX_TYPE( freezone::plugins::tags::tag_rank_object, freezone::plugins::tags::tag_rank_index )
+
 FC_REFLECT( freezone::plugins::tags::tag_stats_object,
    (id)(tag)(total_payout)(net_votes)(top_posts)(comments)(total_trending) );
 CHAINBASE_SET_INDEX_TYPE( freezone::plugins::tags::tag_stats_object, freezone::plugins::tags::tag_stats_index )
@@ -38,14 +38,39 @@ double calculate_score( const share_type& score, const time_point_sec& created )
    return sign * order + double( created.sec_since_epoch() ) / double( T );
 }
 
-inline double calculate_hot( const share_type& score, const time_point_sec& created )
+inline double calculate_trending( const share_type& score, const time_point_sec& created )
 {
-   return calculate_score< 10000000, 10000 >( score, created );
+   return calculate_score< 10000000, 480000 >( score, created );
 }
 
-inline double calculate_trending( const share_type& score, const time_point_sec& created )
+/**
+ * calculate_score() multiplied by T, so that the rank is the creation time in seconds plus the time the
+ * score is worth. The order of magnitude of the score is bucketed, each bucket being 1/32 of an order,
+ * so a rank only changes when a vote moves the score to another bucket.
+ */
+template< int64_t S, int64_t T >
+int64_t calculate_rank( const share_type& score, const time_point_sec& created )
 {
-   return calculate_score< 10000000, 480000 >( score, created );
+   const int64_t buckets_per_order = 32;
+   auto mod_score = score.value / S;
+
+   int64_t bucket = 0;
+   if( mod_score != 0 )
+      bucket = int64_t( std::floor( log10( double( std::abs( mod_score ) ) ) * buckets_per_order ) );
+   if( mod_score < 0 )
+      bucket = -bucket;
+
+   return int64_t( created.sec_since_epoch() ) + bucket * T / buckets_per_order;
+}
+
+inline int64_t calculate_hot_rank( const share_type& score, const time_point_sec& created )
+{
+   return calculate_rank< 10000000, 10000 >( score, created );
+}
+
+inline int64_t calculate_trending_rank( const share_type& score, const time_point_sec& created )
+{
+   return calculate_rank< 10000000, 480000 >( score, created );
 }
 
 namespace detail {
@@ -64,17 +89,19 @@ class tags_plugin_impl
       chain::database&     _db;
       fc::time_point_sec   _promoted_start_time;
       bool                 _started = false;
-      boost::signals2::connection   _pre_apply_operation_conn;
-      boost::signals2::connection   _post_apply_operation_conn;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
       boost::signals2::connection   on_sync_connection;
 
       void remove_stats( const tag_object& tag, const tag_stats_object& stats )const;
       void add_stats( const tag_object& tag, const tag_stats_object& stats )const;
       void remove_tag( const tag_object& tag )const;
+      void update_rank( const tag_object& tag, int64_t hot, int64_t trending )const;
+      void remove_rank( const tag_object& tag )const;
       const tag_stats_object& get_stats( const string& tag )const;
       comment_metadata filter_tags( const comment_object& c, const comment_content_object& con )const;
-      void update_tag( const tag_object& current, const comment_object& comment, double hot, double trending )const;
-      void create_tag( const string& tag, const comment_object& comment, double hot, double trending )const;
+      void update_tag( const tag_object& current, const comment_object& comment, int64_t hot, int64_t trending )const;
+      void create_tag( const string& tag, const comment_object& comment, int64_t hot, int64_t trending )const;
       void update_tags( const comment_object& c, bool parse_tags = false )const;
 };
 
@@ -95,7 +122,7 @@ void tags_plugin_impl::remove_stats( const tag_object& tag, const tag_stats_obje
         {
            s.comments--;
         }
-        s.total_trending -= static_cast<uint32_t>(tag.trending);
+        s.total_trending -= static_cast<uint32_t>( calculate_trending( tag.net_rshares, tag.created ) );
         s.net_votes   -= tag.net_votes;
    });
 }
@@ -112,7 +139,7 @@ void tags_plugin_impl::add_stats( const tag_object& tag, const tag_stats_object&
         {
            s.comments++;
         }
-        s.total_trending += static_cast<uint32_t>(tag.trending);
+        s.total_trending += static_cast<uint32_t>( calculate_trending( tag.net_rshares, tag.created ) );
         s.net_votes   += tag.net_votes;
    });
 }
@@ -130,9 +157,52 @@ void tags_plugin_impl::remove_tag( const tag_object& tag )const
    }
 
    /// TODO: update tag stats object
+   remove_rank( tag );
    _db.remove(tag);
 }
 
+void tags_plugin_impl::update_rank( const tag_object& tag, int64_t hot, int64_t trending )const
+{
+   const auto& rank_idx = _db.get_index< tag_rank_index, by_tag_id >();
+   auto rank = rank_idx.find( tag.id );
+
+   // Hot and trending only list discussions with a positive score
+   if( tag.net_rshares <= 0 )
+   {
+      if( rank != rank_idx.end() )
+         _db.remove( *rank );
+      return;
+   }
+
+   if( rank == rank_idx.end() )
+   {
+      _db.create< tag_rank_object >( [&]( tag_rank_object& r )
+      {
+         r.tag      = tag.tag;
+         r.parent   = tag.parent;
+         r.comment  = tag.comment;
+         r.tag_id   = tag.id;
+         r.hot      = hot;
+         r.trending = trending;
+      });
+   }
+   else if( rank->hot != hot || rank->trending != trending )
+   {
+      _db.modify( *rank, [&]( tag_rank_object& r )
+      {
+         r.hot      = hot;
+         r.trending = trending;
+      });
+   }
+}
+
+void tags_plugin_impl::remove_rank( const tag_object& tag )const
+{
+   const auto* rank = _db.find< tag_rank_object, by_tag_id >( tag.id );
+   if( rank != nullptr )
+      _db.remove( *rank );
+}
+
 const tag_stats_object& tags_plugin_impl::get_stats( const string& tag )const
 {
    const auto& stats_idx = _db.get_index<tag_stats_index>().indices().get<by_tag>();
@@ -190,7 +260,7 @@ comment_metadata tags_plugin_impl::filter_tags( const comment_object& c, const c
    return meta;
 }
 
-void tags_plugin_impl::update_tag( const tag_object& current, const comment_object& comment, double hot, double trending )const
+void tags_plugin_impl::update_tag( const tag_object& current, const comment_object& comment, int64_t hot, int64_t trending )const
 {
     const auto& stats = get_stats( current.tag );
     remove_stats( current, stats );
@@ -202,18 +272,18 @@ void tags_plugin_impl::update_tag( const tag_object& current, const comment_obje
           obj.children          = comment.children;
           obj.net_rshares       = comment.net_rshares.value;
           obj.net_votes         = comment.net_votes;
-          obj.hot               = hot;
-          obj.trending          = trending;
           if( obj.cashout == fc::time_point_sec() )
             obj.promoted_balance = 0;
       });
       add_stats( current, stats );
+      update_rank( current, hot, trending );
     } else {
+       remove_rank( current );
        _db.remove( current );
     }
 }
 
-void tags_plugin_impl::create_tag( const string& tag, const comment_object& comment, double hot, double trending )const
+void tags_plugin_impl::create_tag( const string& tag, const comment_object& comment, int64_t hot, int64_t trending )const
 {
    comment_id_type parent;
    account_id_type author = _db.get_account( comment.author ).id;
@@ -233,10 +303,9 @@ void tags_plugin_impl::create_tag( const string& tag, const comment_object& comm
        obj.children          = comment.children;
        obj.net_rshares       = comment.net_rshares.value;
        obj.author            = author;
-       obj.hot               = hot;
-       obj.trending          = trending;
    });
    add_stats( tag_obj, get_stats( tag ) );
+   update_rank( tag_obj, hot, trending );
 
 
    const auto& idx = _db.get_index<author_tag_stats_index>().indices().get<by_author_tag_posts>();
@@ -264,8 +333,8 @@ void tags_plugin_impl::update_tags( const comment_object& c, bool parse_tags )co
 {
    try {
 
-   auto hot = calculate_hot( c.net_rshares, c.created );
-   auto trending = calculate_trending( c.net_rshares, c.created );
+   auto hot = calculate_hot_rank( c.net_rshares, c.created );
+   auto trending = calculate_trending_rank( c.net_rshares, c.created );
 
    const auto& comment_idx = _db.get_index< tag_index >().indices().get< by_comment >();
 
@@ -338,7 +407,7 @@ struct pre_apply_operation_visitor
 
    void operator()( const delete_comment_operation& op )const
    {
-      const auto& comment = _db.find< comment_object, chain::by_permlink >( boost::make_tuple( op.author, op.permlink ) );
+      const auto* comment = _db.find_comment( op.author, op.permlink.c_str(), op.permlink.size() );
 
       if( comment == nullptr )
          return;
@@ -357,6 +426,10 @@ struct pre_apply_operation_visitor
 
       for( const auto* tag_ptr : to_remove )
       {
+         const auto* rank = _db.find< tag_rank_object, by_tag_id >( tag_ptr->id );
+         if( rank != nullptr )
+            _db.remove( *rank );
+
          _db.remove( *tag_ptr );
       }
    }
@@ -511,8 +584,10 @@ void tags_plugin::plugin_initialize(const boost::program_options::variables_map&
    ilog("Intializing tags plugin" );
    my = std::make_unique< detail::tags_plugin_impl >();
 
-   my->_pre_apply_operation_conn = my->_db.add_pre_apply_operation_handler( [&]( const operation_notification& note ){ my->on_pre_apply_operation( note ); }, *this, 0 );
-   my->_post_apply_operation_conn = my->_db.add_post_apply_operation_handler( [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
+   my->_pre_apply_operation_conn = my->_db.subscribe_pre_apply_operation< delete_comment_operation >( [&]( const operation_notification& note ){ my->on_pre_apply_operation( note ); }, *this, 0 );
+   my->_post_apply_operation_conn = my->_db.subscribe_post_apply_operation< comment_operation, transfer_operation, vote_operation,
+      comment_reward_operation, comment_payout_update_operation >(
+      [&]( const operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0 );
 
    if( !options.at( "tags-skip-startup-update" ).as< bool >() )
    {
@@ -532,6 +607,7 @@ void tags_plugin::plugin_initialize(const boost::program_options::variables_map&
    }
 
    freezone_ADD_PLUGIN_INDEX(my->_db, tag_index);
+   freezone_ADD_PLUGIN_INDEX(my->_db, tag_rank_index);
    freezone_ADD_PLUGIN_INDEX(my->_db, tag_stats_index);
    freezone_ADD_PLUGIN_INDEX(my->_db, author_tag_stats_index);
 
@@ -2,6 +2,7 @@
 #include <freezone/plugins/webserver/local_endpoint.hpp>
 
 #include <freezone/plugins/chain/chain_plugin.hpp>
+#include <freezone/plugins/statsd/utility.hpp>
 
 #include <fc/network/ip.hpp>
 #include <fc/log/logger_config.hpp>
@@ -12,6 +13,8 @@
 #include <boost/optional.hpp>
 #include <boost/bind.hpp>
 #include <boost/preprocessor/stringize.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/config/asio.hpp>
@@ -21,9 +24,13 @@
 #include <websocketpp/logger/stub.hpp>
 #include <websocketpp/logger/syslog.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <thread>
 #include <memory>
 #include <iostream>
+#include <mutex>
+#include <deque>
 
 namespace freezone { namespace plugins { namespace webserver {
 
@@ -31,6 +38,7 @@ namespace asio = boost::asio;
 
 using std::map;
 using std::string;
+using std::vector;
 using boost::optional;
 using boost::asio::ip::tcp;
 using std::shared_ptr;
@@ -112,11 +120,265 @@ namespace detail {
 using websocket_server_type = websocketpp::server< detail::asio_with_stub_log >;
 using websocket_local_server_type = websocketpp::server<detail::asio_local_with_stub_log>;
 
+/**
+ * Requests are grouped in classes which are serviced in priority order.
+ * Write requests (transaction and block broadcasts) are always picked
+ * first, then cheap reads, and expensive reads last.
+ */
+enum request_class
+{
+   write_request,
+   cheap_request,
+   expensive_request,
+   request_class_count
+};
+
+static const char* request_class_names[ request_class_count ] = { "write", "cheap", "expensive" };
+
+const std::vector< string > default_write_methods =
+{
+   "network_broadcast_api.*",
+   "condenser_api.broadcast_*"
+};
+
+const std::vector< string > default_expensive_methods =
+{
+   "account_history_api.get_account_history",
+   "account_history_api.enum_virtual_ops",
+   "condenser_api.get_account_history",
+   "condenser_api.get_discussions_by_*",
+   "condenser_api.get_blog*",
+   "condenser_api.get_feed*",
+   "condenser_api.get_replies_by_last_update",
+   "condenser_api.get_content_replies",
+   "tags_api.get_discussions_by_*",
+   "tags_api.get_content_replies",
+   "tags_api.get_replies_by_last_update",
+   "follow_api.get_blog*",
+   "follow_api.get_feed*"
+};
+
+/**
+ * Matches a canonical "api.method" name against a pattern. A pattern is either
+ * an exact method name or a prefix followed by a trailing '*'.
+ */
+inline bool method_matches( const string& method, const string& pattern )
+{
+   if( pattern.size() && pattern.back() == '*' )
+      return method.compare( 0, pattern.size() - 1, pattern, 0, pattern.size() - 1 ) == 0;
+
+   return method == pattern;
+}
+
+/**
+ * Returns the canonical "api.method" name of a single JSON RPC request,
+ * or an empty string if the request is malformed. Malformed requests are
+ * left for json_rpc_plugin to report.
+ */
+inline string get_method_name( const fc::variant& request )
+{
+   if( !request.is_object() )
+      return string();
+
+   const auto& obj = request.get_object();
+   auto method_itr = obj.find( "method" );
+   if( method_itr == obj.end() || !method_itr->value().is_string() )
+      return string();
+
+   const auto& method = method_itr->value().get_string();
+   if( method != "call" )
+      return method;
+
+   auto params_itr = obj.find( "params" );
+   if( params_itr == obj.end() || !params_itr->value().is_array() )
+      return string();
+
+   const auto& params = params_itr->value().get_array();
+   if( params.size() < 2 || !params[0].is_string() || !params[1].is_string() )
+      return string();
+
+   return params[0].get_string() + "." + params[1].get_string();
+}
+
+/**
+ * Schedules API calls on the webserver thread pool.
+ *
+ * Every scheduled task posts exactly one dispatch token to the thread pool.
+ * A dispatch token runs the highest priority pending task whose method and
+ * class are below their concurrency limits. When no task is eligible the
+ * token is parked and reposted when a running task completes, so the number
+ * of outstanding tokens always matches the number of pending tasks.
+ */
+class request_scheduler
+{
+   public:
+      typedef std::function< void() > task_type;
+
+      request_scheduler( asio::io_service& ios ) : _ios( ios ) {}
+
+      void set_write_methods( const std::vector< string >& patterns )     { _patterns[ write_request ] = patterns; }
+      void set_expensive_methods( const std::vector< string >& patterns ) { _patterns[ expensive_request ] = patterns; }
+      void set_class_limit( request_class c, uint32_t limit )            { _class_limits[ c ] = limit; }
+      void set_method_limit( const string& method, uint32_t limit )      { _method_limits[ method ] = limit; }
+
+      request_class classify( const string& method )const
+      {
+         for( const auto& pattern : _patterns[ write_request ] )
+            if( method_matches( method, pattern ) )
+               return write_request;
+
+         for( const auto& pattern : _patterns[ expensive_request ] )
+            if( method_matches( method, pattern ) )
+               return expensive_request;
+
+         return cheap_request;
+      }
+
+      /**
+       * Batches are scheduled as a unit. They never get write priority unless
+       * every call in them is a write, and they are expensive if any call is.
+       */
+      void schedule( const fc::variant& request, task_type&& task )
+      {
+         if( request.is_array() )
+         {
+            const auto& requests = request.get_array();
+            request_class c = requests.size() ? write_request : cheap_request;
+
+            for( const auto& r : requests )
+            {
+               request_class rc = classify( get_method_name( r ) );
+               if( rc == expensive_request )
+               {
+                  c = expensive_request;
+                  break;
+               }
+               else if( rc == cheap_request )
+               {
+                  c = cheap_request;
+               }
+            }
+
+            schedule( c, "batch", std::move( task ) );
+         }
+         else
+         {
+            string method = get_method_name( request );
+            request_class c = classify( method );
+            schedule( c, std::move( method ), std::move( task ) );
+         }
+      }
+
+      void schedule( request_class c, string method, task_type&& task )
+      {
+         {
+            std::lock_guard< std::mutex > guard( _mutex );
+            _queues[ c ].push_back( pending_task{ std::move( method ), fc::time_point::now(), std::move( task ) } );
+            STATSD_GAUGE( "webserver", "queue_depth", request_class_names[ c ], _queues[ c ].size(), 1.0f );
+         }
+
+         _ios.post( [this](){ dispatch(); } );
+      }
+
+   private:
+      struct pending_task
+      {
+         string         method;
+         fc::time_point enqueued;
+         task_type      task;
+      };
+
+      bool below_limit( request_class c, const string& method )const
+      {
+         auto limit_itr = _class_limits.find( c );
+         if( limit_itr != _class_limits.end() && _class_running[ c ] >= limit_itr->second )
+            return false;
+
+         auto method_limit_itr = _method_limits.find( method );
+         if( method_limit_itr != _method_limits.end() )
+         {
+            auto running_itr = _method_running.find( method );
+            if( running_itr != _method_running.end() && running_itr->second >= method_limit_itr->second )
+               return false;
+         }
+
+         return true;
+      }
+
+      void dispatch()
+      {
+         pending_task next;
+         request_class c = request_class_count;
+
+         {
+            std::lock_guard< std::mutex > guard( _mutex );
+
+            for( uint32_t i = 0; i < request_class_count && c == request_class_count; ++i )
+            {
+               if( _queues[ i ].empty() || !below_limit( request_class( i ), string() ) )
+                  continue;
+
+               for( auto itr = _queues[ i ].begin(); itr != _queues[ i ].end(); ++itr )
+               {
+                  if( below_limit( request_class( i ), itr->method ) )
+                  {
+                     next = std::move( *itr );
+                     _queues[ i ].erase( itr );
+                     c = request_class( i );
+                     break;
+                  }
+               }
+            }
+
+            if( c == request_class_count )
+            {
+               ++_parked_tokens;
+               return;
+            }
+
+            ++_class_running[ c ];
+            ++_method_running[ next.method ];
+         }
+
+         STATSD_TIMER( "webserver", "queue_time", request_class_names[ c ], fc::time_point::now() - next.enqueued, 1.0f );
+
+         try
+         {
+            next.task();
+         }
+         catch( ... ) {}
+
+         std::lock_guard< std::mutex > guard( _mutex );
+         --_class_running[ c ];
+
+         auto running_itr = _method_running.find( next.method );
+         if( --running_itr->second == 0 )
+            _method_running.erase( running_itr );
+
+         if( _parked_tokens )
+         {
+            --_parked_tokens;
+            _ios.post( [this](){ dispatch(); } );
+         }
+      }
+
+      asio::io_service&                         _ios;
+      std::mutex                                _mutex;
+      std::deque< pending_task >                _queues[ request_class_count ];
+      std::vector< string >                     _patterns[ request_class_count ];
+      map< uint32_t, uint32_t >                 _class_limits;
+      map< string, uint32_t >                   _method_limits;
+      uint32_t                                  _class_running[ request_class_count ] = {};
+      map< string, uint32_t >                   _method_running;
+      uint32_t                                  _parked_tokens = 0;
+};
+
 class webserver_plugin_impl
 {
    public:
       webserver_plugin_impl(thread_pool_size_t thread_pool_size) :
-         thread_pool_work( this->thread_pool_ios )
+         thread_pool_work( this->thread_pool_ios ),
+         scheduler( this->thread_pool_ios )
       {
          for( uint32_t i = 0; i < thread_pool_size; ++i )
             thread_pool.create_thread( boost::bind( &asio::io_service::run, &thread_pool_ios ) );
@@ -129,6 +391,9 @@ class webserver_plugin_impl
       void handle_http_message( websocket_server_type*, connection_hdl );
       void handle_http_request( websocket_local_server_type*, connection_hdl );
 
+      template< typename Handler >
+      void schedule_call( const string& body, Handler&& handler );
+
       shared_ptr< std::thread >  http_thread;
       asio::io_service           http_ios;
       optional< tcp::endpoint >  http_endpoint;
@@ -147,6 +412,7 @@ class webserver_plugin_impl
       boost::thread_group        thread_pool;
       asio::io_service           thread_pool_ios;
       asio::io_service::work     thread_pool_work;
+      request_scheduler          scheduler;
 
       plugins::json_rpc::json_rpc_plugin* api;
       boost::signals2::connection         chain_sync_con;
@@ -284,14 +550,17 @@ void webserver_plugin_impl::handle_ws_message( websocket_server_type* server, co
 {
    auto con = server->get_con_from_hdl( hdl );
 
-   thread_pool_ios.post( [con, msg, this]()
+   if( msg->get_opcode() != websocketpp::frame::opcode::text )
+   {
+      con->send( "error: string payload expected" );
+      return;
+   }
+
+   schedule_call( msg->get_payload(), [con, this]( const fc::optional< fc::variant >& request, const string& payload )
    {
       try
       {
-         if( msg->get_opcode() == websocketpp::frame::opcode::text )
-            con->send( api->call( msg->get_payload() ) );
-         else
-            con->send( "error: string payload expected" );
+         con->send( request ? api->call( *request ) : api->call( payload ) );
       }
       catch( fc::exception& e )
       {
@@ -318,18 +587,52 @@ void webserver_plugin_impl::handle_ws_message( websocket_server_type* server, co
    });
 }
 
+/**
+ * Parses the request on the thread pool and hands it to the scheduler, which
+ * invokes the handler once the call is allowed to run. Requests that fail to
+ * parse are passed through as raw payloads so json_rpc_plugin reports the error.
+ */
+template< typename Handler >
+void webserver_plugin_impl::schedule_call( const string& body, Handler&& handler )
+{
+   thread_pool_ios.post( [body, handler, this]()
+   {
+      fc::optional< fc::variant > request;
+
+      try
+      {
+         request = fc::json::from_string( body );
+      }
+      catch( ... ) {}
+
+      if( request )
+      {
+         auto parsed = std::make_shared< fc::variant >( std::move( *request ) );
+         scheduler.schedule( *parsed, [parsed, handler, body]()
+         {
+            handler( fc::optional< fc::variant >( std::move( *parsed ) ), body );
+         });
+      }
+      else
+      {
+         scheduler.schedule( cheap_request, string(), [handler, body]()
+         {
+            handler( fc::optional< fc::variant >(), body );
+         });
+      }
+   });
+}
+
 void webserver_plugin_impl::handle_http_message( websocket_server_type* server, connection_hdl hdl )
 {
    auto con = server->get_con_from_hdl( hdl );
    con->defer_http_response();
 
-   thread_pool_ios.post( [con, this]()
+   schedule_call( con->get_request_body(), [con, this]( const fc::optional< fc::variant >& request, const string& body )
    {
-      auto body = con->get_request_body();
-
       try
       {
-         con->set_body( api->call( body ) );
+         con->set_body( request ? api->call( *request ) : api->call( body ) );
          con->append_header( "Content-Type", "application/json" );
          con->set_status( websocketpp::http::status_code::ok );
       }
@@ -368,13 +671,11 @@ void webserver_plugin_impl::handle_http_request(websocket_local_server_type* ser
    auto con = server->get_con_from_hdl( hdl );
    con->defer_http_response();
 
-   thread_pool_ios.post( [con, this]()
+   schedule_call( con->get_request_body(), [con, this]( const fc::optional< fc::variant >& request, const string& body )
    {
-      auto body = con->get_request_body();
-
       try
       {
-         con->set_body( api->call( body ) );
+         con->set_body( request ? api->call( *request ) : api->call( body ) );
          con->append_header( "Content-Type", "application/json" );
          con->set_status( websocketpp::http::status_code::ok );
       }
@@ -423,6 +724,14 @@ void webserver_plugin::set_program_options( options_description&, options_descri
       ("rpc-endpoint", bpo::value< string >(), "Local http and websocket endpoint for webserver requests. Deprecated in favor of webserver-http-endpoint and webserver-ws-endpoint" )
       ("webserver-thread-pool-size", bpo::value<thread_pool_size_t>()->default_value(32),
        "Number of threads used to handle queries. Default: 32.")
+      ("webserver-write-methods", bpo::value< vector< string > >()->composing(),
+       "Additional API methods scheduled with write priority, e.g. network_broadcast_api.* (may specify multiple times)")
+      ("webserver-expensive-methods", bpo::value< vector< string > >()->composing(),
+       "Additional API methods scheduled with the lowest priority, e.g. tags_api.get_discussions_by_* (may specify multiple times)")
+      ("webserver-expensive-concurrency", bpo::value< uint32_t >()->default_value(0),
+       "Maximum number of expensive API calls executing concurrently. Default: 0 (half of the thread pool)")
+      ("webserver-method-concurrency", bpo::value< vector< string > >()->composing(),
+       "Maximum number of concurrent calls for a method as api.method=limit (may specify multiple times)")
       ;
 }
 
@@ -433,6 +742,58 @@ void webserver_plugin::plugin_initialize( const variables_map& options )
    ilog("configured with ${tps} thread pool size", ("tps", thread_pool_size));
    my.reset(new detail::webserver_plugin_impl(thread_pool_size));
 
+   auto write_methods = detail::default_write_methods;
+   if( options.count( "webserver-write-methods" ) )
+   {
+      const auto& methods = options.at( "webserver-write-methods" ).as< vector< string > >();
+      write_methods.insert( write_methods.end(), methods.begin(), methods.end() );
+   }
+   my->scheduler.set_write_methods( write_methods );
+
+   auto expensive_methods = detail::default_expensive_methods;
+   if( options.count( "webserver-expensive-methods" ) )
+   {
+      const auto& methods = options.at( "webserver-expensive-methods" ).as< vector< string > >();
+      expensive_methods.insert( expensive_methods.end(), methods.begin(), methods.end() );
+   }
+   my->scheduler.set_expensive_methods( expensive_methods );
+
+   auto expensive_concurrency = options.at( "webserver-expensive-concurrency" ).as< uint32_t >();
+   if( expensive_concurrency == 0 )
+      expensive_concurrency = std::max< uint32_t >( thread_pool_size / 2, 1 );
+   my->scheduler.set_class_limit( detail::expensive_request, expensive_concurrency );
+   ilog( "configured with ${c} concurrent expensive API calls", ("c", expensive_concurrency) );
+
+   if( options.count( "webserver-method-concurrency" ) )
+   {
+      for( const auto& limit : options.at( "webserver-method-concurrency" ).as< vector< string > >() )
+      {
+         vector< string > parts;
+         boost::split( parts, limit, boost::is_any_of( "=" ) );
+         FC_ASSERT( parts.size() == 2 && parts[0].size() && parts[1].size(),
+            "webserver-method-concurrency ${l} should be api.method=limit", ("l", limit) );
+
+         // lexical_cast accepts a leading sign for unsigned types, so only digits are let through
+         uint32_t method_limit = 0;
+         bool valid = std::all_of( parts[1].begin(), parts[1].end(), []( char c ){ return c >= '0' && c <= '9'; } );
+         if( valid )
+         {
+            try
+            {
+               method_limit = boost::lexical_cast< uint32_t >( parts[1] );
+            }
+            catch( const boost::bad_lexical_cast& )
+            {
+               valid = false;
+            }
+         }
+         FC_ASSERT( valid, "webserver-method-concurrency ${l} has an invalid limit, expected a number up to ${max}",
+            ("l", limit)("max", std::numeric_limits< uint32_t >::max()) );
+         FC_ASSERT( method_limit > 0, "webserver-method-concurrency limit for ${m} must be greater than 0", ("m", parts[0]) );
+         my->scheduler.set_method_limit( parts[0], method_limit );
+      }
+   }
+
    if( options.count( "webserver-http-endpoint" ) )
    {
       auto http_endpoint = options.at( "webserver-http-endpoint" ).as< string >();
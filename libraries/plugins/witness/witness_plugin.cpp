@@ -82,8 +82,8 @@ namespace detail {
       plugins::chain::chain_plugin& _chain_plugin;
       chain::database&              _db;
       boost::signals2::connection   _post_apply_block_conn;
-      boost::signals2::connection   _pre_apply_operation_conn;
-      boost::signals2::connection   _post_apply_operation_conn;
+      chain::operation_subscription _pre_apply_operation_conn;
+      chain::operation_subscription _post_apply_operation_conn;
 
       std::shared_ptr< witness::block_producer >                         _block_producer;
    };
@@ -510,9 +510,10 @@ void witness_plugin::plugin_initialize(const boost::program_options::variables_m
 
    my->_post_apply_block_conn = my->_db.add_post_apply_block_handler(
       [&]( const chain::block_notification& note ){ my->on_post_apply_block( note ); }, *this, 0 );
-   my->_pre_apply_operation_conn = my->_db.add_pre_apply_operation_handler(
+   my->_pre_apply_operation_conn = my->_db.subscribe_pre_apply_operation< comment_options_operation, comment_operation,
+      transfer_operation, transfer_to_savings_operation, transfer_from_savings_operation >(
       [&]( const chain::operation_notification& note ){ my->on_pre_apply_operation( note ); }, *this, 0);
-   my->_post_apply_operation_conn = my->_db.add_pre_apply_operation_handler(
+   my->_post_apply_operation_conn = my->_db.subscribe_pre_apply_operation< custom_operation, custom_json_operation, custom_binary_operation >(
       [&]( const chain::operation_notification& note ){ my->on_post_apply_operation( note ); }, *this, 0);
 
    if( my->_witnesses.size() && my->_private_keys.size() )
@@ -41,27 +41,63 @@ namespace freezone { namespace protocol {
 
    checksum_type signed_block::calculate_merkle_root()const
    {
-      if( transactions.size() == 0 )
-         return checksum_type();
+      // Pack all transactions into one buffer so their digests can be hashed together
+      vector< uint32_t > offsets;
+      vector< uint32_t > sizes;
+      offsets.reserve( transactions.size() );
+      sizes.reserve( transactions.size() );
+
+      size_t total_size = 0;
+      for( const auto& trx : transactions )
+      {
+         offsets.push_back( total_size );
+         sizes.push_back( fc::raw::pack_size( trx ) );
+         total_size += sizes.back();
+      }
 
-      vector<digest_type> ids;
-      ids.resize( transactions.size() );
+      vector< char > packed( total_size );
+      fc::datastream< char* > ds( packed.data(), packed.size() );
+      vector< const char* > data;
+      data.reserve( transactions.size() );
       for( uint32_t i = 0; i < transactions.size(); ++i )
-         ids[i] = transactions[i].merkle_digest();
+      {
+         fc::raw::pack( ds, transactions[i] );
+         data.push_back( packed.data() + offsets[i] );
+      }
 
-      vector<digest_type>::size_type current_number_of_hashes = ids.size();
-      while( current_number_of_hashes > 1 )
+      vector<digest_type> ids( transactions.size() );
+      digest_type::hash_many( data.data(), sizes.data(), ids.size(), ids.data() );
+
+      return calculate_merkle_root( std::move( ids ) );
+   }
+
+   checksum_type signed_block::calculate_merkle_root( vector< digest_type > ids )
+   {
+      if( ids.size() == 0 )
+         return checksum_type();
+
+      static_assert( sizeof( digest_type ) == 32, "pairs are hashed straight from the ids vector" );
+
+      vector< digest_type > next;
+      vector< const char* > pairs;
+      vector< uint32_t > pair_sizes;
+
+      while( ids.size() > 1 )
       {
-         // hash ID's in pairs
-         uint32_t i_max = current_number_of_hashes - (current_number_of_hashes&1);
-         uint32_t k = 0;
+         // hash ID's in pairs, each pair packs as the two digests back to back
+         size_t pair_count = ids.size() / 2;
+         pairs.resize( pair_count );
+         pair_sizes.assign( pair_count, 2 * sizeof( digest_type ) );
+         for( size_t i = 0; i < pair_count; ++i )
+            pairs[i] = ids[ 2 * i ].data();
+
+         next.resize( pair_count + ( ids.size() & 1 ) );
+         digest_type::hash_many( pairs.data(), pair_sizes.data(), pair_count, next.data() );
 
-         for( uint32_t i = 0; i < i_max; i += 2 )
-            ids[k++] = digest_type::hash( std::make_pair( ids[i], ids[i+1] ) );
+         if( ids.size() & 1 )
+            next.back() = ids.back();
 
-         if( current_number_of_hashes&1 )
-            ids[k++] = ids[i_max];
-         current_number_of_hashes = k;
+         std::swap( ids, next );
       }
       return checksum_type::hash( ids[0] );
    }
@@ -7,6 +7,10 @@ namespace freezone { namespace protocol {
    struct signed_block : public signed_block_header
    {
       checksum_type calculate_merkle_root()const;
+
+      /// Merkle root of the transactions with the given merkle digests, in block order
+      static checksum_type calculate_merkle_root( vector< digest_type > merkle_digests );
+
       vector<signed_transaction> transactions;
    };
 
@@ -96,6 +96,16 @@ using fc::ecc::canonical_signature_type;
 
       flat_set<public_key_type> get_signature_keys( const chain_id_type& chain_id, canonical_signature_type/* = fc::ecc::fc_canonical*/ )const;
 
+      /**
+       * Recovers the signature keys of many transactions at once, such as all transactions of a block,
+       * with the help of up to helpers tasks posted to the caller's pool, see fc::ecc::public_key::recover_many.
+       * An entry is empty when any signature of its transaction could not be recovered or is a duplicate,
+       * and get_signature_keys reports why.
+       */
+      static vector< fc::optional< flat_set< public_key_type > > > get_signature_keys(
+         const vector< signed_transaction >& trxs, const chain_id_type& chain_id, canonical_signature_type canon_type,
+         const fc::ecc::public_key::task_poster& post = fc::ecc::public_key::task_poster(), uint32_t helpers = 0 );
+
       vector<signature_type> signatures;
 
       digest_type merkle_digest()const;
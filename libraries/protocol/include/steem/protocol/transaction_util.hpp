@@ -102,4 +102,22 @@ void verify_authority( const vector<AuthContainerType>& auth_containers, const f
       );
 } FC_CAPTURE_AND_RETHROW( (auth_containers)(sigs) ) }
 
+/**
+ *  Same as signed_transaction::get_signature_keys, inserting the keys into result so that
+ *  the caller chooses the set type and its allocator.
+ */
+template< typename KeySet >
+void get_signature_keys( const signed_transaction& trx, const chain_id_type& chain_id, canonical_signature_type canon_type,
+                         KeySet& result )
+{ try {
+   auto d = trx.sig_digest( chain_id );
+   for( const auto& sig : trx.signatures )
+   {
+      freezone_ASSERT(
+         result.insert( public_key_type( fc::ecc::public_key( sig, d, canon_type ) ) ).second,
+         tx_duplicate_sig,
+         "Duplicate Signature detected" );
+   }
+} FC_CAPTURE_AND_RETHROW() }
+
 } } // freezone::protocol
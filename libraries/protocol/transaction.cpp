@@ -83,18 +83,50 @@ void transaction::get_required_authorities( flat_set< account_name_type >& activ
 }
 
 flat_set<public_key_type> signed_transaction::get_signature_keys( const chain_id_type& chain_id, canonical_signature_type canon_type )const
-{ try {
-   auto d = sig_digest( chain_id );
+{
    flat_set<public_key_type> result;
-   for( const auto&  sig : signatures )
+   protocol::get_signature_keys( *this, chain_id, canon_type, result );
+   return result;
+}
+
+vector< fc::optional< flat_set< public_key_type > > > signed_transaction::get_signature_keys(
+   const vector< signed_transaction >& trxs, const chain_id_type& chain_id, canonical_signature_type canon_type,
+   const fc::ecc::public_key::task_poster& post, uint32_t helpers )
+{
+   vector< fc::ecc::compact_signature > signatures;
+   vector< digest_type > digests;
+   for( const auto& trx : trxs )
    {
-      freezone_ASSERT(
-         result.insert( fc::ecc::public_key( sig, d, canon_type ) ).second,
-         tx_duplicate_sig,
-         "Duplicate Signature detected" );
+      auto d = trx.sig_digest( chain_id );
+      for( const auto& sig : trx.signatures )
+      {
+         signatures.push_back( sig );
+         digests.push_back( d );
+      }
    }
+
+   vector< fc::ecc::public_key_data > keys( signatures.size() );
+   fc::ecc::public_key::recover_many( signatures.data(), digests.data(), signatures.size(), keys.data(), canon_type, post, helpers );
+
+   const fc::ecc::public_key_data empty_key;
+   vector< fc::optional< flat_set< public_key_type > > > result( trxs.size() );
+   size_t k = 0;
+   for( size_t i = 0; i < trxs.size(); ++i )
+   {
+      flat_set< public_key_type > trx_keys;
+      bool recovered = true;
+      for( size_t j = 0; j < trxs[i].signatures.size(); ++j, ++k )
+      {
+         if( keys[k] == empty_key || !trx_keys.insert( public_key_type( keys[k] ) ).second )
+            recovered = false;
+      }
+
+      if( recovered )
+         result[i] = std::move( trx_keys );
+   }
+
    return result;
-} FC_CAPTURE_AND_RETHROW() }
+}
 
 
 
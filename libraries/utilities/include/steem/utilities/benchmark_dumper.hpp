@@ -56,6 +56,15 @@ public:
 
    typedef std::vector<database_object_sizeof_t> database_object_sizeof_cntr_t;
 
+   /// Counters of an allocator, cumulative since it was created
+   struct allocation_counters
+   {
+      uint64_t allocations = 0;
+      uint64_t bytes = 0;
+      uint64_t peak_block_bytes = 0;
+      uint64_t chunk_allocations = 0;
+   };
+
    class measurement
    {
    public:
@@ -74,6 +83,11 @@ public:
       int32_t  cpu_ms = 0;
       uint64_t current_mem = 0;
       uint64_t peak_mem = 0;
+      /// Block arena allocations since the previous measurement, and the most bytes used by a single block
+      uint64_t arena_allocations = 0;
+      uint64_t arena_bytes = 0;
+      uint64_t arena_peak_block_bytes = 0;
+      uint64_t arena_chunk_allocations = 0;
       index_memory_details_cntr_t index_memory_details_cntr;
    };
 
@@ -100,6 +114,13 @@ public:
    }
 
    const measurement& measure(uint32_t block_number, get_indexes_memory_details_t get_indexes_memory_details)
+   {
+      return measure(block_number, get_indexes_memory_details, _last_arena);
+   }
+
+   /// @param arena counters of the block arena, reported as the difference from the previous measurement
+   const measurement& measure(uint32_t block_number, get_indexes_memory_details_t get_indexes_memory_details,
+      const allocation_counters& arena)
    {
       uint64_t current_virtual = 0;
       uint64_t peak_virtual = 0;
@@ -114,6 +135,10 @@ public:
                 int((current_cpu_time - _last_cpu_time) * 1000 / CLOCKS_PER_SEC), // cpu_ms
                 current_virtual,
                 peak_virtual );
+      data.arena_allocations = arena.allocations - _last_arena.allocations;
+      data.arena_bytes = arena.bytes - _last_arena.bytes;
+      data.arena_peak_block_bytes = arena.peak_block_bytes;
+      data.arena_chunk_allocations = arena.chunk_allocations - _last_arena.chunk_allocations;
       get_indexes_memory_details(data.index_memory_details_cntr, true);
       _all_data.measurements.push_back( data );
    
@@ -126,6 +151,11 @@ public:
          int((_last_cpu_time - _init_cpu_time) * 1000 / CLOCKS_PER_SEC),
          current_virtual,
          peak_virtual );
+      _all_data.total_measurement.arena_allocations = arena.allocations;
+      _all_data.total_measurement.arena_bytes = arena.bytes;
+      _all_data.total_measurement.arena_peak_block_bytes = arena.peak_block_bytes;
+      _all_data.total_measurement.arena_chunk_allocations = arena.chunk_allocations;
+      _last_arena = arena;
 
       dump(false, get_indexes_memory_details);
    
@@ -176,6 +206,7 @@ private:
    uint64_t       _total_blocks = 0;
    pid_t          _pid = 0;
    TAllData       _all_data;
+   allocation_counters _last_arena;
 };
 
 } } // freezone::utilities
@@ -189,7 +220,9 @@ FC_REFLECT( freezone::utilities::benchmark_dumper::database_object_sizeof_t,
             (object_name)(object_size) )
 
 FC_REFLECT( freezone::utilities::benchmark_dumper::measurement,
-            (block_number)(real_ms)(cpu_ms)(current_mem)(peak_mem)(index_memory_details_cntr) )
+            (block_number)(real_ms)(cpu_ms)(current_mem)(peak_mem)
+            (arena_allocations)(arena_bytes)(arena_peak_block_bytes)(arena_chunk_allocations)
+            (index_memory_details_cntr) )
 
 FC_REFLECT( freezone::utilities::benchmark_dumper::TAllData,
             (database_object_sizeofs)(measurements)(total_measurement) )
@@ -0,0 +1,109 @@
+/**
+ * Benchmarks comment lookups by author and permlink through the permlink hash index used by
+ * database::find_comment, against the index on the full permlink string.
+ */
+
+#include <freezone/chain/comment_object.hpp>
+#include <freezone/chain/database.hpp>
+
+#include <freezone/utilities/database_configuration.hpp>
+#include <freezone/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace freezone::chain;
+
+int errors = 0;
+size_t rounds = 20;
+
+template< typename F >
+double measure( F&& f )
+{
+   auto start = std::chrono::steady_clock::now();
+   for( size_t r = 0; r < rounds; ++r )
+      f();
+   return std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count() / rounds;
+}
+
+int main( int argc, char** argv, char** envp )
+{
+   uint32_t num_comments = 10000;
+   if( argc > 1 )
+      num_comments = std::strtoul( argv[1], nullptr, 10 );
+   if( argc > 2 )
+      rounds = std::strtoull( argv[2], nullptr, 10 );
+
+   fc::temp_directory dir( freezone::utilities::temp_directory_path() );
+
+   database db;
+   database::open_args args;
+   args.data_dir = dir.path();
+   args.shared_mem_dir = dir.path();
+   args.shared_file_size = 1024 * 1024 * 256;
+   args.database_cfg = freezone::utilities::default_database_configuration();
+   db._log_hardforks = false;
+   db.open( args );
+
+   const account_name_type author = freezone_INIT_MINER_NAME;
+   const std::string prefix = "re-a-reasonably-long-reply-permlink-as-generated-by-the-frontends-";
+
+   for( uint32_t i = 0; i < num_comments; ++i )
+   {
+      std::string permlink = prefix + std::to_string( i );
+      db.create< comment_object >( [&]( comment_object& c )
+      {
+         c.author = author;
+         from_string( c.permlink, permlink );
+         c.permlink_hash = hash_permlink( permlink );
+         c.cashout_time = fc::time_point_sec::maximum();
+         c.root_comment = c.id;
+      });
+   }
+
+   std::vector< std::string > permlinks;
+   for( uint32_t i = 0; i < num_comments; ++i )
+      permlinks.push_back( prefix + std::to_string( ( uint64_t( i ) * 7919 ) % num_comments ) );
+
+   size_t missing = 0;
+
+   double hashed_time = measure( [&]()
+   {
+      for( const auto& permlink : permlinks )
+         missing += db.find_comment( author, permlink ) == nullptr;
+   } );
+
+   std::cout << num_comments << " comment lookups" << std::endl;
+   std::cout << "   by_permlink_hash: " << hashed_time << " us" << std::endl;
+
+#ifndef ENABLE_MIRA
+   double string_time = measure( [&]()
+   {
+      for( const auto& permlink : permlinks )
+         missing += db.find< comment_object, by_permlink >( boost::make_tuple( author, permlink ) ) == nullptr;
+   } );
+
+   std::cout << "   by_permlink     : " << string_time << " us" << std::endl;
+#endif
+
+   if( missing )
+   {
+      std::cout << missing << " lookups did not find their comment" << std::endl;
+      ++errors;
+   }
+
+   db.close();
+
+   if( errors )
+   {
+      std::cout << "there were " << errors << " errors" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * Benchmarks fc::raw pack, unpack and pack_size of blocks, transactions and chain objects.
+ *
+ * Each value is also packed again after unpacking, and the result compared with the original bytes.
+ */
+
+#include <freezone/chain/account_object.hpp>
+#include <freezone/chain/transaction_object.hpp>
+#include <freezone/protocol/block.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/raw.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace freezone::protocol;
+using freezone::chain::account_authority_object;
+using freezone::chain::transaction_object;
+
+int errors = 0;
+size_t rounds = 2000;
+
+template< typename T, typename Make >
+void benchmark( const std::string& name, const T& value, Make&& make )
+{
+   auto packed = fc::raw::pack_to_vector( value );
+
+   auto copy = make();
+   fc::raw::unpack_from_vector( packed, copy );
+   if( fc::raw::pack_to_vector( copy ) != packed || fc::raw::pack_size( value ) != packed.size() )
+   {
+      std::cout << "round trip failed for " << name << std::endl;
+      ++errors;
+   }
+
+   auto time = [&]( const char* op, auto&& f )
+   {
+      auto start = std::chrono::steady_clock::now();
+      for( size_t r = 0; r < rounds; ++r )
+         f();
+      auto elapsed = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+      std::cout << "   " << op << ": " << elapsed / rounds << " us" << std::endl;
+   };
+
+   std::cout << name << " (" << packed.size() << " bytes)" << std::endl;
+
+   size_t sink = 0;
+   time( "pack     ", [&]() { sink += fc::raw::pack_to_vector( value ).size(); } );
+   time( "unpack   ", [&]() { auto v = make(); fc::raw::unpack_from_vector( packed, v ); } );
+   time( "pack_size", [&]() { sink += fc::raw::pack_size( value ); } );
+
+   if( sink == 0 )
+      std::cout << sink << std::endl;
+}
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = n;
+   trx.ref_block_prefix = n * 7;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation transfer;
+   transfer.from = "alice";
+   transfer.to = "bob";
+   transfer.amount = asset( n, freezone_SYMBOL );
+   transfer.memo = "payment " + std::to_string( n );
+   trx.operations.push_back( transfer );
+
+   vote_operation vote;
+   vote.voter = "charlie";
+   vote.author = "dave";
+   vote.permlink = "a-post-about-the-number-" + std::to_string( n );
+   vote.weight = freezone_100_PERCENT;
+   trx.operations.push_back( vote );
+
+   comment_operation comment;
+   comment.parent_author = "dave";
+   comment.parent_permlink = vote.permlink;
+   comment.author = "charlie";
+   comment.permlink = "re-" + vote.permlink;
+   comment.title = "";
+   comment.body = std::string( 512, 'x' );
+   comment.json_metadata = "{\"tags\":[\"benchmark\"]}";
+   trx.operations.push_back( comment );
+
+   for( uint32_t i = 0; i < 2; ++i )
+   {
+      signature_type sig;
+      for( size_t j = 0; j < sig.size(); ++j )
+         sig.data[j] = (unsigned char)( n + i + j );
+      trx.signatures.push_back( sig );
+   }
+
+   return trx;
+}
+
+int main( int argc, char** argv, char** envp )
+{
+   if( argc > 1 )
+      rounds = std::strtoull( argv[1], nullptr, 10 );
+
+   auto trx = make_transaction( 1 );
+
+   signed_block block;
+   block.previous = block_id_type( "0000000100000000000000000000000000000000" );
+   block.timestamp = fc::time_point_sec( 1500000000 );
+   block.witness = "initminer";
+   for( uint32_t i = 0; i < 500; ++i )
+      block.transactions.push_back( make_transaction( i ) );
+   block.transaction_merkle_root = block.calculate_merkle_root();
+
+   benchmark( "signed_transaction", trx, []() { return signed_transaction(); } );
+   benchmark( "signed_block", block, []() { return signed_block(); } );
+
+#ifdef ENABLE_MIRA
+   chainbase::allocator< char > alloc;
+#else
+   fc::temp_directory dir( fc::temp_directory_path() );
+   auto file = ( dir.path() / "objects" ).generic_string();
+   chainbase::bip::managed_mapped_file segment( chainbase::bip::create_only, file.c_str(), 64 * 1024 * 1024 );
+   chainbase::allocator< char > alloc( segment.get_segment_manager() );
+#endif
+
+   transaction_object trx_object( [&]( transaction_object& o )
+   {
+      o.trx_id = trx.id();
+      o.expiration = trx.expiration;
+      fc::raw::pack_to_buffer( o.packed_trx, trx );
+   }, alloc );
+
+   benchmark( "transaction_object", trx_object, [&]() { return transaction_object( []( transaction_object& ){}, alloc ); } );
+
+   account_authority_object auth_object( [&]( account_authority_object& o )
+   {
+      o.account = "alice";
+      authority auth( 2, "bob", 1, "charlie", 1 );
+      for( uint32_t i = 0; i < 8; ++i )
+         auth.add_authority( fc::ecc::private_key::regenerate( fc::sha256::hash( std::to_string( i ) ) ).get_public_key(), 1 );
+      o.owner = auth;
+      o.active = auth;
+      o.posting = auth;
+   }, alloc );
+
+   benchmark( "account_authority_object", auth_object, [&]() { return account_authority_object( []( account_authority_object& ){}, alloc ); } );
+
+   if( errors )
+   {
+      std::cout << "there were " << errors << " errors" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * Benchmarks fc::sha256::hash_many against hashing one message at a time, and the merkle root of a
+ * block against the pairwise reference computation.
+ */
+
+#include <freezone/protocol/block.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/io/raw.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace freezone::protocol;
+
+int errors = 0;
+size_t rounds = 200;
+
+template< typename F >
+double measure( F&& f )
+{
+   auto start = std::chrono::steady_clock::now();
+   for( size_t r = 0; r < rounds; ++r )
+      f();
+   return std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count() / rounds;
+}
+
+void benchmark( const std::string& name, const std::vector< std::string >& messages )
+{
+   std::vector< const char* > data;
+   std::vector< uint32_t > sizes;
+   for( const auto& m : messages )
+   {
+      data.push_back( m.data() );
+      sizes.push_back( m.size() );
+   }
+
+   std::vector< fc::sha256 > one( messages.size() );
+   std::vector< fc::sha256 > many( messages.size() );
+
+   double one_time = measure( [&]()
+   {
+      for( size_t i = 0; i < messages.size(); ++i )
+         one[i] = fc::sha256::hash( data[i], sizes[i] );
+   } );
+
+   double many_time = measure( [&]()
+   {
+      fc::sha256::hash_many( data.data(), sizes.data(), messages.size(), many.data() );
+   } );
+
+   if( one != many )
+   {
+      std::cout << name << ": hash_many produced different digests" << std::endl;
+      ++errors;
+   }
+
+   std::cout << name << " (" << messages.size() << " messages)" << std::endl;
+   std::cout << "   hash     : " << one_time << " us" << std::endl;
+   std::cout << "   hash_many: " << many_time << " us" << std::endl;
+}
+
+checksum_type reference_merkle_root( const signed_block& block )
+{
+   std::vector< digest_type > ids;
+   for( const auto& trx : block.transactions )
+      ids.push_back( trx.merkle_digest() );
+
+   while( ids.size() > 1 )
+   {
+      std::vector< digest_type > next;
+      for( size_t i = 0; i + 1 < ids.size(); i += 2 )
+         next.push_back( digest_type::hash( std::make_pair( ids[i], ids[i+1] ) ) );
+      if( ids.size() & 1 )
+         next.push_back( ids.back() );
+      ids = std::move( next );
+   }
+
+   return ids.empty() ? checksum_type() : checksum_type::hash( ids[0] );
+}
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = n;
+   trx.ref_block_prefix = n * 7;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation transfer;
+   transfer.from = "alice";
+   transfer.to = "bob";
+   transfer.amount = asset( n, freezone_SYMBOL );
+   transfer.memo = std::string( n % 200, 'm' );
+   trx.operations.push_back( transfer );
+
+   signature_type sig;
+   for( size_t j = 0; j < sig.size(); ++j )
+      sig.data[j] = (unsigned char)( n + j );
+   trx.signatures.push_back( sig );
+
+   return trx;
+}
+
+int main( int argc, char** argv, char** envp )
+{
+   if( argc > 1 )
+      rounds = std::strtoull( argv[1], nullptr, 10 );
+
+   std::vector< std::string > pairs( 4096 );
+   for( size_t i = 0; i < pairs.size(); ++i )
+   {
+      pairs[i].resize( 64 );
+      for( size_t j = 0; j < 64; ++j )
+         pairs[i][j] = char( i * 13 + j );
+   }
+   benchmark( "merkle pairs", pairs );
+
+   std::vector< std::string > transactions( 2000 );
+   for( size_t i = 0; i < transactions.size(); ++i )
+      transactions[i] = std::string( 100 + ( i * 37 ) % 300, char( i ) );
+   benchmark( "transactions", transactions );
+
+   for( uint32_t count : { 0, 1, 2, 3, 7, 8, 9, 1000 } )
+   {
+      signed_block block;
+      for( uint32_t i = 0; i < count; ++i )
+         block.transactions.push_back( make_transaction( i ) );
+
+      checksum_type expected = reference_merkle_root( block );
+      checksum_type root;
+
+      double reference_time = measure( [&]() { expected = reference_merkle_root( block ); } );
+      double root_time = measure( [&]() { root = block.calculate_merkle_root(); } );
+
+      if( root != expected )
+      {
+         std::cout << "merkle root of " << count << " transactions differs from the reference" << std::endl;
+         ++errors;
+      }
+
+      if( count == 1000 )
+      {
+         std::cout << "merkle root (" << count << " transactions)" << std::endl;
+         std::cout << "   reference            : " << reference_time << " us" << std::endl;
+         std::cout << "   calculate_merkle_root: " << root_time << " us" << std::endl;
+      }
+   }
+
+   if( errors )
+   {
+      std::cout << "there were " << errors << " errors" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
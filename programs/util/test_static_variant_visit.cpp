@@ -0,0 +1,109 @@
+/**
+ * Micro-benchmark for visiting fc::static_variant, run over every alternative of freezone::protocol::operation.
+ *
+ * Compares the table dispatch used by fc::static_variant with a chain of tag comparisons like the one it
+ * replaced, and checks that both reach the alternative selected by the tag.
+ */
+
+#include <freezone/protocol/operations.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using freezone::protocol::operation;
+
+struct tag_visitor
+{
+   typedef int64_t result_type;
+
+   template< typename T >
+   int64_t operator()( const T& )const
+   {
+      return operation::tag< T >::value;
+   }
+};
+
+template< typename StaticVariant >
+struct linear_dispatch;
+
+template< typename... Ts >
+struct linear_dispatch< fc::static_variant< Ts... > >
+{
+   template< int64_t N, typename Visitor >
+   static typename Visitor::result_type apply( int64_t, const void*, const Visitor& )
+   {
+      FC_THROW_EXCEPTION( fc::assert_exception, "Invalid tag" );
+   }
+
+   template< int64_t N, typename Visitor, typename T, typename... Us >
+   static typename Visitor::result_type apply( int64_t n, const void* data, const Visitor& v )
+   {
+      if( n == N ) return v( *reinterpret_cast< const T* >( data ) );
+      else return apply< N + 1, Visitor, Us... >( n, data, v );
+   }
+
+   template< typename Visitor >
+   static typename Visitor::result_type visit( const fc::static_variant< Ts... >& sv, const Visitor& v )
+   {
+      // The storage of a static_variant immediately follows its tag
+      const char* data = reinterpret_cast< const char* >( &sv ) + sizeof( int64_t );
+      return apply< 0, Visitor, Ts... >( sv.which(), data, v );
+   }
+};
+
+int main( int argc, char** argv, char** envp )
+{
+   size_t rounds = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 20000;
+
+   std::vector< operation > ops;
+   for( size_t r = 0; r < 16; ++r )
+   {
+      for( int64_t i = 0; i < operation::count(); ++i )
+      {
+         operation op;
+         op.set_which( i );
+         ops.push_back( std::move( op ) );
+      }
+   }
+
+   std::shuffle( ops.begin(), ops.end(), std::mt19937( 0 ) );
+
+   int errors = 0;
+   for( const auto& op : ops )
+   {
+      if( op.visit( tag_visitor() ) != op.which() || linear_dispatch< operation >::visit( op, tag_visitor() ) != op.which() )
+      {
+         std::cout << "dispatch mismatch on tag " << op.which() << std::endl;
+         ++errors;
+      }
+   }
+
+   auto time = [&]( const char* name, auto&& visit )
+   {
+      int64_t sum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for( size_t r = 0; r < rounds; ++r )
+         for( const auto& op : ops )
+            sum += visit( op );
+      auto elapsed = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+
+      std::cout << name << ": " << elapsed / ( rounds * ops.size() ) << " ns per visit (checksum " << sum << ")" << std::endl;
+   };
+
+   std::cout << operation::count() << " operation types, " << ops.size() << " operations, " << rounds << " rounds" << std::endl;
+
+   time( "table dispatch ", []( const operation& op ) { return op.visit( tag_visitor() ); } );
+   time( "linear dispatch", []( const operation& op ) { return linear_dispatch< operation >::visit( op, tag_visitor() ); } );
+
+   if( errors )
+   {
+      std::cout << "there were " << errors << " errors" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * Counts the heap allocations made converting blocks and transactions to variants and JSON, with and
+ * without a fc::variant_arena, and checks that both produce the same JSON.
+ */
+
+#include <freezone/protocol/block.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_arena.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+std::atomic< uint64_t > allocations( 0 );
+
+void* operator new( size_t size )
+{
+   ++allocations;
+   if( void* p = std::malloc( size ? size : 1 ) )
+      return p;
+   throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+   std::free( p );
+}
+
+void operator delete( void* p, size_t ) noexcept
+{
+   std::free( p );
+}
+
+using namespace freezone::protocol;
+
+int errors = 0;
+size_t rounds = 20;
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = n;
+   trx.ref_block_prefix = n * 7;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation transfer;
+   transfer.from = "alice";
+   transfer.to = "bob";
+   transfer.amount = asset( n, freezone_SYMBOL );
+   transfer.memo = "payment " + std::to_string( n );
+   trx.operations.push_back( transfer );
+
+   vote_operation vote;
+   vote.voter = "charlie";
+   vote.author = "dave";
+   vote.permlink = "a-post-about-the-number-" + std::to_string( n );
+   vote.weight = freezone_100_PERCENT;
+   trx.operations.push_back( vote );
+
+   signature_type sig;
+   for( size_t j = 0; j < sig.size(); ++j )
+      sig.data[j] = (unsigned char)( n + j );
+   trx.signatures.push_back( sig );
+
+   return trx;
+}
+
+template< typename T >
+void benchmark( const std::string& name, const T& value )
+{
+   std::string expected = fc::json::to_string( fc::variant( value ) );
+
+   auto run = [&]( const char* mode, bool use_arena )
+   {
+      uint64_t start_allocations = allocations;
+      auto start = std::chrono::steady_clock::now();
+
+      for( size_t r = 0; r < rounds; ++r )
+      {
+         std::unique_ptr< fc::variant_arena > arena;
+         if( use_arena )
+            arena.reset( new fc::variant_arena() );
+
+         std::string json = fc::json::to_string( fc::variant( value ) );
+         if( json != expected )
+         {
+            std::cout << name << ": " << mode << " produced different JSON" << std::endl;
+            ++errors;
+         }
+      }
+
+      auto elapsed = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+      std::cout << "   " << mode << ": " << ( allocations - start_allocations ) / rounds << " allocations, "
+                << elapsed / rounds << " us" << std::endl;
+   };
+
+   std::cout << name << " (" << expected.size() << " bytes of JSON)" << std::endl;
+   run( "heap ", false );
+   run( "arena", true );
+}
+
+int main( int argc, char** argv, char** envp )
+{
+   if( argc > 1 )
+      rounds = std::strtoull( argv[1], nullptr, 10 );
+
+   signed_block block;
+   block.previous = block_id_type( "0000000100000000000000000000000000000000" );
+   block.timestamp = fc::time_point_sec( 1500000000 );
+   block.witness = "initminer";
+   for( uint32_t i = 0; i < 500; ++i )
+      block.transactions.push_back( make_transaction( i ) );
+   block.transaction_merkle_root = block.calculate_merkle_root();
+
+   benchmark( "signed_transaction", block.transactions[0] );
+   benchmark( "signed_block", block );
+
+   // Variants built inside an arena must stay valid after it is gone
+   fc::variant escaped;
+   {
+      fc::variant_arena arena;
+      escaped = fc::variant( block );
+   }
+
+   if( fc::json::to_string( escaped ) != fc::json::to_string( fc::variant( block ) ) )
+   {
+      std::cout << "variant built in an arena changed after the arena was destroyed" << std::endl;
+      ++errors;
+   }
+
+   if( errors )
+   {
+      std::cout << "there were " << errors << " errors" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -988,6 +988,10 @@ json_rpc_database_fixture::json_rpc_database_fixture()
    appbase::app().register_plugin< freezone::plugins::database_api::database_api_plugin >();
    appbase::app().register_plugin< freezone::plugins::condenser_api::condenser_api_plugin >();
 
+   std::vector< char* > args( argv, argv + argc );
+   char call_stats_api[] = "--json-rpc-call-stats-api";
+   args.push_back( call_stats_api );
+
    db_plugin->logging = false;
    appbase::app().initialize<
       freezone::plugins::account_history::account_history_plugin,
@@ -996,7 +1000,7 @@ json_rpc_database_fixture::json_rpc_database_fixture()
       freezone::plugins::block_api::block_api_plugin,
       freezone::plugins::database_api::database_api_plugin,
       freezone::plugins::condenser_api::condenser_api_plugin
-      >( argc, argv );
+      >( int( args.size() ), args.data() );
 
    appbase::app().get_plugin< freezone::plugins::condenser_api::condenser_api_plugin >().plugin_startup();
 
@@ -0,0 +1,177 @@
+#if defined IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+#include <freezone/chain/account_object.hpp>
+#include <freezone/chain/comment_object.hpp>
+#include <freezone/protocol/freezone_operations.hpp>
+#include <freezone/plugins/follow/follow_plugin.hpp>
+
+#include "../db_fixture/database_fixture.hpp"
+
+using namespace freezone::chain;
+using namespace freezone::protocol;
+
+BOOST_FIXTURE_TEST_SUITE( follow, database_fixture );
+
+BOOST_AUTO_TEST_CASE( pulled_feed_cache_test )
+{
+   using namespace freezone::plugins::follow;
+
+   try
+   {
+      int argc = boost::unit_test::framework::master_test_suite().argc;
+      char** argv = boost::unit_test::framework::master_test_suite().argv;
+
+      for ( int i = 1; i < argc; i++ )
+      {
+         const std::string arg = argv[ i ];
+         if ( arg == "--record-assert-trip" )
+            fc::enable_record_assert_trip = true;
+         if ( arg == "--show-test-names" )
+            std::cout << "running test " << boost::unit_test::framework::current_test_case().p_name << std::endl;
+      }
+
+      appbase::app().register_plugin< follow_plugin >();
+      db_plugin = &appbase::app().register_plugin< freezone::plugins::debug_node::debug_node_plugin >();
+      init_account_pub_key = init_account_priv_key.get_public_key();
+
+      // We create an argc/argv so that the follow plugin computes feeds when they are queried
+      int test_argc = 3;
+      const char* test_argv[] = { boost::unit_test::framework::master_test_suite().argv[0],
+                                  "--follow-pull-feeds",
+                                  "true" };
+
+      db_plugin->logging = false;
+      appbase::app().initialize<
+         follow_plugin,
+         freezone::plugins::debug_node::debug_node_plugin >( test_argc, (char**)test_argv );
+
+      db = &appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db();
+      BOOST_REQUIRE( db );
+
+      auto& plugin = appbase::app().get_plugin< follow_plugin >();
+      BOOST_REQUIRE( plugin.pull_feeds );
+
+      open_database();
+
+      generate_block();
+      db->set_hardfork( freezone_NUM_HARDFORKS );
+      generate_block();
+
+      vest( "initminer", 10000 );
+
+      // Fill up the rest of the required miners
+      for( int i = freezone_NUM_INIT_MINERS; i < freezone_MAX_WITNESSES; i++ )
+      {
+         account_create( freezone_INIT_MINER_NAME + fc::to_string( i ), init_account_pub_key );
+         fund( freezone_INIT_MINER_NAME + fc::to_string( i ), freezone_MIN_PRODUCER_REWARD.amount.value );
+         witness_create( freezone_INIT_MINER_NAME + fc::to_string( i ), init_account_priv_key, "foo.bar", init_account_pub_key, freezone_MIN_PRODUCER_REWARD.amount );
+      }
+
+      validate_database();
+
+      ACTORS( (alice)(bob)(sam)(dave) );
+      generate_block();
+
+      auto post = [&]( const string& author, const fc::ecc::private_key& key, const string& permlink )
+      {
+         comment_operation op;
+         op.author = author;
+         op.permlink = permlink;
+         op.parent_permlink = "test";
+         op.title = "foo";
+         op.body = "bar";
+
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         sign( tx, key );
+         db->push_transaction( tx, 0 );
+      };
+
+      auto follow_json = [&]( const string& account, const fc::ecc::private_key& key, const string& json )
+      {
+         custom_json_operation op;
+         op.id = "follow";
+         op.required_posting_auths.insert( account );
+         op.json = json;
+
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         sign( tx, key );
+         db->push_transaction( tx, 0 );
+      };
+
+      auto comment_id = [&]( const string& author, const string& permlink )
+      {
+         return db->get_comment( author, permlink ).id;
+      };
+
+      follow_json( "alice", alice_post_key, "[\"follow\",{\"follower\":\"alice\",\"following\":\"bob\",\"what\":[\"blog\"]}]" );
+      follow_json( "alice", alice_post_key, "[\"follow\",{\"follower\":\"alice\",\"following\":\"sam\",\"what\":[\"blog\"]}]" );
+      generate_block();
+
+      post( "bob", bob_post_key, "bob-1" );
+      generate_block();
+
+      BOOST_TEST_MESSAGE( "--- Test a feed is merged from the followed blogs and cached" );
+      auto feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( feed->entries.size() == 1 );
+      BOOST_REQUIRE( feed->entries[0].comment == comment_id( "bob", "bob-1" ) );
+      BOOST_REQUIRE( plugin.get_pulled_feed( "alice" ) == feed );
+
+      BOOST_TEST_MESSAGE( "--- Test a post to a blog that is not followed keeps the cached feed" );
+      post( "dave", dave_post_key, "dave-1" );
+      generate_block();
+      BOOST_REQUIRE( plugin.get_pulled_feed( "alice" ) == feed );
+
+      BOOST_TEST_MESSAGE( "--- Test a post to a followed blog invalidates the feed" );
+      post( "sam", sam_post_key, "sam-1" );
+      generate_block();
+      feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( feed->entries.size() == 2 );
+      BOOST_REQUIRE( feed->entries[0].comment == comment_id( "sam", "sam-1" ) );
+      BOOST_REQUIRE( feed->entries[1].comment == comment_id( "bob", "bob-1" ) );
+      BOOST_REQUIRE( feed->positions.at( comment_id( "bob", "bob-1" ) ) == 1 );
+      BOOST_REQUIRE( plugin.get_pulled_feed( "alice" ) == feed );
+
+      BOOST_TEST_MESSAGE( "--- Test a reblog invalidates the feed and is folded into the entry of the post" );
+      follow_json( "sam", sam_post_key, "[\"reblog\",{\"account\":\"sam\",\"author\":\"bob\",\"permlink\":\"bob-1\"}]" );
+      generate_block();
+      feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( feed->entries.size() == 2 );
+      BOOST_REQUIRE( feed->entries[0].comment == comment_id( "bob", "bob-1" ) );
+      BOOST_REQUIRE( feed->entries[0].first_reblogged_by == account_name_type( "sam" ) );
+      BOOST_REQUIRE( feed->entries[1].comment == comment_id( "sam", "sam-1" ) );
+      BOOST_REQUIRE( feed->positions.at( comment_id( "sam", "sam-1" ) ) == 1 );
+
+      BOOST_TEST_MESSAGE( "--- Test following a blog invalidates the feed" );
+      follow_json( "alice", alice_post_key, "[\"follow\",{\"follower\":\"alice\",\"following\":\"dave\",\"what\":[\"blog\"]}]" );
+      generate_block();
+      feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( feed->entries.size() == 3 );
+      BOOST_REQUIRE( feed->positions.count( comment_id( "dave", "dave-1" ) ) == 1 );
+
+      BOOST_TEST_MESSAGE( "--- Test a pending post invalidates the feed" );
+      generate_blocks( db->head_block_time() + freezone_MIN_ROOT_COMMENT_INTERVAL + fc::seconds( freezone_BLOCK_INTERVAL ), true );
+      feed = plugin.get_pulled_feed( "alice" );
+      post( "bob", bob_post_key, "bob-2" );
+      auto pending_feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( pending_feed != feed );
+      BOOST_REQUIRE( pending_feed->entries.size() == 4 );
+      BOOST_REQUIRE( pending_feed->entries[0].comment == comment_id( "bob", "bob-2" ) );
+
+      BOOST_TEST_MESSAGE( "--- Test popping a block drops the cached feeds" );
+      generate_block();
+      BOOST_REQUIRE( plugin.get_pulled_feed( "alice" )->entries.size() == 4 );
+      db->pop_block();
+      db->clear_pending();
+      feed = plugin.get_pulled_feed( "alice" );
+      BOOST_REQUIRE( feed->entries.size() == 3 );
+      BOOST_REQUIRE( db->find_comment( "bob", string( "bob-2" ) ) == nullptr );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -312,5 +312,45 @@ BOOST_AUTO_TEST_CASE( semantics_validation )
    FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( call_stats )
+{
+   try
+   {
+      std::string request;
+
+      request = "[{\"jsonrpc\":\"2.0\", \"method\":\"database_api.get_dynamic_global_properties\", \"id\":1 },"
+                "{\"jsonrpc\":\"2.0\", \"method\":\"call\", \"params\":[\"database_api\", \"get_dynamic_global_properties\"], \"id\":2 }]";
+      make_array_request( request, 0, false, false );
+
+      request = "{\"jsonrpc\":\"2.0\", \"method\":\"database_api.find_accounts\", \"params\":{\"accounts\":[\"init_miner\"]}, \"id\":3}";
+      make_positive_request( request );
+
+      request = "{\"jsonrpc\":\"2.0\", \"method\":\"jsonrpc.get_call_stats\", \"params\":{}, \"id\":4}";
+      fc::variant answer = make_request( request, 0, false, false );
+
+      BOOST_REQUIRE( answer[ "result" ].is_array() );
+      bool found_dgpo = false;
+
+      for( const auto& stats : answer[ "result" ].get_array() )
+      {
+         if( stats[ "method" ].as_string() != "database_api.get_dynamic_global_properties" )
+            continue;
+
+         found_dgpo = true;
+         BOOST_REQUIRE( stats[ "count" ].as_uint64() == 2 );
+         BOOST_REQUIRE( stats[ "errors" ].as_uint64() == 0 );
+         BOOST_REQUIRE( stats[ "response_bytes" ][ "max" ].as_uint64() > 0 );
+         BOOST_REQUIRE( stats[ "execution_us" ][ "p50" ].as_uint64() <= stats[ "execution_us" ][ "max" ].as_uint64() );
+      }
+
+      BOOST_REQUIRE( found_dgpo );
+
+      request = "{\"jsonrpc\":\"2.0\", \"method\":\"jsonrpc.get_slow_calls\", \"params\":{}, \"id\":5}";
+      answer = make_request( request, 0, false, false );
+      BOOST_REQUIRE( answer[ "result" ].is_array() );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
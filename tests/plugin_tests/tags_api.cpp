@@ -0,0 +1,432 @@
+#if defined IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+#include <freezone/chain/account_object.hpp>
+#include <freezone/chain/comment_object.hpp>
+#include <freezone/protocol/freezone_operations.hpp>
+#include <freezone/plugins/tags/tags_plugin.hpp>
+#include <freezone/plugins/tags_api/tags_api_plugin.hpp>
+#include <freezone/plugins/tags_api/tags_api.hpp>
+#include <freezone/plugins/condenser_api/condenser_api.hpp>
+#include <freezone/plugins/follow/follow_objects.hpp>
+#include <freezone/plugins/follow/follow_plugin.hpp>
+#include <freezone/plugins/follow_api/follow_api_plugin.hpp>
+
+#include "../db_fixture/database_fixture.hpp"
+
+using namespace freezone::chain;
+using namespace freezone::protocol;
+using namespace freezone::plugins::tags;
+
+struct tags_api_database_fixture : public database_fixture
+{
+   tags_api_database_fixture()
+   {
+      try {
+      int argc = boost::unit_test::framework::master_test_suite().argc;
+      char** argv = boost::unit_test::framework::master_test_suite().argv;
+      for( int i=1; i<argc; i++ )
+      {
+         const std::string arg = argv[i];
+         if( arg == "--record-assert-trip" )
+            fc::enable_record_assert_trip = true;
+         if( arg == "--show-test-names" )
+            std::cout << "running test " << boost::unit_test::framework::current_test_case().p_name << std::endl;
+      }
+
+      appbase::app().register_plugin< tags_plugin >();
+      appbase::app().register_plugin< tags_api_plugin >();
+      appbase::app().register_plugin< freezone::plugins::follow::follow_plugin >();
+      appbase::app().register_plugin< freezone::plugins::follow::follow_api_plugin >();
+      db_plugin = &appbase::app().register_plugin< freezone::plugins::debug_node::debug_node_plugin >();
+
+      db_plugin->logging = false;
+      appbase::app().initialize<
+         tags_api_plugin,
+         freezone::plugins::follow::follow_api_plugin,
+         freezone::plugins::debug_node::debug_node_plugin
+         >( argc, argv );
+
+      appbase::app().get_plugin< tags_plugin >().plugin_startup();
+      appbase::app().get_plugin< tags_api_plugin >().plugin_startup();
+      api = appbase::app().get_plugin< tags_api_plugin >().api.get();
+
+      db = &appbase::app().get_plugin< freezone::plugins::chain::chain_plugin >().db();
+      BOOST_REQUIRE( db );
+
+      init_account_pub_key = init_account_priv_key.get_public_key();
+
+      open_database();
+
+      generate_block();
+      db->set_hardfork( freezone_NUM_HARDFORKS );
+      generate_block();
+
+      vest( "initminer", 10000 );
+
+      // Fill up the rest of the required miners
+      for( int i = freezone_NUM_INIT_MINERS; i < freezone_MAX_WITNESSES; i++ )
+      {
+         account_create( freezone_INIT_MINER_NAME + fc::to_string( i ), init_account_pub_key );
+         fund( freezone_INIT_MINER_NAME + fc::to_string( i ), freezone_MIN_PRODUCER_REWARD.amount.value );
+         witness_create( freezone_INIT_MINER_NAME + fc::to_string( i ), init_account_priv_key, "foo.bar", init_account_pub_key, freezone_MIN_PRODUCER_REWARD.amount );
+      }
+
+      validate_database();
+      } catch ( const fc::exception& e )
+      {
+         edump( (e.to_detail_string()) );
+         throw;
+      }
+   }
+
+   virtual ~tags_api_database_fixture()
+   {
+      if( data_dir )
+         db->wipe( data_dir->path(), data_dir->path(), true );
+   }
+
+   void post( const string& author, const fc::ecc::private_key& key, const string& permlink, const string& body = "foo bar" )
+   {
+      comment_operation op;
+      op.author = author;
+      op.permlink = permlink;
+      op.parent_permlink = "test";
+      op.title = "foo";
+      op.body = body;
+      op.json_metadata = "{\"tags\":[\"test\"]}";
+
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      sign( tx, key );
+      db->push_transaction( tx, 0 );
+   }
+
+   void vote( const string& voter, const fc::ecc::private_key& key, const string& author, const string& permlink, int16_t weight )
+   {
+      vote_operation op;
+      op.voter = voter;
+      op.author = author;
+      op.permlink = permlink;
+      op.weight = weight;
+
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      sign( tx, key );
+      db->push_transaction( tx, 0 );
+   }
+
+   tags_api* api = nullptr;
+};
+
+BOOST_FIXTURE_TEST_SUITE( tags_api_tests, tags_api_database_fixture );
+
+BOOST_AUTO_TEST_CASE( ranked_discussions )
+{
+   try
+   {
+      ACTORS( (alice)(bob)(sam)(dave)(voter) );
+      generate_block();
+
+      vest( freezone_INIT_MINER_NAME, "voter", ASSET( "10000.000 TESTS" ) );
+      generate_block();
+
+      post( "alice", alice_post_key, "alice-1" );
+      post( "bob", bob_post_key, "bob-1" );
+      post( "sam", sam_post_key, "sam-1" );
+      post( "dave", dave_post_key, "dave-1" );
+      generate_block();
+
+      vote( "voter", voter_post_key, "alice", "alice-1", freezone_100_PERCENT );
+      generate_block();
+      vote( "voter", voter_post_key, "bob", "bob-1", freezone_100_PERCENT / 2 );
+      generate_block();
+      vote( "voter", voter_post_key, "sam", "sam-1", freezone_100_PERCENT / 4 );
+      generate_block();
+
+      BOOST_TEST_MESSAGE( "--- Test only discussions with a positive score are ranked" );
+      const auto& rank_idx = db->get_index< tag_rank_index, by_parent_trending >();
+      auto rank_itr = rank_idx.lower_bound( boost::make_tuple( tag_name_type( "test" ) ) );
+      size_t ranked = 0;
+      for( ; rank_itr != rank_idx.end() && rank_itr->tag == tag_name_type( "test" ); ++rank_itr )
+         ++ranked;
+      BOOST_REQUIRE( ranked == 3 );
+
+      discussion_query q;
+      q.tag = "test";
+      q.limit = 2;
+
+      BOOST_TEST_MESSAGE( "--- Test first page of trending and hot" );
+      auto trending = api->get_discussions_by_trending( q ).discussions;
+      BOOST_REQUIRE( trending.size() == 2 );
+      BOOST_REQUIRE( trending[0].author == "alice" );
+      BOOST_REQUIRE( trending[1].author == "bob" );
+
+      auto hot = api->get_discussions_by_hot( q ).discussions;
+      BOOST_REQUIRE( hot.size() == 2 );
+      BOOST_REQUIRE( hot[0].author == "alice" );
+      BOOST_REQUIRE( hot[1].author == "bob" );
+
+      BOOST_TEST_MESSAGE( "--- Test pagination starts at the start comment" );
+      q.start_author = "bob";
+      q.start_permlink = "bob-1";
+      trending = api->get_discussions_by_trending( q ).discussions;
+      BOOST_REQUIRE( trending.size() == 2 );
+      BOOST_REQUIRE( trending[0].author == "bob" );
+      BOOST_REQUIRE( trending[1].author == "sam" );
+
+      q.start_author = "sam";
+      q.start_permlink = "sam-1";
+      hot = api->get_discussions_by_hot( q ).discussions;
+      BOOST_REQUIRE( hot.size() == 1 );
+      BOOST_REQUIRE( hot[0].author == "sam" );
+
+      BOOST_TEST_MESSAGE( "--- Test starting at a comment that is not ranked fails" );
+      q.start_author = "dave";
+      q.start_permlink = "dave-1";
+      freezone_REQUIRE_THROW( api->get_discussions_by_trending( q ), fc::assert_exception );
+      freezone_REQUIRE_THROW( api->get_discussions_by_hot( q ), fc::assert_exception );
+
+      BOOST_TEST_MESSAGE( "--- Test starting at a comment that is not in the tag fails" );
+      q.tag = "other";
+      q.start_author = "alice";
+      q.start_permlink = "alice-1";
+      freezone_REQUIRE_THROW( api->get_discussions_by_trending( q ), fc::assert_exception );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( discussion_fields )
+{
+   try
+   {
+      ACTORS( (alice)(bob)(voter) );
+      generate_block();
+
+      vest( freezone_INIT_MINER_NAME, "voter", ASSET( "10000.000 TESTS" ) );
+      generate_block();
+
+      post( "alice", alice_post_key, "alice-1", "foo bar baz" );
+      generate_block();
+
+      comment_operation reply;
+      reply.author = "bob";
+      reply.permlink = "bob-1";
+      reply.parent_author = "alice";
+      reply.parent_permlink = "alice-1";
+      reply.body = "foo bar baz";
+
+      signed_transaction tx;
+      tx.operations.push_back( reply );
+      tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      sign( tx, bob_post_key );
+      db->push_transaction( tx, 0 );
+      generate_block();
+
+      vote( "voter", voter_post_key, "alice", "alice-1", freezone_100_PERCENT );
+      generate_block();
+
+      discussion_query q;
+      q.tag = "test";
+      q.limit = 1;
+
+      BOOST_TEST_MESSAGE( "--- Test all members are returned without fields" );
+      auto result = api->get_discussions_by_trending( q );
+      BOOST_REQUIRE( result.discussions.size() == 1 );
+      BOOST_REQUIRE( result.discussions[0].body == "foo bar baz" );
+      BOOST_REQUIRE( result.discussions[0].active_votes.size() == 1 );
+      BOOST_REQUIRE( result.discussions[0].url == "/test/@alice/alice-1" );
+
+      auto obj = fc::variant( result ).get_object()[ "discussions" ].get_array()[0].get_object();
+      BOOST_REQUIRE( obj.contains( "body" ) );
+      BOOST_REQUIRE( obj.contains( "active_votes" ) );
+      BOOST_REQUIRE( obj.contains( "pending_payout_value" ) );
+
+      BOOST_TEST_MESSAGE( "--- Test only the selected members are looked up and serialized" );
+      q.fields = std::set< std::string >( { "author", "permlink", "title", "body_length" } );
+      result = api->get_discussions_by_trending( q );
+      BOOST_REQUIRE( result.discussions.size() == 1 );
+      BOOST_REQUIRE( result.discussions[0].author == "alice" );
+      BOOST_REQUIRE( result.discussions[0].title == "foo" );
+      BOOST_REQUIRE( result.discussions[0].body_length == 11 );
+      BOOST_REQUIRE( result.discussions[0].body.empty() );
+      BOOST_REQUIRE( result.discussions[0].active_votes.empty() );
+      BOOST_REQUIRE( result.discussions[0].url.empty() );
+
+      obj = fc::variant( result ).get_object()[ "discussions" ].get_array()[0].get_object();
+      BOOST_REQUIRE( obj.size() == 4 );
+      BOOST_REQUIRE( obj[ "author" ].as_string() == "alice" );
+      BOOST_REQUIRE( obj[ "permlink" ].as_string() == "alice-1" );
+      BOOST_REQUIRE( obj[ "title" ].as_string() == "foo" );
+      BOOST_REQUIRE( obj[ "body_length" ].as_uint64() == 11 );
+
+      BOOST_TEST_MESSAGE( "--- Test selecting the votes and the url" );
+      q.fields = std::set< std::string >( { "active_votes", "url" } );
+      result = api->get_discussions_by_trending( q );
+      BOOST_REQUIRE( result.discussions[0].active_votes.size() == 1 );
+      BOOST_REQUIRE( result.discussions[0].url == "/test/@alice/alice-1" );
+
+      obj = fc::variant( result ).get_object()[ "discussions" ].get_array()[0].get_object();
+      BOOST_REQUIRE( obj.size() == 2 );
+      BOOST_REQUIRE( obj[ "active_votes" ].get_array().size() == 1 );
+
+      BOOST_TEST_MESSAGE( "--- Test condenser_api serializes only the selected members" );
+      freezone::plugins::condenser_api::discussion_list legacy;
+      legacy.discussions.push_back( freezone::plugins::condenser_api::discussion( result.discussions[0] ) );
+      legacy.fields = q.fields;
+      auto legacy_array = fc::variant( legacy ).get_array();
+      BOOST_REQUIRE( legacy_array.size() == 1 );
+      obj = legacy_array[0].get_object();
+      BOOST_REQUIRE( obj.size() == 2 );
+      BOOST_REQUIRE( obj[ "url" ].as_string() == "/test/@alice/alice-1" );
+
+      legacy.fields.reset();
+      obj = fc::variant( legacy ).get_array()[0].get_object();
+      BOOST_REQUIRE( obj.contains( "pending_payout_value" ) );
+
+      BOOST_TEST_MESSAGE( "--- Test comment listings do not truncate the body" );
+      discussion_query cq;
+      cq.start_author = "bob";
+      cq.limit = 1;
+      cq.truncate_body = 3;
+      result = api->get_discussions_by_comments( cq );
+      BOOST_REQUIRE( result.discussions.size() == 1 );
+      BOOST_REQUIRE( result.discussions[0].body == "foo bar baz" );
+      BOOST_REQUIRE( fc::variant( result ).get_object()[ "discussions" ].get_array()[0].get_object().contains( "body" ) );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( active_votes_cache )
+{
+   try
+   {
+      ACTORS( (alice)(bob)(sam) );
+      generate_block();
+
+      vest( freezone_INIT_MINER_NAME, "bob", ASSET( "10000.000 TESTS" ) );
+      vest( freezone_INIT_MINER_NAME, "sam", ASSET( "10000.000 TESTS" ) );
+      generate_block();
+
+      post( "alice", alice_post_key, "alice-1" );
+      generate_block();
+
+      // The votes of the comment resolved from the database, to compare the cached votes with
+      auto expected_votes = [&]()
+      {
+         vector< vote_state > votes;
+         const auto& comment = db->get_comment( "alice", string( "alice-1" ) );
+         const auto& idx = db->get_index< comment_vote_index, by_comment_symbol_voter >();
+         auto itr = idx.lower_bound( boost::make_tuple( comment.id, freezone_SYMBOL ) );
+         for( ; itr != idx.end() && itr->comment == comment.id && itr->symbol == freezone_SYMBOL; ++itr )
+         {
+            vote_state vstate;
+            vstate.voter = db->get( itr->voter ).name;
+            vstate.rshares = itr->rshares;
+            vstate.percent = itr->vote_percent;
+            votes.push_back( vstate );
+         }
+         return votes;
+      };
+
+      auto require_consistent = [&]( const vector< vote_state >& votes )
+      {
+         auto expected = expected_votes();
+         BOOST_REQUIRE( votes.size() == expected.size() );
+         for( size_t i = 0; i < votes.size(); ++i )
+         {
+            BOOST_REQUIRE( votes[i].voter == expected[i].voter );
+            BOOST_REQUIRE( votes[i].rshares == expected[i].rshares );
+            BOOST_REQUIRE( votes[i].percent == expected[i].percent );
+         }
+
+         get_discussion_args args;
+         args.author = "alice";
+         args.permlink = "alice-1";
+         auto discussion = api->get_discussion( args );
+         BOOST_REQUIRE( discussion.active_votes.size() == votes.size() );
+      };
+
+      get_active_votes_args args;
+      args.author = "alice";
+      args.permlink = "alice-1";
+
+      BOOST_TEST_MESSAGE( "--- Test the votes are cached when requested" );
+      vote( "bob", bob_post_key, "alice", "alice-1", freezone_100_PERCENT );
+      generate_block();
+
+      auto hits = api->active_votes_cache_hits();
+      auto votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( votes.size() == 1 );
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits );
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits + 1 );
+      require_consistent( votes );
+
+      BOOST_TEST_MESSAGE( "--- Test a new vote is added to the cached votes" );
+      vote( "sam", sam_post_key, "alice", "alice-1", freezone_100_PERCENT / 2 );
+      hits = api->active_votes_cache_hits();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits + 1 );
+      BOOST_REQUIRE( votes.size() == 2 );
+      require_consistent( votes );
+      generate_block();
+
+      BOOST_TEST_MESSAGE( "--- Test a changed vote is updated in the cached votes" );
+      generate_blocks( db->head_block_time() + freezone_MIN_VOTE_INTERVAL_SEC );
+      api->get_active_votes( args );
+      vote( "bob", bob_post_key, "alice", "alice-1", freezone_100_PERCENT / 4 );
+      hits = api->active_votes_cache_hits();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits + 1 );
+      require_consistent( votes );
+      generate_block();
+
+      BOOST_TEST_MESSAGE( "--- Test the cached reputations of voters follow their changes" );
+      post( "bob", bob_post_key, "bob-1" );
+      generate_block();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( votes[0].voter == "bob" );
+      BOOST_REQUIRE( votes[0].reputation == 0 );
+
+      vote( "sam", sam_post_key, "bob", "bob-1", freezone_100_PERCENT );
+      generate_block();
+      votes = api->get_active_votes( args ).votes;
+      const auto& bob_reputation = db->get< freezone::plugins::follow::reputation_object, freezone::plugins::follow::by_account >( account_name_type( "bob" ) );
+      BOOST_REQUIRE( bob_reputation.reputation > 0 );
+      BOOST_REQUIRE( votes[0].reputation == bob_reputation.reputation );
+
+      BOOST_TEST_MESSAGE( "--- Test votes undone by popping a block are not returned from the cache" );
+      generate_blocks( db->head_block_time() + freezone_MIN_VOTE_INTERVAL_SEC );
+      vote( "sam", sam_post_key, "alice", "alice-1", -freezone_100_PERCENT );
+      generate_block();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( votes.size() == 2 );
+      BOOST_REQUIRE( votes[1].percent == -freezone_100_PERCENT );
+
+      db->pop_block();
+      db->clear_pending();
+      hits = api->active_votes_cache_hits();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits );
+      BOOST_REQUIRE( votes[1].percent == freezone_100_PERCENT / 2 );
+      require_consistent( votes );
+
+      BOOST_TEST_MESSAGE( "--- Test votes on a stale entry are not applied in place" );
+      vote( "sam", sam_post_key, "alice", "alice-1", -freezone_100_PERCENT );
+      generate_block();
+      db->pop_block();
+      db->clear_pending();
+      vote( "sam", sam_post_key, "alice", "alice-1", freezone_100_PERCENT / 4 );
+      hits = api->active_votes_cache_hits();
+      votes = api->get_active_votes( args ).votes;
+      BOOST_REQUIRE( api->active_votes_cache_hits() == hits );
+      BOOST_REQUIRE( votes[1].percent == freezone_100_PERCENT / 4 );
+      require_consistent( votes );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
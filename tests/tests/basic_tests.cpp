@@ -30,10 +30,15 @@
 #include <freezone/protocol/protocol.hpp>
 
 #include <freezone/protocol/freezone_operations.hpp>
+#include <freezone/protocol/transaction_util.hpp>
 #include <freezone/chain/account_object.hpp>
+#include <freezone/chain/blob_store.hpp>
+#include <freezone/chain/shared_sign_state.hpp>
 
 #include <freezone/chain/util/reward.hpp>
 
+#include <freezone/utilities/tempdir.hpp>
+
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/hex.hpp>
 #include "../db_fixture/database_fixture.hpp"
@@ -430,4 +435,269 @@ BOOST_AUTO_TEST_CASE( curation_weight_test )
 
 }
 
+BOOST_AUTO_TEST_CASE( blob_store_test )
+{
+   try
+   {
+      fc::temp_directory dir( freezone::utilities::temp_directory_path() );
+      fc::path file = dir.path() / "test.blob";
+
+      blob_store store;
+      store.open( file );
+      store.set_cache_size( 1024 );
+
+      std::string first = "first blob";
+      std::string second = "second blob";
+      // Larger than the initial file, forcing the store to grow and remap
+      std::string large( 20 * 1024 * 1024, 'x' );
+
+      auto first_offset = store.append( first );
+      auto second_offset = store.append( second );
+      auto large_offset = store.append( large );
+      auto empty_offset = store.append( std::string() );
+
+      BOOST_REQUIRE_EQUAL( second_offset, first_offset + first.size() );
+      BOOST_REQUIRE_EQUAL( large_offset, second_offset + second.size() );
+      BOOST_REQUIRE_EQUAL( store.size(), empty_offset );
+
+      BOOST_REQUIRE_EQUAL( store.read( first_offset, first.size() ), first );
+      BOOST_REQUIRE_EQUAL( store.read( second_offset, second.size() ), second );
+      BOOST_REQUIRE( store.read( large_offset, large.size() ) == large );
+      // Cached reads return the same value
+      BOOST_REQUIRE_EQUAL( store.read( first_offset, first.size() ), first );
+
+      freezone_REQUIRE_THROW( store.read( store.size(), 1 ), fc::exception );
+
+      store.close();
+      store.open( file );
+
+      BOOST_REQUIRE_EQUAL( store.size(), empty_offset );
+      BOOST_REQUIRE_EQUAL( store.read( second_offset, second.size() ), second );
+      BOOST_REQUIRE_EQUAL( store.append( first ), empty_offset );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( operation_subscriptions )
+{
+   try
+   {
+      ACTORS( (alice)(bob) )
+      fund( "alice", 10000 );
+      vest( freezone_INIT_MINER_NAME, "alice", ASSET( "10.000 TESTS" ) );
+
+      std::vector< std::string > calls;
+      auto first = db->subscribe_post_apply_operation< transfer_operation >(
+         [&]( const operation_notification& note ){ calls.push_back( "first" ); }, *db_plugin, 1 );
+      auto second = db->subscribe_post_apply_operation< transfer_operation, transfer_operation >(
+         [&]( const operation_notification& note ){ calls.push_back( "second" ); }, *db_plugin, 0 );
+
+      BOOST_TEST_MESSAGE( "--- Test handlers are only called for their operation types, in group order" );
+      transfer( "alice", "bob", ASSET( "1.000 TESTS" ) );
+      vest( "alice", "alice", ASSET( "1.000 TESTS" ) );
+      BOOST_REQUIRE_EQUAL( calls.size(), 2u );
+      BOOST_CHECK_EQUAL( calls[0], "second" );
+      BOOST_CHECK_EQUAL( calls[1], "first" );
+
+      BOOST_TEST_MESSAGE( "--- Test disconnected handlers are not called" );
+      freezone::chain::util::disconnect_signal( second );
+      BOOST_CHECK( first.connected() );
+      calls.clear();
+      transfer( "alice", "bob", ASSET( "1.000 TESTS" ) );
+      BOOST_REQUIRE_EQUAL( calls.size(), 1u );
+      BOOST_CHECK_EQUAL( calls[0], "first" );
+
+      first.disconnect();
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( block_arena_test )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "--- Test containers allocate from the arena and chunks are reused after a reset" );
+      freezone::chain::util::block_arena arena( 4096 );
+      {
+         freezone::chain::util::block_vector< uint64_t > v( arena );
+         for( uint64_t i = 0; i < 200; ++i )
+            v.push_back( i );
+
+         freezone::chain::util::block_flat_set< std::string > names( arena );
+         names.insert( "bob" );
+         names.insert( "alice" );
+         names.insert( "bob" );
+
+         for( uint64_t i = 0; i < v.size(); ++i )
+            BOOST_CHECK_EQUAL( v[i], i );
+         BOOST_REQUIRE_EQUAL( names.size(), 2u );
+         BOOST_CHECK_EQUAL( *names.begin(), "alice" );
+      }
+
+      auto stats = arena.get_statistics();
+      BOOST_CHECK_GT( stats.allocations, 0u );
+      BOOST_CHECK_GT( stats.chunk_allocations, 1u );
+      BOOST_CHECK_EQUAL( stats.peak_block_bytes, stats.bytes );
+
+      arena.reset();
+      auto chunks = stats.chunk_allocations;
+      {
+         freezone::chain::util::block_vector< char > small( arena );
+         small.resize( 100 );
+      }
+      BOOST_CHECK_EQUAL( arena.get_statistics().chunk_allocations, chunks );
+
+      BOOST_TEST_MESSAGE( "--- Test the database resets its arena once a block is applied" );
+      generate_block();
+      {
+         freezone::chain::util::block_vector< uint32_t > v( db->get_block_arena() );
+         v.resize( 10 );
+      }
+      BOOST_CHECK_GT( db->get_block_arena().get_statistics().allocations, 0u );
+      generate_blocks( freezone_MAX_WITNESSES );
+      auto warm = db->get_block_arena().get_statistics();
+      BOOST_CHECK_GT( warm.peak_block_bytes, 0u );
+
+      BOOST_TEST_MESSAGE( "--- Test later blocks reuse the chunks of the database arena" );
+      generate_blocks( freezone_MAX_WITNESSES );
+      auto after = db->get_block_arena().get_statistics();
+      BOOST_CHECK_GT( after.allocations, warm.allocations );
+      BOOST_CHECK_EQUAL( after.chunk_allocations, warm.chunk_allocations );
+
+      BOOST_TEST_MESSAGE( "--- Test a pending transaction checks its signatures on the arena and releases it" );
+      ACTORS( (alice) )
+      fund( "alice", 10000 );
+      auto before = db->get_block_arena().get_statistics();
+      for( int i = 0; i < 20; ++i )
+      {
+         transfer_operation op;
+         op.from = "alice";
+         op.to = freezone_INIT_MINER_NAME;
+         op.amount = ASSET( "0.001 TESTS" );
+         op.memo = fc::to_string( i );
+
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         sign( tx, alice_private_key );
+         db->push_transaction( tx, 0 );
+      }
+      auto pending = db->get_block_arena().get_statistics();
+      BOOST_CHECK_GT( pending.allocations, before.allocations );
+      BOOST_CHECK_EQUAL( pending.chunk_allocations, before.chunk_allocations );
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( shared_sign_state_test )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "--- Test authorities checked in place match protocol::verify_authority" );
+      ACTORS( (alice)(bob)(sam) )
+
+      db->modify( db->get< account_authority_object, by_account >( "alice" ), [&]( account_authority_object& a )
+      {
+         a.active = authority( 2, alice_public_key, 1, "bob", 1 );
+      });
+      db->modify( db->get< account_authority_object, by_account >( "sam" ), [&]( account_authority_object& a )
+      {
+         a.active = authority( 2, "alice", 1, "bob", 1 );
+      });
+
+      shared_authority_getter get_active  = [&]( const account_name_type& name ) -> const shared_authority& { return db->get< account_authority_object, by_account >( name ).active; };
+      shared_authority_getter get_owner   = [&]( const account_name_type& name ) -> const shared_authority& { return db->get< account_authority_object, by_account >( name ).owner; };
+      shared_authority_getter get_posting = [&]( const account_name_type& name ) -> const shared_authority& { return db->get< account_authority_object, by_account >( name ).posting; };
+      auto copy_active  = [&]( const string& name ) { return authority( get_active( name ) ); };
+      auto copy_owner   = [&]( const string& name ) { return authority( get_owner( name ) ); };
+      auto copy_posting = [&]( const string& name ) { return authority( get_posting( name ) ); };
+
+      auto result_of = []( std::function< void() > verify ) -> int64_t
+      {
+         try
+         {
+            verify();
+         }
+         catch( const fc::exception& e )
+         {
+            return e.code();
+         }
+         return 0;
+      };
+
+      transfer_operation transfer;
+      transfer.from = "sam";
+      transfer.to = "bob";
+      transfer.amount = ASSET( "1.000 TESTS" );
+
+      vote_operation vote;
+      vote.voter = "alice";
+      vote.author = "bob";
+      vote.permlink = "test";
+      vote.weight = freezone_100_PERCENT;
+
+      vector< vector< operation > > op_sets = { { transfer }, { vote } };
+      vector< flat_set< public_key_type > > key_sets = {
+         { alice_public_key },
+         { bob_public_key },
+         { alice_public_key, bob_public_key },
+         { alice_public_key, bob_public_key, sam_public_key },
+         { sam_public_key },
+         { alice_post_key.get_public_key() }
+      };
+
+      freezone::chain::util::block_arena arena;
+
+      for( const auto& ops : op_sets )
+      {
+         for( const auto& keys : key_sets )
+         {
+            freezone::chain::util::block_flat_set< public_key_type > arena_keys( arena );
+            arena_keys.insert( keys.begin(), keys.end() );
+
+            for( uint32_t max_account_auths : { 0u, 1u, 2u, 8u } )
+            {
+               int64_t expected = result_of( [&]()
+               {
+                  freezone::protocol::verify_authority( ops, keys, copy_active, copy_owner, copy_posting,
+                     freezone_MAX_SIG_CHECK_DEPTH, freezone_MAX_AUTHORITY_MEMBERSHIP, max_account_auths );
+               });
+               int64_t actual = result_of( [&]()
+               {
+                  verify_shared_authority( ops, keys, get_active, get_owner, get_posting, arena,
+                     freezone_MAX_SIG_CHECK_DEPTH, freezone_MAX_AUTHORITY_MEMBERSHIP, max_account_auths );
+               });
+               BOOST_CHECK_EQUAL( actual, expected );
+               int64_t actual_from_arena = result_of( [&]()
+               {
+                  verify_shared_authority( ops, arena_keys, get_active, get_owner, get_posting, arena,
+                     freezone_MAX_SIG_CHECK_DEPTH, freezone_MAX_AUTHORITY_MEMBERSHIP, max_account_auths );
+               });
+               BOOST_CHECK_EQUAL( actual_from_arena, expected );
+            }
+         }
+      }
+
+      BOOST_TEST_MESSAGE( "--- Test an account satisfied once is not evaluated again" );
+      uint32_t lookups = 0;
+      shared_authority_getter counting_active = [&]( const account_name_type& name ) -> const shared_authority&
+      {
+         ++lookups;
+         return get_active( name );
+      };
+      flat_set< public_key_type > signing_keys = { alice_public_key, bob_public_key };
+      shared_sign_state s( signing_keys, counting_active, arena );
+      BOOST_REQUIRE( s.check_authority( account_name_type( "sam" ) ) );
+      BOOST_CHECK_EQUAL( lookups, 3u );
+      BOOST_REQUIRE( s.check_authority( get_active( "sam" ) ) );
+      BOOST_CHECK_EQUAL( lookups, 3u );
+      BOOST_CHECK( !s.remove_unused_signatures() );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -35,6 +35,9 @@
 #include <freezone/plugins/account_history/account_history_plugin.hpp>
 #include <freezone/plugins/witness/block_producer.hpp>
 
+#include <graphene/net/core_messages.hpp>
+#include <graphene/net/message.hpp>
+
 #include <freezone/utilities/tempdir.hpp>
 #include <freezone/utilities/database_configuration.hpp>
 
@@ -51,7 +54,7 @@ using namespace freezone::plugins;
 
 BOOST_AUTO_TEST_SUITE(block_tests)
 
-void open_test_database( database& db, const fc::path& dir )
+void open_test_database( database& db, const fc::path& dir, bool comment_body_store = false, bool compact_comment_body_store = false )
 {
    database::open_args args;
    args.data_dir = dir;
@@ -60,6 +63,8 @@ void open_test_database( database& db, const fc::path& dir )
    args.sbd_initial_supply = SBD_INITIAL_TEST_SUPPLY;
    args.shared_file_size = TEST_SHARED_MEM_SIZE;
    args.database_cfg = freezone::utilities::default_database_configuration();
+   args.comment_body_store = comment_body_store;
+   args.compact_comment_body_store = compact_comment_body_store;
    db.open( args );
 }
 
@@ -314,6 +319,126 @@ BOOST_AUTO_TEST_CASE( switch_forks_undo_create )
    }
 }
 
+BOOST_AUTO_TEST_CASE( comment_body_store_undo_and_switch_forks )
+{
+   try {
+      fc::temp_directory dir1( freezone::utilities::temp_directory_path() ),
+                         dir2( freezone::utilities::temp_directory_path() );
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")) );
+
+      auto comment_trx = [&]( database& db, const string& body )
+      {
+         signed_transaction trx;
+         comment_operation op;
+         op.author = freezone_INIT_MINER_NAME;
+         op.permlink = "test";
+         op.parent_permlink = "test";
+         op.title = "foo";
+         op.body = body;
+         trx.operations.push_back( op );
+         trx.set_expiration( db.head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         trx.sign( init_account_priv_key, db.get_chain_id(), fc::ecc::fc_canonical );
+         return trx;
+      };
+
+      auto comment_body = []( const database& db )
+      {
+         const auto& comment = db.get_comment( freezone_INIT_MINER_NAME, string( "test" ) );
+         return db.get_comment_body( db.get< comment_content_object, by_comment >( comment.id ) );
+      };
+
+      uint32_t fork_block_num = 0;
+      {
+         database db1,
+                  db2;
+         witness::block_producer bp1( db1 ),
+                                 bp2( db2 );
+         db1._log_hardforks = false;
+         open_test_database( db1, dir1.path(), true );
+         db2._log_hardforks = false;
+         open_test_database( db2, dir2.path(), true );
+
+         BOOST_TEST_MESSAGE( "--- Test bodies are written to the store" );
+         BOOST_REQUIRE( !db1.has_comment_body_store_bodies() );
+         PUSH_TX( db1, comment_trx( db1, "original" ) );
+         auto b = bp1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         PUSH_BLOCK( db2, b );
+
+         BOOST_REQUIRE( db1.has_comment_body_store_bodies() );
+         BOOST_REQUIRE( db2.has_comment_body_store_bodies() );
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "original" );
+         BOOST_REQUIRE_EQUAL( comment_body( db2 ), "original" );
+         const auto& comment = db1.get_comment( freezone_INIT_MINER_NAME, string( "test" ) );
+         const auto& content = db1.get< comment_content_object, by_comment >( comment.id );
+         BOOST_REQUIRE( content.body.size() == 0 );
+
+         BOOST_TEST_MESSAGE( "--- Test undoing an edit restores the previous body" );
+         PUSH_TX( db1, comment_trx( db1, "pending edit" ) );
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "pending edit" );
+         db1.clear_pending();
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "original" );
+
+         BOOST_TEST_MESSAGE( "--- Test reapplying a transaction reuses the body already in the store" );
+         PUSH_TX( db1, comment_trx( db1, "reapplied edit" ) );
+         uint64_t pending_offset = content.body_blob_offset;
+         db1.clear_pending();
+         PUSH_TX( db1, comment_trx( db1, "reapplied edit" ) );
+         BOOST_REQUIRE_EQUAL( content.body_blob_offset, pending_offset );
+         db1.clear_pending();
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "original" );
+
+         {
+            auto session = db1.start_undo_session();
+            db1.modify( content, [&]( comment_content_object& c )
+            {
+               db1.set_comment_body( c, "undone edit" );
+            });
+            BOOST_REQUIRE_EQUAL( comment_body( db1 ), "undone edit" );
+            session.undo();
+         }
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "original" );
+
+         BOOST_TEST_MESSAGE( "--- Test switching forks restores the body of the new fork" );
+         // db1 : A
+         // db2 : B C
+         PUSH_TX( db1, comment_trx( db1, "fork a" ) );
+         bp1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "fork a" );
+
+         PUSH_TX( db2, comment_trx( db2, "fork b" ) );
+         b = bp2.generate_block( db2.get_slot_time(1), db2.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         fork_block_num = b.block_num();
+         PUSH_BLOCK( db1, b );
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "fork a" );
+
+         b = bp2.generate_block( db2.get_slot_time(1), db2.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         PUSH_BLOCK( db1, b );
+         BOOST_REQUIRE( db1.head_block_id() == db2.head_block_id() );
+
+         // The edit of the abandoned fork is put back in the pending state
+         db1.clear_pending();
+         BOOST_REQUIRE_EQUAL( comment_body( db1 ), "fork b" );
+         BOOST_REQUIRE_EQUAL( comment_body( db2 ), "fork b" );
+
+         while( db1.get_dynamic_global_properties().last_irreversible_block_num < fork_block_num )
+            bp1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+
+         db1.close();
+      }
+
+      BOOST_TEST_MESSAGE( "--- Test compacting the store keeps the referenced bodies" );
+      {
+         database db;
+         db._log_hardforks = false;
+         open_test_database( db, dir1.path(), true, true );
+
+         BOOST_REQUIRE( db.has_comment_body_store_bodies() );
+         BOOST_REQUIRE_EQUAL( comment_body( db ), "fork b" );
+      }
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( duplicate_transactions )
 {
    try {
@@ -369,6 +494,220 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
    }
 }
 
+BOOST_AUTO_TEST_CASE( prevalidated_blocks )
+{
+   try {
+      fc::temp_directory dir1( freezone::utilities::temp_directory_path() ),
+                         dir2( freezone::utilities::temp_directory_path() );
+      database db1,
+               db2;
+      witness::block_producer bp1( db1 );
+      db1._log_hardforks = false;
+      open_test_database( db1, dir1.path() );
+      db2._log_hardforks = false;
+      open_test_database( db2, dir2.path() );
+
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")) );
+      public_key_type init_account_pub_key  = init_account_priv_key.get_public_key();
+
+      signed_transaction trx;
+      account_create_operation cop;
+      cop.new_account_name = "alice";
+      cop.creator = freezone_INIT_MINER_NAME;
+      cop.owner = authority(1, init_account_pub_key, 1);
+      cop.active = cop.owner;
+      trx.operations.push_back(cop);
+      trx.set_expiration( db1.head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      trx.sign( init_account_priv_key, db1.get_chain_id(), fc::ecc::bip_0062 );
+      PUSH_TX( db1, trx );
+
+      auto b = bp1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness( 1 ), init_account_priv_key, database::skip_nothing );
+
+      auto prevalidated = prevalidate_block( b, db2.get_chain_id(), true );
+      BOOST_REQUIRE( prevalidated.signee.valid() );
+      BOOST_REQUIRE_EQUAL( prevalidated.signature_keys.size(), 1u );
+      BOOST_REQUIRE( prevalidated.signature_keys[0].valid() );
+      BOOST_CHECK( prevalidated.block_id == b.id() );
+      BOOST_CHECK( prevalidated.merkle_root == b.transaction_merkle_root );
+      BOOST_CHECK_EQUAL( prevalidated.block_size, fc::raw::pack_size( b ) );
+      BOOST_CHECK( *prevalidated.signee == public_key_type( init_account_pub_key ) );
+      BOOST_REQUIRE( prevalidated.packed_block );
+      BOOST_CHECK( *prevalidated.packed_block == fc::raw::pack_to_vector( b ) );
+      BOOST_REQUIRE_EQUAL( prevalidated.transaction_ids.size(), 1u );
+      BOOST_CHECK( prevalidated.transaction_ids[0] == b.transactions[0].id() );
+      BOOST_REQUIRE_EQUAL( prevalidated.packed_transactions.size(), 1u );
+      BOOST_CHECK( std::vector< char >( prevalidated.packed_block->begin() + prevalidated.packed_transactions[0].first,
+         prevalidated.packed_block->begin() + prevalidated.packed_transactions[0].first + prevalidated.packed_transactions[0].second )
+         == fc::raw::pack_to_vector( b.transactions[0] ) );
+      BOOST_CHECK( *prevalidated.signature_keys[0] == b.transactions[0].get_signature_keys( db2.get_chain_id(), fc::ecc::bip_0062 ) );
+
+      BOOST_TEST_MESSAGE( "--- Test prevalidated results that do not match the chain are rejected" );
+      auto bad_signee = prevalidated;
+      bad_signee.signee = public_key_type( fc::ecc::private_key::regenerate( fc::sha256::hash( string( "bad_key" ) ) ).get_public_key() );
+      freezone_REQUIRE_THROW( db2.push_block( b, database::skip_nothing, &bad_signee ), fc::exception );
+
+      auto bad_keys = prevalidated;
+      bad_keys.signature_keys[0] = flat_set< public_key_type >();
+      freezone_REQUIRE_THROW( db2.push_block( b, database::skip_nothing, &bad_keys ), fc::exception );
+      BOOST_REQUIRE_EQUAL( db2.head_block_num(), 0u );
+
+      BOOST_TEST_MESSAGE( "--- Test prevalidated block is applied" );
+      db2.push_block( b, database::skip_nothing, &prevalidated );
+      BOOST_CHECK( db2.head_block_id() == b.id() );
+      BOOST_CHECK( db2.find_account( "alice" ) != nullptr );
+      BOOST_CHECK( db2.is_known_transaction( b.transactions[0].id() ) );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( batch_signature_key_recovery )
+{
+   try {
+      chain_id_type chain_id = fc::sha256::hash( string( "batch_signature_key_recovery" ) );
+      vector< fc::ecc::private_key > keys;
+      for( int i = 0; i < 5; ++i )
+         keys.push_back( fc::ecc::private_key::regenerate( fc::sha256::hash( "key" + std::to_string( i ) ) ) );
+
+      vector< signed_transaction > trxs;
+      for( uint32_t i = 0; i < 20; ++i )
+      {
+         signed_transaction trx;
+         trx.ref_block_num = i;
+         trx.set_expiration( fc::time_point_sec( 1500000000 + i ) );
+         transfer_operation op;
+         op.from = "alice";
+         op.to = "bob";
+         op.amount = asset( i, freezone_SYMBOL );
+         trx.operations.push_back( op );
+
+         for( uint32_t k = 0; k <= i % keys.size(); ++k )
+            trx.sign( keys[k], chain_id, fc::ecc::bip_0062 );
+
+         trxs.push_back( trx );
+      }
+
+      BOOST_TEST_MESSAGE( "--- Test a duplicate and an unrecoverable signature leave their transaction empty" );
+      trxs[3].signatures.push_back( trxs[3].signatures[0] );
+      trxs[7].signatures[1].data[0] = 0;
+      trxs.push_back( signed_transaction() );
+
+      util::worker_pool pool( 2 );
+
+      for( uint32_t helpers : { 0, 2 } )
+      {
+         auto recovered = signed_transaction::get_signature_keys( trxs, chain_id, fc::ecc::bip_0062, pool.poster(), helpers );
+         BOOST_REQUIRE_EQUAL( recovered.size(), trxs.size() );
+
+         for( size_t i = 0; i < trxs.size(); ++i )
+         {
+            if( i == 3 || i == 7 )
+            {
+               BOOST_CHECK( !recovered[i].valid() );
+               freezone_REQUIRE_THROW( trxs[i].get_signature_keys( chain_id, fc::ecc::bip_0062 ), fc::exception );
+            }
+            else
+            {
+               BOOST_REQUIRE( recovered[i].valid() );
+               BOOST_CHECK( *recovered[i] == trxs[i].get_signature_keys( chain_id, fc::ecc::bip_0062 ) );
+            }
+         }
+      }
+
+      trxs.pop_back();
+      signed_block b;
+      b.transactions = trxs;
+      auto prevalidated = prevalidate_block( b, chain_id, true, pool.poster(), pool.size() );
+      auto recovered = signed_transaction::get_signature_keys( trxs, chain_id, fc::ecc::non_canonical );
+      BOOST_REQUIRE_EQUAL( prevalidated.signature_keys.size(), recovered.size() );
+      for( size_t i = 0; i < recovered.size(); ++i )
+         BOOST_CHECK( prevalidated.signature_keys[i] == recovered[i] );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( compact_block_reconstruction )
+{
+   try {
+      chain_id_type chain_id = fc::sha256::hash( string( "compact_block_reconstruction" ) );
+      auto key = fc::ecc::private_key::regenerate( fc::sha256::hash( string( "key" ) ) );
+
+      signed_block b;
+      for( uint32_t i = 0; i < 10; ++i )
+      {
+         signed_transaction trx;
+         trx.ref_block_num = i;
+         trx.set_expiration( fc::time_point_sec( 1500000000 + i ) );
+         transfer_operation op;
+         op.from = "alice";
+         op.to = "bob";
+         op.amount = asset( i, freezone_SYMBOL );
+         trx.operations.push_back( op );
+         trx.sign( key, chain_id, fc::ecc::bip_0062 );
+         b.transactions.push_back( trx );
+      }
+      b.transaction_merkle_root = b.calculate_merkle_root();
+
+      graphene::net::block_message full_block( b );
+      graphene::net::item_hash_t item_hash = graphene::net::message( full_block ).id();
+
+      BOOST_TEST_MESSAGE( "--- Test transactions the peer is unlikely to know are prefilled" );
+      auto compact_block = graphene::net::make_compact_block_message( full_block, item_hash,
+         [&]( const transaction_id_type& id ) { return id != b.transactions[0].id() && id != b.transactions[5].id(); } );
+
+      BOOST_CHECK( compact_block.item_hash == item_hash );
+      BOOST_CHECK( compact_block.block_id == full_block.block_id );
+      BOOST_REQUIRE_EQUAL( compact_block.short_transaction_ids.size(), b.transactions.size() );
+      BOOST_REQUIRE_EQUAL( compact_block.prefilled_transactions.size(), 2u );
+      BOOST_CHECK_EQUAL( compact_block.prefilled_transactions[0].index, 0u );
+      BOOST_CHECK_EQUAL( compact_block.prefilled_transactions[1].index, 5u );
+      BOOST_CHECK( compact_block.prefilled_transactions[1].trx.id() == b.transactions[5].id() );
+
+      BOOST_TEST_MESSAGE( "--- Test a block rebuilds from prefilled, known and fetched transactions" );
+      std::map< uint64_t, signed_transaction > known;
+      for( uint32_t i = 0; i < b.transactions.size(); ++i )
+         if( i != 7 )
+            known[ graphene::net::get_short_transaction_id( b.transactions[i].id() ) ] = b.transactions[i];
+
+      vector< fc::optional< signed_transaction > > transactions( compact_block.short_transaction_ids.size() );
+      for( const auto& prefilled : compact_block.prefilled_transactions )
+         transactions[ prefilled.index ] = prefilled.trx;
+      for( uint32_t i = 0; i < transactions.size(); ++i )
+      {
+         auto itr = known.find( compact_block.short_transaction_ids[i] );
+         if( !transactions[i] && itr != known.end() )
+            transactions[i] = itr->second;
+      }
+
+      vector< uint32_t > missing;
+      for( uint32_t i = 0; i < transactions.size(); ++i )
+         if( !transactions[i] )
+            missing.push_back( i );
+      BOOST_REQUIRE_EQUAL( missing.size(), 1u );
+      BOOST_CHECK_EQUAL( missing[0], 7u );
+
+      auto incomplete = transactions;
+      freezone_REQUIRE_THROW( graphene::net::reconstruct_compact_block( compact_block, std::move( incomplete ) ), fc::exception );
+
+      for( uint32_t index : missing )
+         transactions[ index ] = b.transactions[ index ];
+      auto swapped = transactions;
+
+      auto rebuilt = graphene::net::reconstruct_compact_block( compact_block, std::move( transactions ) );
+      BOOST_REQUIRE( rebuilt.valid() );
+      BOOST_CHECK( rebuilt->block_id == full_block.block_id );
+      BOOST_CHECK( graphene::net::message( *rebuilt ).id() == item_hash );
+
+      BOOST_TEST_MESSAGE( "--- Test transactions that don't match the merkle root are rejected" );
+      std::swap( swapped[1], swapped[2] );
+      BOOST_CHECK( !graphene::net::reconstruct_compact_block( compact_block, std::move( swapped ) ).valid() );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( tapos )
 {
    try {
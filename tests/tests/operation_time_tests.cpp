@@ -2478,5 +2478,253 @@ BOOST_AUTO_TEST_CASE( account_subsidy_witness_limits )
    FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( comment_permlink_hash_lookup )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "Testing: comment_permlink_hash_lookup" );
+
+      ACTORS( (alice)(bob) )
+      generate_blocks( 60 / freezone_BLOCK_INTERVAL );
+      vest( freezone_INIT_MINER_NAME, "bob", ASSET( "10.000 TESTS" ) );
+
+      comment_operation op;
+      op.author = "alice";
+      op.permlink = "lorem";
+      op.parent_author = "";
+      op.parent_permlink = "ipsum";
+      op.title = "Lorem Ipsum";
+      op.body = "Lorem ipsum dolor sit amet";
+
+      signed_transaction tx;
+      tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      tx.operations.push_back( op );
+      sign( tx, alice_private_key );
+      db->push_transaction( tx, 0 );
+      generate_block();
+
+      const auto& lorem = db->get_comment( "alice", string( "lorem" ) );
+      BOOST_REQUIRE( lorem.permlink_hash == hash_permlink( string( "lorem" ) ) );
+
+      BOOST_TEST_MESSAGE( "--- Test a hash collision is resolved by the full permlink" );
+      db_plugin->debug_update( [=]( database& db )
+      {
+         db.create< comment_object >( [&]( comment_object& c )
+         {
+            c.author = "alice";
+            from_string( c.permlink, "collision" );
+            c.permlink_hash = hash_permlink( string( "lorem" ) );
+            c.cashout_time = fc::time_point_sec::maximum();
+            c.root_comment = c.id;
+         });
+      });
+
+      BOOST_REQUIRE( db->get_comment( "alice", string( "lorem" ) ).id == lorem.id );
+      BOOST_REQUIRE( db->find_comment( "alice", string( "collisio" ) ) == nullptr );
+      BOOST_REQUIRE( db->find_comment( "bob", string( "lorem" ) ) == nullptr );
+      freezone_REQUIRE_THROW( db->get_comment( "alice", string( "ipsum" ) ), fc::exception );
+
+      BOOST_TEST_MESSAGE( "--- Test the evaluators find the comment" );
+      vote_operation vote;
+      vote.voter = "bob";
+      vote.author = "alice";
+      vote.permlink = "lorem";
+      vote.weight = freezone_100_PERCENT;
+      tx.clear();
+      tx.operations.push_back( vote );
+      sign( tx, bob_private_key );
+      db->push_transaction( tx, 0 );
+
+      BOOST_REQUIRE( db->get_comment( "alice", string( "lorem" ) ).net_votes == 1 );
+
+      op.body = "Lorem ipsum dolor sit amet, consectetur adipiscing elit";
+      tx.clear();
+      tx.operations.push_back( op );
+      sign( tx, alice_private_key );
+      db->push_transaction( tx, 0 );
+
+      BOOST_REQUIRE( db->get_comment( "alice", string( "lorem" ) ).last_update == db->head_block_time() );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( comment_payout_parallel_replay )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "Testing: comment_payout_parallel_replay" );
+
+      const uint32_t num_authors = 24;
+      const uint32_t num_voters = 4;
+
+      std::vector< std::string > authors;
+      std::vector< std::string > voters;
+
+      for( uint32_t i = 0; i < num_authors; ++i )
+      {
+         authors.push_back( "author" + fc::to_string( i ) );
+         account_create( authors.back(), generate_private_key( authors.back() ).get_public_key(), generate_private_key( authors.back() + "_post" ).get_public_key() );
+      }
+
+      for( uint32_t i = 0; i < num_voters; ++i )
+      {
+         voters.push_back( "voter" + fc::to_string( i ) );
+         account_create( voters.back(), generate_private_key( voters.back() ).get_public_key(), generate_private_key( voters.back() + "_post" ).get_public_key() );
+         fund( voters.back(), 10000 );
+         vest( voters.back(), 10000 * ( i + 1 ) );
+      }
+
+      set_price_feed( price( ASSET( "1.000 TBD" ), ASSET( "1.000 TESTS" ) ) );
+      generate_block();
+
+      for( const auto& author : authors )
+      {
+         comment_operation com;
+         com.author = author;
+         com.permlink = "mypost";
+         com.parent_author = freezone_ROOT_POST_PARENT;
+         com.parent_permlink = "test";
+         com.title = "Hello from " + author;
+         com.body = "Hello, my name is " + author;
+
+         signed_transaction tx;
+         tx.operations.push_back( com );
+         tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         sign( tx, generate_private_key( author ) );
+         db->push_transaction( tx, 0 );
+      }
+
+      generate_block();
+
+      // Voters can only vote once per block, each round every voter votes on a different post
+      for( uint32_t round = 0; round < num_authors; ++round )
+      {
+         for( uint32_t v = 0; v < num_voters; ++v )
+         {
+            vote_operation vote;
+            vote.voter = voters[ v ];
+            vote.author = authors[ ( round + v * 5 ) % num_authors ];
+            vote.permlink = "mypost";
+            vote.weight = freezone_100_PERCENT - v * freezone_1_PERCENT * 10;
+
+            signed_transaction tx;
+            tx.operations.push_back( vote );
+            tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+            sign( tx, generate_private_key( voters[ v ] ) );
+            db->push_transaction( tx, 0 );
+         }
+
+         generate_block();
+      }
+
+      auto packed_state = [&]()
+      {
+         std::vector< char > state;
+         auto append = [&]( const std::vector< char >& bytes ) { state.insert( state.end(), bytes.begin(), bytes.end() ); };
+
+         const auto& account_idx = db->get_index< account_index, by_id >();
+         for( auto itr = account_idx.begin(); itr != account_idx.end(); ++itr )
+            append( fc::raw::pack_to_vector( *itr ) );
+
+         for( const auto& author : authors )
+         {
+            const auto& comment = db->get_comment( author, string( "mypost" ) );
+            append( fc::raw::pack_to_vector( comment.total_payout_value ) );
+            append( fc::raw::pack_to_vector( comment.curator_payout_value ) );
+            append( fc::raw::pack_to_vector( comment.author_rewards ) );
+            append( fc::raw::pack_to_vector( comment.net_rshares ) );
+            append( fc::raw::pack_to_vector( comment.last_payout ) );
+         }
+
+         append( fc::raw::pack_to_vector( db->get_dynamic_global_properties() ) );
+         append( fc::raw::pack_to_vector( db->get< reward_fund_object, by_name >( freezone_POST_REWARD_FUND_NAME ) ) );
+         return state;
+      };
+
+      generate_blocks( db->get_comment( authors.front(), string( "mypost" ) ).cashout_time - freezone_BLOCK_INTERVAL, true );
+      BOOST_REQUIRE( db->get_comment( authors.front(), string( "mypost" ) ).last_payout == fc::time_point_sec() );
+
+      BOOST_TEST_MESSAGE( "--- Paying out on the write thread" );
+      db->set_comment_payout_threads( 0 );
+      generate_block();
+
+      for( const auto& author : authors )
+         BOOST_REQUIRE( db->get_comment( author, string( "mypost" ) ).last_payout == db->head_block_time() );
+
+      auto serial_block_id = db->head_block_id();
+      auto serial_state = packed_state();
+
+      BOOST_TEST_MESSAGE( "--- Replaying the payout block with payouts computed by several threads" );
+      db->pop_block();
+      db->clear_pending();
+      db->set_comment_payout_threads( 4 );
+      generate_block();
+
+      BOOST_REQUIRE( db->head_block_id() == serial_block_id );
+      BOOST_REQUIRE( packed_state() == serial_state );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( expiration_agenda )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "Testing: expiration_agenda" );
+
+      ACTORS( (alice) )
+      generate_block();
+
+      fund( "alice", ASSET( "10.000 TESTS" ) );
+
+      transfer_to_savings_operation save;
+      save.from = "alice";
+      save.to = "alice";
+      save.amount = ASSET( "10.000 TESTS" );
+
+      transfer_from_savings_operation withdraw;
+      withdraw.from = "alice";
+      withdraw.to = "alice";
+      withdraw.request_id = 1;
+      withdraw.amount = ASSET( "3.000 TESTS" );
+
+      signed_transaction tx;
+      tx.operations.push_back( save );
+      tx.operations.push_back( withdraw );
+      tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+      sign( tx, alice_private_key );
+      db->push_transaction( tx, 0 );
+      generate_block();
+
+      BOOST_TEST_MESSAGE( "--- Savings withdraws are scheduled when they are requested" );
+      auto complete = db->get_savings_withdraw( "alice", 1 ).complete;
+      BOOST_REQUIRE( db->get_expiration_agenda().next_due[ matured_savings_withdraws ] == complete );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Nothing is processed before the withdraw is due" );
+      generate_blocks( complete - freezone_BLOCK_INTERVAL, true );
+      BOOST_REQUIRE( db->head_block_time() < complete );
+      BOOST_REQUIRE( db->get_expiration_counts()[ matured_savings_withdraws ] == 0 );
+      BOOST_REQUIRE( db->find_savings_withdraw( "alice", 1 ) != nullptr );
+
+      BOOST_TEST_MESSAGE( "--- The withdraw is processed and counted in the block it is due" );
+      generate_block();
+      BOOST_REQUIRE( db->head_block_time() >= complete );
+      BOOST_REQUIRE( db->get_expiration_counts()[ matured_savings_withdraws ] == 1 );
+      BOOST_REQUIRE( db->find_savings_withdraw( "alice", 1 ) == nullptr );
+      BOOST_REQUIRE( db->get_expiration_agenda().next_due[ matured_savings_withdraws ] == fc::time_point_sec::maximum() );
+
+      generate_block();
+      BOOST_REQUIRE( db->get_expiration_counts()[ matured_savings_withdraws ] == 0 );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
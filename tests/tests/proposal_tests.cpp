@@ -2674,6 +2674,75 @@ BOOST_AUTO_TEST_CASE( proposals_removing_with_threshold_02 )
    FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( proposal_running_votes )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "Testing: running votes of proposals follow votes, vesting and proxies" );
+
+      create_proposal_data cpd( db->head_block_time() );
+      ACTORS( (alice)(bob)(carol) )
+      generate_block();
+      FUND( cpd.creator, ASSET( "80.000 TBD" ) );
+      vest( freezone_INIT_MINER_NAME, "bob", ASSET( "10.000 TESTS" ) );
+      vest( freezone_INIT_MINER_NAME, "carol", ASSET( "20.000 TESTS" ) );
+      generate_block();
+
+      int64_t proposal_1 = create_proposal( cpd.creator, cpd.receiver, cpd.start_date, cpd.end_date, cpd.daily_pay, alice_private_key );
+      BOOST_REQUIRE( proposal_1 >= 0 );
+
+      auto running_votes = [&]() { return find_proposal( proposal_1 )->running_votes; };
+      auto weight = [&]( const std::string& name ) { return uint64_t( db->get_account( name ).witness_vote_weight().value ); };
+
+      auto set_proxy = [&]( const std::string& account, const std::string& proxy, const fc::ecc::private_key& key )
+      {
+         account_witness_proxy_operation op;
+         op.account = account;
+         op.proxy = proxy;
+
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         tx.set_expiration( db->head_block_time() + freezone_MAX_TIME_UNTIL_EXPIRATION );
+         sign( tx, key );
+         db->push_transaction( tx, 0 );
+      };
+
+      BOOST_TEST_MESSAGE( "--- Approving adds the governance vesting of the voter" );
+      vote_proposal( "bob", { proposal_1 }, true, bob_private_key );
+      vote_proposal( "carol", { proposal_1 }, true, carol_private_key );
+      BOOST_REQUIRE_EQUAL( running_votes(), weight( "bob" ) + weight( "carol" ) );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Vesting changes are added to approved proposals" );
+      vest( freezone_INIT_MINER_NAME, "bob", ASSET( "5.000 TESTS" ) );
+      BOOST_REQUIRE_EQUAL( running_votes(), weight( "bob" ) + weight( "carol" ) );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Setting a proxy moves the voting power of the account to its proxy" );
+      set_proxy( "carol", "bob", carol_private_key );
+      BOOST_REQUIRE_EQUAL( weight( "bob" ), uint64_t( db->get_account( "bob" ).vesting_shares.amount.value + db->get_account( "carol" ).vesting_shares.amount.value ) );
+      BOOST_REQUIRE_EQUAL( running_votes(), weight( "bob" ) );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Clearing the proxy counts the votes of the account again" );
+      set_proxy( "carol", "", carol_private_key );
+      BOOST_REQUIRE_EQUAL( running_votes(), weight( "bob" ) + weight( "carol" ) );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Removing a vote subtracts the governance vesting of the voter" );
+      vote_proposal( "bob", { proposal_1 }, false, bob_private_key );
+      BOOST_REQUIRE_EQUAL( running_votes(), weight( "carol" ) );
+      validate_database();
+
+      BOOST_TEST_MESSAGE( "--- Maintenance copies the running votes to the total votes" );
+      BOOST_REQUIRE_EQUAL( find_proposal( proposal_1 )->total_votes, 0u );
+      generate_blocks( cpd.start_date + fc::seconds( freezone_PROPOSAL_MAINTENANCE_PERIOD ) );
+      BOOST_REQUIRE_EQUAL( find_proposal( proposal_1 )->total_votes, weight( "carol" ) );
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -35,6 +35,7 @@
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/elliptic.hpp>
 #include <fc/reflect/variant.hpp>
+#include <fc/variant_arena.hpp>
 
 #include "../db_fixture/database_fixture.hpp"
 
@@ -710,6 +711,102 @@ BOOST_AUTO_TEST_CASE( unpack_clear_test )
    FC_LOG_AND_RETHROW();
 }
 
+BOOST_AUTO_TEST_CASE( raw_bulk_pack_test )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "Testing account names pack the same as strings" );
+      for( std::string name : { std::string(), std::string( "alice" ), std::string( "sixteen-chars-ok" ) } )
+      {
+         account_name_type account = name;
+         BOOST_REQUIRE( fc::raw::pack_to_vector( account ) == fc::raw::pack_to_vector( name ) );
+         BOOST_REQUIRE( fc::raw::unpack_from_vector< account_name_type >( fc::raw::pack_to_vector( name ) ) == account );
+      }
+
+      std::string long_name = "longer-than-sixteen-chars";
+      BOOST_REQUIRE( fc::raw::unpack_from_vector< account_name_type >( fc::raw::pack_to_vector( long_name ) ) == account_name_type( long_name ) );
+
+      BOOST_TEST_MESSAGE( "Testing vectors of trivially packable types" );
+      std::vector< uint32_t > numbers = { 1, 2, 0xFFFFFFFF };
+      auto packed_numbers = fc::raw::pack_to_vector( numbers );
+      BOOST_REQUIRE_EQUAL( packed_numbers.size(), 1u + 3 * sizeof( uint32_t ) );
+      BOOST_REQUIRE_EQUAL( fc::raw::pack_size( numbers ), packed_numbers.size() );
+      BOOST_REQUIRE( fc::raw::unpack_from_vector< std::vector< uint32_t > >( packed_numbers ) == numbers );
+
+      std::vector< fc::sha256 > digests = { fc::sha256::hash( "a" ), fc::sha256::hash( "b" ) };
+      auto packed_digests = fc::raw::pack_to_vector( digests );
+      BOOST_REQUIRE_EQUAL( packed_digests.size(), 1u + 2 * sizeof( fc::sha256 ) );
+      BOOST_REQUIRE( fc::raw::unpack_from_vector< std::vector< fc::sha256 > >( packed_digests ) == digests );
+
+      std::vector< signature_type > signatures( 2 );
+      signatures[1].data[0] = 1;
+      BOOST_REQUIRE( fc::raw::unpack_from_vector< std::vector< signature_type > >( fc::raw::pack_to_vector( signatures ) ) == signatures );
+
+      BOOST_TEST_MESSAGE( "Testing bools are still validated" );
+      std::vector< char > bad_bool = { 1, 2 };
+      freezone_REQUIRE_THROW( fc::raw::unpack_from_vector< std::vector< bool > >( bad_bool ), fc::exception );
+   }
+   FC_LOG_AND_RETHROW();
+}
+
+BOOST_AUTO_TEST_CASE( variant_arena_test )
+{
+   try
+   {
+      signed_transaction trx;
+      transfer_operation op;
+      op.from = "alice";
+      op.to = "bob";
+      op.amount = asset( 100, freezone_SYMBOL );
+      op.memo = std::string( 100, 'm' );
+      trx.operations.push_back( op );
+
+      std::string expected = fc::json::to_string( fc::variant( trx ) );
+
+      BOOST_TEST_MESSAGE( "Testing variants built in an arena outlive it" );
+      fc::variant escaped;
+      fc::mutable_variant_object copied;
+      {
+         fc::variant_arena arena;
+         BOOST_REQUIRE( fc::variant_arena::active() );
+
+         {
+            fc::variant_arena nested;
+         }
+         BOOST_REQUIRE( fc::variant_arena::active() );
+
+         fc::variant v( trx );
+         BOOST_REQUIRE_EQUAL( fc::json::to_string( v ), expected );
+
+         escaped = v;
+         copied = v.get_object();
+         copied( "extra", "value" );
+      }
+      BOOST_REQUIRE( !fc::variant_arena::active() );
+
+      BOOST_REQUIRE_EQUAL( fc::json::to_string( escaped ), expected );
+      BOOST_REQUIRE_EQUAL( escaped.as< signed_transaction >().operations[0].get< transfer_operation >().memo, op.memo );
+      BOOST_REQUIRE_EQUAL( copied[ "extra" ].as_string(), "value" );
+
+      BOOST_TEST_MESSAGE( "Testing empty objects are not shared by assignment" );
+      fc::variant_object a;
+      fc::variant_object b;
+      fc::mutable_variant_object m( "key", 1 );
+      b = m;
+      BOOST_REQUIRE_EQUAL( a.size(), 0u );
+      BOOST_REQUIRE_EQUAL( b.size(), 1u );
+
+      BOOST_TEST_MESSAGE( "Testing converting a moved-from mutable object" );
+      fc::mutable_variant_object moved( std::move( m ) );
+      BOOST_REQUIRE_EQUAL( moved.size(), 1u );
+      fc::variant_object from_moved( std::move( m ) );
+      BOOST_REQUIRE_EQUAL( from_moved.size(), 0u );
+      b = std::move( m );
+      BOOST_REQUIRE_EQUAL( b.size(), 0u );
+   }
+   FC_LOG_AND_RETHROW();
+}
+
 BOOST_AUTO_TEST_CASE( unpack_recursion_test )
 {
    try